@@ -4,8 +4,10 @@
 #include "aderite/Aderite.hpp"
 #include "aderite/asset/AssetManager.hpp"
 #include "aderite/io/FileHandler.hpp"
+#include "aderite/io/Loader.hpp"
 #include "aderite/io/Serializer.hpp"
 #include "aderite/reflection/RuntimeTypes.hpp"
+#include "aderite/rendering/MaterialBuffer.hpp"
 #include "aderite/utility/Log.hpp"
 
 #include "aderiteeditor/asset/property/Property.hpp"
@@ -175,9 +177,6 @@ void EditorMaterialType::recalculate() {
 }
 
 void EditorMaterialType::compile() {
-    std::uint64_t vertexDataSize = 0;
-    std::uint64_t fragmentDataSize = 0;
-
     // Add sampler names
     std::vector<std::string> samplerNames;
     for (const Sampler* sampler : m_samplers) {
@@ -188,11 +187,17 @@ void EditorMaterialType::compile() {
     // Recalculate offsets
     this->recalculate();
 
+    // Small types read their properties from the renderer material buffer so their materials can share draws
+    this->setMaterialBuffer(this->getSize() <= rendering::MaterialBuffer::c_SlotWidth &&
+                            m_samplers.size() < rendering::MaterialBuffer::c_Stage);
+
     const std::filesystem::path projRoot = editor::State::Project->getRootDir();
     const std::filesystem::path headerFile = projRoot / ("Data/material_" + std::to_string(this->getHandle()) + ".sh");
     const std::filesystem::path varyingFile = projRoot / ("Data/varying_" + std::to_string(this->getHandle()) + ".def.sc");
     const std::filesystem::path fragmentFile = projRoot / ("Data/fragment_" + std::to_string(this->getHandle()) + ".fs");
     const std::filesystem::path vertexFile = projRoot / ("Data/vertex_" + std::to_string(this->getHandle()) + ".vs");
+    const std::filesystem::path depthFragmentFile = projRoot / ("Data/depth_fragment_" + std::to_string(this->getHandle()) + ".fs");
+    const std::filesystem::path depthVertexFile = projRoot / ("Data/depth_vertex_" + std::to_string(this->getHandle()) + ".vs");
 
     {
         // Open file streams
@@ -200,43 +205,64 @@ void EditorMaterialType::compile() {
         std::ofstream of2(varyingFile);
         std::ofstream of3(fragmentFile);
         std::ofstream of4(vertexFile);
+        std::ofstream of5(depthFragmentFile);
+        std::ofstream of6(depthVertexFile);
 
         // Generate sources
         generateMaterialHeader(of1);
         generateVarying(of2);
         generateFragment(of3);
         generateVertex(of4);
+        generateDepthFragment(of5);
+        generateDepthVertex(of6);
     }
 
     // Compile into binaries
     compiler::ShaderCompiler sc(vertexFile, fragmentFile, varyingFile);
+    compiler::ShaderCompiler depthSc(depthVertexFile, depthFragmentFile, varyingFile);
 
-    // TODO: Handle result
-    sc.compile();
-
-    // Merge the binaries into a loadable chunk
-    io::DataChunk chunk = ::aderite::Engine::getFileHandler()->openLoadable(this->getHandle());
-
-    // Read all contents
-    std::ifstream inVertex(sc.getVertexBinPath(), std::ios::binary);
-    std::ifstream inFragment(sc.getFragmentBinPath(), std::ios::binary);
+    if (!sc.compile()) {
+        LOG_ERROR("Failed to compile shaders of material type {0}", this->getName());
+        return;
+    }
 
-    // Get sizes
-    vertexDataSize = inVertex.seekg(0, std::ios::end).tellg();
-    fragmentDataSize = inFragment.seekg(0, std::ios::end).tellg();
+    // Types without a depth variant are drawn without the depth prepass
+    bool hasDepth = !this->isTransparent();
+    if (hasDepth && !depthSc.compile()) {
+        LOG_ERROR("Failed to compile depth shaders of material type {0}, it is drawn without a depth prepass", this->getName());
+        hasDepth = false;
+    }
 
-    // Reset pointer
-    inVertex.seekg(0, std::ios::beg);
-    inFragment.seekg(0, std::ios::beg);
+    // Merge the binaries into a loadable chunk, every binary is prefixed with its size
+    io::DataChunk chunk = ::aderite::Engine::getFileHandler()->openLoadable(this->getHandle());
+    chunk.Data.resize(sizeof(std::uint64_t));
+    std::memcpy(chunk.Data.data(), &io::Loader::c_ShaderVariantsMagic, sizeof(std::uint64_t));
+
+    const auto append = [&chunk](const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::uint64_t size = 0;
+        if (in) {
+            size = in.seekg(0, std::ios::end).tellg();
+            in.seekg(0, std::ios::beg);
+        }
 
-    chunk.Data.resize(vertexDataSize + fragmentDataSize + sizeof(std::uint64_t));
+        const size_t offset = chunk.Data.size();
+        chunk.Data.resize(offset + sizeof(std::uint64_t) + size);
+        std::memcpy(chunk.Data.data() + offset, &size, sizeof(std::uint64_t));
+        in.read(reinterpret_cast<char*>(chunk.Data.data() + offset + sizeof(std::uint64_t)), size);
+    };
 
-    // Write the vertex length
-    std::memcpy(chunk.Data.data(), &vertexDataSize, sizeof(std::uint64_t));
+    append(sc.getVertexBinPath());
+    append(sc.getFragmentBinPath());
 
-    // Write shader contents
-    inVertex.read(reinterpret_cast<char*>(chunk.Data.data() + sizeof(std::uint64_t)), vertexDataSize);
-    inFragment.read(reinterpret_cast<char*>(chunk.Data.data() + vertexDataSize + sizeof(std::uint64_t)), fragmentDataSize);
+    // Empty binaries are written in place of a missing depth variant
+    if (hasDepth) {
+        append(depthSc.getVertexBinPath());
+        append(depthSc.getFragmentBinPath());
+    } else {
+        append({});
+        append({});
+    }
 
     ::aderite::Engine::getFileHandler()->commit(chunk);
 
@@ -306,7 +332,10 @@ void EditorMaterialType::generateMaterialHeader(std::ostream& os) {
     std::stringstream samplers;
 
     unsigned int arraySize = this->getSize();
-    if (arraySize > 0) {
+    if (this->usesMaterialBuffer()) {
+        // Row of the material in the material buffer, the row index is passed from the instance data
+        properties << "SAMPLER2D(s_materialBuffer, " << static_cast<int>(rendering::MaterialBuffer::c_Stage) << ");\n\n";
+    } else if (arraySize > 0) {
         properties << "uniform vec4 mf_mat_buffer_" << this->getName() << "[" << arraySize << "];\n\n";
     }
 
@@ -385,8 +414,12 @@ void EditorMaterialType::generateMaterialHeader(std::ostream& os) {
         case asset::PropertyType::VEC2:
         case asset::PropertyType::VEC3:
         case asset::PropertyType::VEC4: {
-            properties << "#define mf_" << this->getName() << "_" << prop->getName() << " mf_mat_buffer_" << this->getName() << "["
-                       << arrayIdx << "]." << access << "\n";
+            properties << "#define mf_" << this->getName() << "_" << prop->getName();
+            if (this->usesMaterialBuffer()) {
+                properties << " texelFetch(s_materialBuffer, ivec2(" << arrayIdx << ", int(v_material)), 0)." << access << "\n";
+            } else {
+                properties << " mf_mat_buffer_" << this->getName() << "[" << arrayIdx << "]." << access << "\n";
+            }
             break;
         }
         default:
@@ -418,6 +451,7 @@ void EditorMaterialType::generateVarying(std::ostream& os) {
     // Outputs
     os << "vec3 v_normal    : NORMAL    = vec3(0.0, 0.0, 1.0);\n";
     os << "vec2 v_texcoord  : TEXCOORD0 = vec2(0.0, 0.0);\n";
+    os << "flat float v_material : TEXCOORD1 = 0.0;\n";
 
     os << "\n";
 
@@ -450,7 +484,7 @@ void EditorMaterialType::generateVertex(std::ostream& os) {
 
     // Inputs, outputs
     os << "$input a_position, a_normal, a_texcoord0, i_data0, i_data1, i_data2, i_data3\n";
-    os << "$output v_normal, v_texcoord\n\n";
+    os << "$output v_normal, v_texcoord, v_material\n\n";
 
     os << "/*\n";
     os << " *"
@@ -472,21 +506,67 @@ void EditorMaterialType::generateVertex(std::ostream& os) {
     // Main entry
     os << "void main()\n{\n\t";
 
-    // Model matrix from instance data
-    os << "mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);\n\t";
-    os << "vec4 worldPos = mul(model, vec4(a_position, 1.0));\n\t";
-
-    // gl_Position
-    os << "gl_Position = mul(u_viewProj, worldPos);\n\t";
+    this->generatePosition(os);
 
     // Texcoord and normals
     os << "v_texcoord = a_texcoord0;\n\t";
-    os << "v_normal = a_normal;\n";
+    os << "v_normal = a_normal;\n\t";
+
+    // Material buffer row
+    os << "v_material = i_data0.w;\n";
 
     // Close main
     os << "}\n";
 }
 
+void EditorMaterialType::generateDepthVertex(std::ostream& os) {
+    LOG_TRACE("Generating depth vertex shader");
+
+    // Header comment
+    auto t = std::time(nullptr);
+    auto tm = *std::localtime(&t);
+
+    // Only the position and the instance data
+    os << "$input a_position, i_data0, i_data1, i_data2, i_data3\n\n";
+
+    os << "/*\n";
+    os << " *"
+       << " DON'T CHANGE DIRECTLY"
+       << "\n";
+    os << " *"
+       << " This is a depth prepass vertex shader file generated by aderite for material " << this->getName() << "\n";
+    os << " *"
+       << " Generated at " << std::put_time(&tm, "%Y-%m-%d %H.%M.%S") << "\n";
+    os << " */"
+       << "\n\n";
+
+    // Includes
+    os << "#include \"bgfx_shader.sh\"\n";
+    os << "\n";
+
+    // Main entry
+    os << "void main()\n{\n\t";
+    this->generatePosition(os);
+    os << "}\n";
+}
+
+void EditorMaterialType::generateDepthFragment(std::ostream& os) {
+    LOG_TRACE("Generating depth fragment shader");
+
+    // Depth is written by the rasterizer, nothing is shaded
+    os << "#include \"bgfx_shader.sh\"\n\n";
+    os << "void main()\n{\n}\n";
+}
+
+void EditorMaterialType::generatePosition(std::ostream& os) {
+    // Model matrix from instance data, the unused projective part of the first column holds the material buffer row
+    os << "mat4 model = mtxFromCols(vec4(i_data0.xyz, 0.0), i_data1, i_data2, i_data3);\n\t";
+    os << "vec4 worldPos = mul(model, vec4(a_position, 1.0));\n\t";
+
+    // gl_Position
+    os << "gl_Position = mul(u_viewProj, worldPos);\n\t";
+}
+
 void EditorMaterialType::addIONodes() {
     // Don't have multiple IO nodes
     this->clear();
@@ -107,6 +107,25 @@ private:
      */
     void generateVertex(std::ostream& os);
 
+    /**
+     * @brief Generates the position only vertex shader of the depth prepass and outputs it into the specified stream
+     * @param os Stream to output to
+     */
+    void generateDepthVertex(std::ostream& os);
+
+    /**
+     * @brief Generates the empty fragment shader of the depth prepass and outputs it into the specified stream
+     * @param os Stream to output to
+     */
+    void generateDepthFragment(std::ostream& os);
+
+    /**
+     * @brief Generates the clip space position calculation shared by the vertex shaders, the depth prepass only passes if
+     * both variants compute exactly the same depth
+     * @param os Stream to output to
+     */
+    void generatePosition(std::ostream& os);
+
     /**
      * @brief Adds material input, output nodes to the graph
      */
@@ -44,9 +44,16 @@ bool ShaderCompiler::compile() const {
 
     // Compile
     LOG_TRACE("Running {0}", vCommand.str().c_str());
-    system(vCommand.str().c_str());
+    if (system(vCommand.str().c_str()) != 0) {
+        LOG_ERROR("Failed to compile vertex shader {0}", m_vertex.string());
+        return false;
+    }
+
     LOG_TRACE("Running {0}", fCommand.str().c_str());
-    system(fCommand.str().c_str());
+    if (system(fCommand.str().c_str()) != 0) {
+        LOG_ERROR("Failed to compile fragment shader {0}", m_fragment.string());
+        return false;
+    }
 
     return true;
 }
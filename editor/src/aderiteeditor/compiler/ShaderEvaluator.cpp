@@ -79,7 +79,7 @@ ShaderEvaluator::ShaderType ShaderEvaluator::getType() const {
 
 void ShaderEvaluator::writeInputsOutputs(std::ostream& of) {
     // Inputs, outputs
-    of << "$input v_normal, v_texcoord\n\n";
+    of << "$input v_normal, v_texcoord, v_material\n\n";
 }
 
 void ShaderEvaluator::writeGenerationComment(std::ostream& of) {
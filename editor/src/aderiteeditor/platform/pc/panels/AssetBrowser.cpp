@@ -1,6 +1,7 @@
 #include "AssetBrowser.hpp"
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <map>
 
 #include <GLFW/glfw3.h>
@@ -14,8 +15,10 @@
 #include "aderite/asset/PrefabAsset.hpp"
 #include "aderite/asset/TextureAsset.hpp"
 #include "aderite/io/FileHandler.hpp"
+#include "aderite/io/MeshCooker.hpp"
 #include "aderite/io/SerializableObject.hpp"
 #include "aderite/io/Serializer.hpp"
+#include "aderite/io/TextureCooker.hpp"
 #include "aderite/scene/GameObject.hpp"
 #include "aderite/scene/Scene.hpp"
 #include "aderite/scene/SceneManager.hpp"
@@ -502,13 +505,45 @@ void AssetBrowser::importAsset(const std::filesystem::path& path, reflection::Ru
     }
     }
 
-    if (asset != nullptr) {
-        // Add asset
+    if (asset == nullptr) {
+        return;
+    }
+
+    if (type == reflection::RuntimeTypes::MESH || type == reflection::RuntimeTypes::TEXTURE) {
+        // Meshes and textures are cooked once here so that loading doesn't have to go through the importers
+        std::ifstream in(path, std::ios::binary);
+        const std::vector<unsigned char> source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const std::string hint = path.extension().string().empty() ? "" : path.extension().string().substr(1);
+
+        std::vector<unsigned char> cooked;
+        std::string error;
+        bool success = false;
+        if (type == reflection::RuntimeTypes::MESH) {
+            io::MeshCooker cooker;
+            success = cooker.cook(source.data(), source.size(), hint, cooked, error);
+        } else {
+            success = io::TextureCooker::cook(source.data(), source.size(), true, cooked, error);
+        }
+
+        if (!success) {
+            LOG_ERROR("[Editor] Failed to import {0}, reason: {1}", path.string(), error);
+            delete asset;
+            return;
+        }
+
         this->addAsset(asset);
 
-        // Now copy the source as a loadable id
-        ::aderite::Engine::getFileHandler()->writePhysicalFile(asset->getHandle(), path);
+        io::DataChunk chunk = ::aderite::Engine::getFileHandler()->openLoadable(asset->getHandle());
+        chunk.Data = std::move(cooked);
+        ::aderite::Engine::getFileHandler()->commit(chunk);
+        return;
     }
+
+    // Add asset
+    this->addAsset(asset);
+
+    // Now copy the source as a loadable id
+    ::aderite::Engine::getFileHandler()->writePhysicalFile(asset->getHandle(), path);
 }
 
 void AssetBrowser::addAsset(io::SerializableAsset* asset) {
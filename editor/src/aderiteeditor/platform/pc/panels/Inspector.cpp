@@ -15,6 +15,7 @@
 #include "aderite/audio/AudioSource.hpp"
 #include "aderite/io/SerializableObject.hpp"
 #include "aderite/physics/PhysXActor.hpp"
+#include "aderite/physics/PhysicsScene.hpp"
 #include "aderite/physics/geometry/BoxGeometry.hpp"
 #include "aderite/physics/geometry/Geometry.hpp"
 #include "aderite/reflection/RuntimeTypes.hpp"
@@ -210,6 +211,16 @@ void Inspector::renderRenderable(rendering::RenderableData& renderable) {
                 renderable.setMaterial(material);
             }
 
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("Static");
+
+            ImGui::TableSetColumnIndex(1);
+            bool isStatic = renderable.isStatic();
+            if (ImGui::Checkbox("##renderableStatic", &isStatic)) {
+                renderable.setStatic(isStatic);
+            }
+
             ImGui::EndTable();
         }
     }
@@ -281,6 +292,12 @@ void Inspector::renderColliders(physics::PhysXActor* actor) {
                     boxGeom->setTrigger(isTrigger);
                 }
 
+                int layer = boxGeom->getLayer();
+                const int maxLayer = physics::PhysicsScene::c_LayerCount - 1;
+                if (ImGui::DragInt(("Layer##" + std::to_string(idx)).c_str(), &layer, 0.1f, 0, maxLayer, "%d", ImGuiSliderFlags_AlwaysClamp)) {
+                    boxGeom->setLayer(static_cast<uint8_t>(layer));
+                }
+
                 glm::vec3 size = boxGeom->getSize();
                 if (utility::DrawVec3Control(std::to_string(idx), "Size", size)) {
                     boxGeom->setSize(size);
@@ -341,6 +358,15 @@ void Inspector::renderCamera(scene::Camera* camera) {
                 settings.setFarClip(farClip);
             }
 
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::Text("Depth prepass");
+            ImGui::TableSetColumnIndex(1);
+            bool depthPrepass = settings.hasDepthPrepass();
+            if (ImGui::Checkbox("##depthPrepass", &depthPrepass)) {
+                settings.setDepthPrepass(depthPrepass);
+            }
+
             ImGui::EndTable();
         }
 
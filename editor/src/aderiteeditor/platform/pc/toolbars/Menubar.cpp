@@ -16,6 +16,7 @@
 #include "aderiteeditor/platform/pc/modals/FileDialog.hpp"
 #include "aderiteeditor/shared/IEventSink.hpp"
 #include "aderiteeditor/shared/Project.hpp"
+#include "aderiteeditor/shared/Settings.hpp"
 #include "aderiteeditor/shared/State.hpp"
 
 // TEMPORARY
@@ -98,6 +99,11 @@ void Menubar::render() {
             ImGui::EndMenu();
         }
 
+        if (ImGui::BeginMenu("View")) {
+            ImGui::MenuItem("Depth prepass", nullptr, &Settings::EditorCameraDepthPrepass);
+            ImGui::EndMenu();
+        }
+
         if (ImGui::BeginMenu("Scripting")) {
             if (ImGui::MenuItem("Load game code")) {
                 // Select the code file
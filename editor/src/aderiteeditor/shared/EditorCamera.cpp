@@ -84,6 +84,7 @@ void EditorCamera::update(float delta) {
     cd.ProjectionMatrix = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 1000.0f);
     cd.ViewMatrix =
         glm::inverse(glm::translate(glm::mat4(1.0f), this->calculatePosition()) * glm::toMat4(glm::quat(m_currentEulerRotation)));
+    cd.DepthPrepass = Settings::EditorCameraDepthPrepass;
 
     // Push to the list
     fd.Cameras.push_back(cd);
@@ -7,6 +7,7 @@ float Settings::EditorCameraPanSpeed = 0.01f;
 float Settings::EditorCameraZoomSpeed = 0.6f;
 float Settings::EditorCameraRotationSpeed = 0.8f;
 float Settings::EditorCameraFov = 90.0f;
+bool Settings::EditorCameraDepthPrepass = true;
 
 } // namespace editor
 } // namespace aderite
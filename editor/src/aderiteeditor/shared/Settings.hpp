@@ -29,6 +29,11 @@ public:
      * @brief Field of vision of the editor camera, default 90.0f
      */
     static float EditorCameraFov;
+
+    /**
+     * @brief Whether the editor camera renders a depth prepass before shading, default true
+     */
+    static bool EditorCameraDepthPrepass;
 };
 
 } // namespace editor
@@ -0,0 +1,70 @@
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "aderite/io/BinaryArchive.hpp"
+#include "aderite/io/FileHandler.hpp"
+#include "aderite/io/PackedArchive.hpp"
+#include "aderite/utility/Log.hpp"
+
+/**
+ * @brief Converts YAML serializables and the asset registry to binary archives, other payloads are left as is
+ */
+static bool toBinary(const aderite::io::PackedArchive::TocEntry& entry, std::vector<char>& payload) {
+    using aderite::io::PackedArchive;
+
+    const bool isRegistry = entry.Kind == PackedArchive::EntryKind::RESERVED &&
+                            entry.Handle == aderite::io::FileHandler::Reserved::AssetRegistry;
+    if (entry.Kind != PackedArchive::EntryKind::SERIALIZABLE && !isRegistry) {
+        return true;
+    }
+
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(payload.data());
+    if (aderite::io::BinaryArchive::isBinary(data, payload.size())) {
+        // Already converted
+        return true;
+    }
+
+    std::vector<unsigned char> archive = aderite::io::BinaryArchive::convert(payload.data(), payload.size());
+    payload.assign(archive.begin(), archive.end());
+    return true;
+}
+
+/**
+ * @brief Builds a packed archive from a project root
+ * Usage: aderite_packer [--binary] <project root> [output archive]
+ */
+int main(int argc, char** argv) {
+    aderite::Logger::get()->init();
+
+    bool binary = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--binary") {
+            binary = true;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.empty()) {
+        LOG_ERROR("Usage: aderite_packer [--binary] <project root> [output archive]");
+        return 1;
+    }
+
+    const std::filesystem::path root = positional[0];
+    const std::filesystem::path output = positional.size() > 1 ? std::filesystem::path(positional[1])
+                                                               : root / aderite::io::PackedArchive::c_DefaultName;
+
+    if (!std::filesystem::exists(root / "Asset") || !std::filesystem::exists(root / "Data")) {
+        LOG_ERROR("{0} is not a project root, Asset/ and Data/ directories are required", root.string());
+        return 1;
+    }
+
+    if (!aderite::io::PackedArchive::pack(root, output, binary ? toBinary : aderite::io::PackedArchive::PayloadTransform())) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -14,6 +14,7 @@
 #include "aderite/scene/Scene.hpp"
 #include "aderite/scene/SceneManager.hpp"
 #include "aderite/scripting/ScriptManager.hpp"
+#include "aderite/threading/JobSystem.hpp"
 #include "aderite/utility/Log.hpp"
 #include "aderite/utility/LogExtensions.hpp"
 #include "aderite/window/WindowManager.hpp"
@@ -51,13 +52,15 @@ bool Engine::init(InitOptions options) {
     // File handle
     m_fileHandler = new io::FileHandler();
 
+    // Job system
+    m_jobSystem = options.WorkerThreads > 0 ? new threading::JobSystem(options.WorkerThreads) : new threading::JobSystem();
+
     // Loader pool
-    // TODO: Configurable thread count
-    m_loaderPool = new io::LoaderPool(2);
+    m_loaderPool = new io::LoaderPool(m_jobSystem);
 
     // Asset manager
     m_assetManager = new asset::AssetManager();
-    if (!m_assetManager->init()) {
+    if (!m_assetManager->init(options.MeshResidencyBudget, options.TextureResidencyBudget)) {
         LOG_ERROR("[Engine] Aborting aderite initialization");
         return false;
     }
@@ -99,7 +102,7 @@ bool Engine::init(InitOptions options) {
 
     // Renderer
     m_renderer = new rendering::Renderer();
-    if (!m_renderer->init()) {
+    if (!m_renderer->init(options.NoopRenderer)) {
         LOG_ERROR("[Engine] Aborting aderite initialization");
         return false;
     }
@@ -160,6 +163,7 @@ void Engine::shutdown() {
     delete m_inputManager;
     delete m_serializer;
     delete m_loaderPool;
+    delete m_jobSystem;
     delete m_fileHandler;
     delete m_reflector;
     delete m_scriptManager;
@@ -11,6 +11,7 @@
 #include "aderite/rendering/Forward.hpp"
 #include "aderite/scene/Forward.hpp"
 #include "aderite/scripting/Forward.hpp"
+#include "aderite/threading/Forward.hpp"
 #include "aderite/utility/Macros.hpp"
 #include "aderite/window/Forward.hpp"
 
@@ -33,7 +34,18 @@ public:
     /**
      * @brief Engine init options
      */
-    struct InitOptions {};
+    struct InitOptions {
+        // Renders with the bgfx Noop backend, used by benchmarks that only measure CPU work
+        bool NoopRenderer = false;
+
+        // Worker threads of the job system shared by asset loading, rendering and physics, 0 uses one for every hardware
+        // thread except the calling one
+        size_t WorkerThreads = 0;
+
+        // Bytes that zero reference assets of a type can keep resident before they are evicted, 0 frees them immediately
+        size_t MeshResidencyBudget = 64 * 1024 * 1024;
+        size_t TextureResidencyBudget = 256 * 1024 * 1024;
+    };
 
     /**
      * @brief Enum representing the current engine state
@@ -123,6 +135,7 @@ private:
     ADERITE_SYSTEM_PTR(getFileHandler, io::FileHandler, m_fileHandler)
     ADERITE_SYSTEM_PTR(getSerializer, io::Serializer, m_serializer)
     ADERITE_SYSTEM_PTR(getReflector, reflection::Reflector, m_reflector)
+    ADERITE_SYSTEM_PTR(getJobSystem, threading::JobSystem, m_jobSystem)
     ADERITE_SYSTEM_PTR(getLoaderPool, io::LoaderPool, m_loaderPool)
     ADERITE_SYSTEM_PTR(getPhysicsController, physics::PhysicsController, m_physicsController)
     ADERITE_SYSTEM_PTR(getAudioController, audio::AudioController, m_audioController)
@@ -1,10 +1,14 @@
 #include "AssetManager.hpp"
 
+#include <algorithm>
+
 #include "aderite/Aderite.hpp"
 #include "aderite/io/FileHandler.hpp"
 #include "aderite/io/LoaderPool.hpp"
 #include "aderite/io/SerializableObject.hpp"
 #include "aderite/io/Serializer.hpp"
+#include "aderite/reflection/RuntimeTypes.hpp"
+#include "aderite/threading/JobSystem.hpp"
 #include "aderite/utility/Log.hpp"
 #include "aderite/utility/LogExtensions.hpp"
 #include "aderite/utility/Macros.hpp"
@@ -12,9 +16,13 @@
 namespace aderite {
 namespace asset {
 
-bool AssetManager::init() {
+bool AssetManager::init(size_t meshBudget, size_t textureBudget) {
     ADERITE_LOG_BLOCK;
     LOG_DEBUG("[Asset] Initializing asset manager, current version");
+
+    this->setResidencyBudget(static_cast<reflection::Type>(reflection::RuntimeTypes::MESH), meshBudget);
+    this->setResidencyBudget(static_cast<reflection::Type>(reflection::RuntimeTypes::TEXTURE), textureBudget);
+
     LOG_INFO("[Asset] Asset manager initialized");
     return true;
 }
@@ -23,7 +31,18 @@ void AssetManager::shutdown() {
     ADERITE_LOG_BLOCK;
     LOG_TRACE("[Asset] Shutting down asset manager");
 
+    // Outstanding parse jobs use the file handler and serializer
+    for (io::SerializableHandle handle : m_pending) {
+        if (m_registry[handle].Request != nullptr) {
+            ::aderite::Engine::getJobSystem()->wait(m_registry[handle].Request->Job);
+        }
+    }
+
     // Free memory
+    for (auto& pool : m_residency) {
+        this->trim(pool.second, 0);
+    }
+
     // 3 Update cycles should free any data during shutdown
 
     // 1 update will delete 0 outstanding reference
@@ -34,7 +53,7 @@ void AssetManager::shutdown() {
     this->update();
 
     // Verify
-    for (auto& obj : m_registry) {
+    for (const AssetRegistryEntry& obj : m_registry) {
         if (obj.Asset != nullptr) {
             LOG_WARN("[Asset] Asset memory leak for {1}({0}) it has {2} references", obj.Handle, obj.Asset->getName(), obj.Asset->getRefCount());
         }
@@ -43,29 +62,46 @@ void AssetManager::shutdown() {
     // Save registry
     this->saveRegistry();
 
-    LOG_INFO("[Asset] Asset manager shutdown");
+    LOG_INFO("[Asset] Asset manager shutdown, residency cache hits: {0} misses: {1} evictions: {2}", m_residencyStatistics.Hits,
+             m_residencyStatistics.Misses, m_residencyStatistics.Evictions);
 }
 
 void AssetManager::update() {
-    for (auto& entry : m_registry) {
-        if (entry.Asset != nullptr) {
-            // Check references
-            if (entry.Asset->getRefCount() > 0) {
-                // Check if loaded
-                if (entry.Asset->needsLoading()) {
-                    // Load
-                    ::aderite::Engine::getLoaderPool()->enqueue(entry.Asset);
-                }
-            } else {
-                // No outstanding ref count, can be freed
-                entry.Asset->unload();
-
-                // And delete and flag as no meta
-                delete entry.Asset;
-                entry.Asset = nullptr;
+    // Instance first so that dependencies acquired by the new instances get their loads enqueued this update
+    this->resolveRequests();
+
+    // Swap so that assets marked dirty while processing are handled during the next update
+    m_processing.swap(m_dirty);
+
+    for (io::SerializableHandle handle : m_processing) {
+        AssetRegistryEntry& entry = m_registry[handle];
+        entry.Dirty = false;
+
+        if (!entry.Tracked || entry.Asset == nullptr) {
+            continue;
+        }
+
+        // Check references
+        if (entry.Asset->getRefCount() > 0) {
+            if (entry.Resident) {
+                // Released and acquired again before it was evicted
+                this->removeResident(entry);
+                m_residencyStatistics.Hits++;
+            }
+
+            // Check if loaded
+            if (entry.Asset->needsLoading()) {
+                // Load, keep checking until the asset is loaded
+                ::aderite::Engine::getLoaderPool()->enqueue(entry.Asset);
+                this->markDirty(handle);
             }
+        } else if (!entry.Resident && !this->makeResident(entry)) {
+            // No outstanding ref count and doesn't fit into the residency budget, can be freed
+            this->freeAsset(entry);
         }
     }
+
+    m_processing.clear();
 }
 
 bool AssetManager::loadRegistry() {
@@ -75,19 +111,32 @@ bool AssetManager::loadRegistry() {
 
     // Open loadable
     io::DataChunk chunk = aderite::Engine::getFileHandler()->openReservedLoadable(aderite::io::FileHandler::Reserved::AssetRegistry);
-    YAML::Node data = YAML::Load(reinterpret_cast<const char*>(chunk.Data.data()));
+    YAML::Node data = aderite::Engine::getSerializer()->readDocument(chunk);
 
     // Parse data
     const YAML::Node& registryNode = data["Registry"];
 
     m_nextFreeHandle = registryNode["NextHandle"].as<io::SerializableHandle>();
 
+    m_registry.resize(m_nextFreeHandle);
+    for (io::SerializableHandle handle = 0; handle < m_nextFreeHandle; handle++) {
+        m_registry[handle].Handle = handle;
+    }
+
     for (const YAML::Node& entryNode : registryNode["Entries"]) {
         io::SerializableHandle handle = entryNode["Handle"].as<io::SerializableHandle>();
-        m_registry.push_back({nullptr, handle});
+        ADERITE_DYNAMIC_ASSERT(handle < m_nextFreeHandle, "Registry entry handle is out of range");
+        m_registry[handle].Tracked = true;
+        m_trackedCount++;
+
+        if (entryNode["Dependencies"]) {
+            for (const YAML::Node& dependency : entryNode["Dependencies"]) {
+                m_registry[handle].Dependencies.push_back(dependency.as<io::SerializableHandle>());
+            }
+        }
     }
 
-    LOG_INFO("[Asset] Registry loaded it contains {0} elements", m_registry.size());
+    LOG_INFO("[Asset] Registry loaded it contains {0} elements", m_trackedCount);
     return true;
 }
 
@@ -101,9 +150,16 @@ void AssetManager::saveRegistry() {
     out << YAML::Key << "NextHandle" << YAML::Value << m_nextFreeHandle;
     out << YAML::Key << "Entries" << YAML::BeginSeq;
 
-    for (auto& entry : m_registry) {
+    for (const AssetRegistryEntry& entry : m_registry) {
+        if (!entry.Tracked) {
+            continue;
+        }
+
         out << YAML::BeginMap;
         out << YAML::Key << "Handle" << YAML::Value << entry.Handle;
+        if (!entry.Dependencies.empty()) {
+            out << YAML::Key << "Dependencies" << YAML::Flow << entry.Dependencies;
+        }
         out << YAML::EndMap;
     }
 
@@ -113,8 +169,7 @@ void AssetManager::saveRegistry() {
 
     // Save to file
     io::DataChunk chunk = aderite::Engine::getFileHandler()->openReservedLoadable(aderite::io::FileHandler::Reserved::AssetRegistry);
-    chunk.Data.resize(out.size());
-    std::memcpy(chunk.Data.data(), out.c_str(), chunk.Data.size());
+    aderite::Engine::getSerializer()->writeDocument(out, chunk);
     aderite::Engine::getFileHandler()->commit(chunk);
 
     LOG_INFO("[Asset] Registry saved");
@@ -122,37 +177,243 @@ void AssetManager::saveRegistry() {
 
 bool AssetManager::has(io::SerializableHandle handle) const {
     ADERITE_DYNAMIC_ASSERT(handle != io::SerializableAsset::c_InvalidHandle, "Invalid handle passed to asset manager has method");
-
-    // Try to find the entry
-    auto it = std::find_if(m_registry.begin(), m_registry.end(), [handle](const AssetRegistryEntry& entry) {
-        return entry.Handle == handle;
-    });
-
-    return it != m_registry.end();
+    return handle < m_registry.size() && m_registry[handle].Tracked;
 }
 
 io::SerializableAsset* AssetManager::get(io::SerializableHandle handle) {
     ADERITE_DYNAMIC_ASSERT(handle != io::SerializableAsset::c_InvalidHandle, "Invalid handle passed to asset manager get method");
+    ADERITE_DYNAMIC_ASSERT(this->has(handle), "Tried to query asset that has not been tracked with the asset manager");
+
+    AssetRegistryEntry& entry = m_registry[handle];
+    if (entry.Asset == nullptr) {
+        YAML::Node data;
+        std::shared_ptr<AsyncRequest> request = std::move(entry.Request);
+        if (request != nullptr) {
+            // Prefetched, the worker might still be parsing
+            ::aderite::Engine::getJobSystem()->wait(request->Job);
+            data = request->Document;
+        } else {
+            // Resolve path and load
+            io::DataChunk chunk = aderite::Engine::getFileHandler()->openSerializable(handle);
+            data = aderite::Engine::getSerializer()->readDocument(chunk);
+        }
+
+        // Dependencies are resolved recursively through get, the registry is not resized so entry stays valid
+        entry.Asset = static_cast<io::SerializableAsset*>(aderite::Engine::getSerializer()->parseObject(data));
+        entry.Asset->m_handle = handle;
+        m_residencyStatistics.Misses++;
+
+        // Freed during the next update unless a reference is acquired
+        this->markDirty(handle);
+
+        if (request != nullptr) {
+            for (size_t i = 0; i < request->Acquires; i++) {
+                entry.Asset->acquire();
+            }
+
+            request->Promise.set_value(entry.Asset);
+        }
+    }
+
+    return entry.Asset;
+}
+
+AssetFuture AssetManager::getAsync(io::SerializableHandle handle, io::LoaderPool::Priority priority) {
+    ADERITE_DYNAMIC_ASSERT(handle != io::SerializableAsset::c_InvalidHandle, "Invalid handle passed to asset manager getAsync method");
+    ADERITE_DYNAMIC_ASSERT(this->has(handle), "Tried to query asset that has not been tracked with the asset manager");
+
+    AssetRegistryEntry& entry = m_registry[handle];
+    if (entry.Asset != nullptr) {
+        // Already instanced
+        entry.Asset->acquire();
+        std::promise<io::SerializableAsset*> promise;
+        promise.set_value(entry.Asset);
+        return promise.get_future().share();
+    }
+
+    this->prefetch(handle, priority);
+    entry.Request->Acquires++;
+    return entry.Request->Future;
+}
+
+void AssetManager::save(io::SerializableAsset* object) {
+    if (this->saveAsset(object)) {
+        this->saveRegistry();
+    }
+}
+
+void AssetManager::track(io::SerializableAsset* object) {
+    ADERITE_DYNAMIC_ASSERT(object != nullptr, "Tried to track nullptr");
+    ADERITE_DYNAMIC_ASSERT(m_registry.size() == m_nextFreeHandle, "Registry out of sync with the next free handle");
+
+    const io::SerializableHandle handle = m_nextFreeHandle++;
+    AssetRegistryEntry& entry = m_registry.emplace_back();
+    entry.Asset = object;
+    entry.Handle = handle;
+    entry.Tracked = true;
+    m_trackedCount++;
+
+    object->m_handle = handle;
+    object->getDependencies(entry.Dependencies);
+    this->markDirty(handle);
+
+    // Save registry
+    this->saveRegistry();
+}
+
+void AssetManager::untrack(io::SerializableAsset* asset) {
+    ADERITE_DYNAMIC_ASSERT(asset != nullptr, "Tried to untrack nullptr");
+
+    const io::SerializableHandle handle = asset->getHandle();
+    if (handle >= m_registry.size() || !m_registry[handle].Tracked || m_registry[handle].Asset != asset) {
+        return;
+    }
 
-    // Try to find the entry
-    auto it = std::find_if(m_registry.begin(), m_registry.end(), [handle](const AssetRegistryEntry& entry) {
-        return entry.Handle == handle;
-    });
+    // Leave an empty slot, handles are never reused
+    AssetRegistryEntry& entry = m_registry[handle];
+    ADERITE_DYNAMIC_ASSERT(entry.Asset->getRefCount() == 0, "Tried to untrack asset with outstanding references");
+    if (entry.Resident) {
+        this->removeResident(entry);
+    }
 
-    ADERITE_DYNAMIC_ASSERT(it != m_registry.end(), "Tried to query asset that has not been tracked with the asset manager");
+    entry.Asset = nullptr;
+    entry.Tracked = false;
+    entry.Generation++;
+    m_trackedCount--;
+}
 
-    if (it->Asset == nullptr) {
-        // Resolve path and load
-        io::DataChunk chunk = aderite::Engine::getFileHandler()->openSerializable(handle);
-        YAML::Node data = YAML::Load(reinterpret_cast<const char*>(chunk.Data.data()));
-        it->Asset = static_cast<io::SerializableAsset*>(aderite::Engine::getSerializer()->parseObject(data));
-        it->Asset->m_handle = it->Handle;
+void AssetManager::saveAllTrackedObjects() {
+    LOG_TRACE("[Asset] Saving all objects");
+    bool dependenciesChanged = false;
+    for (const AssetRegistryEntry& obj : m_registry) {
+        if (obj.Asset != nullptr) {
+            dependenciesChanged |= this->saveAsset(obj.Asset);
+        }
     }
 
-    return it->Asset;
+    // Registry is saved once for all changed dependency lists
+    if (dependenciesChanged) {
+        this->saveRegistry();
+    }
+    LOG_INFO("[Asset] All objects saved");
 }
 
-void AssetManager::save(io::SerializableAsset* object) const {
+void AssetManager::markDirty(io::SerializableHandle handle) {
+    if (handle >= m_registry.size()) {
+        return;
+    }
+
+    AssetRegistryEntry& entry = m_registry[handle];
+    if (!entry.Dirty) {
+        entry.Dirty = true;
+        m_dirty.push_back(handle);
+    }
+}
+
+AssetManager::WeakHandle AssetManager::getWeakHandle(const io::SerializableAsset* asset) const {
+    ADERITE_DYNAMIC_ASSERT(asset != nullptr, "Tried to get a weak handle of nullptr");
+    const io::SerializableHandle handle = asset->getHandle();
+    ADERITE_DYNAMIC_ASSERT(handle < m_registry.size() && m_registry[handle].Asset == asset, "Asset is not the tracked instance");
+    return {handle, m_registry[handle].Generation};
+}
+
+bool AssetManager::isStale(const WeakHandle& handle) const {
+    if (handle.Handle >= m_registry.size()) {
+        return true;
+    }
+
+    const AssetRegistryEntry& entry = m_registry[handle.Handle];
+    return !entry.Tracked || entry.Asset == nullptr || entry.Generation != handle.Generation;
+}
+
+size_t AssetManager::getTrackedCount() const {
+    return m_trackedCount;
+}
+
+void AssetManager::setResidencyBudget(reflection::Type type, size_t bytes) {
+    ResidencyPool& pool = m_residency[type];
+    pool.Budget = bytes;
+    this->trim(pool, bytes);
+}
+
+size_t AssetManager::getResidencyBudget(reflection::Type type) const {
+    auto it = m_residency.find(type);
+    return it != m_residency.end() ? it->second.Budget : 0;
+}
+
+size_t AssetManager::getResidentSize(reflection::Type type) const {
+    auto it = m_residency.find(type);
+    return it != m_residency.end() ? it->second.Used : 0;
+}
+
+const AssetManager::ResidencyStatistics& AssetManager::getResidencyStatistics() const {
+    return m_residencyStatistics;
+}
+
+void AssetManager::prefetch(io::SerializableHandle handle, io::LoaderPool::Priority priority) {
+    AssetRegistryEntry& entry = m_registry[handle];
+    if (entry.Asset != nullptr || entry.Request != nullptr) {
+        return;
+    }
+
+    // The job only owns the request, so it stays valid even if the request is consumed before the job runs
+    std::shared_ptr<AsyncRequest> request = std::make_shared<AsyncRequest>();
+    request->Future = request->Promise.get_future().share();
+    request->Job = ::aderite::Engine::getJobSystem()->schedule(
+        [request, handle]() {
+            io::DataChunk chunk = aderite::Engine::getFileHandler()->openSerializable(handle);
+            request->Document = aderite::Engine::getSerializer()->readDocument(chunk);
+        },
+        static_cast<threading::Job::Priority>(priority));
+
+    entry.Request = request;
+    m_pending.push_back(handle);
+
+    // Whole dependency graph is scheduled in one wave
+    for (io::SerializableHandle dependency : entry.Dependencies) {
+        if (this->has(dependency)) {
+            this->prefetch(dependency, priority);
+        }
+    }
+}
+
+bool AssetManager::isPrefetched(io::SerializableHandle handle) const {
+    const AssetRegistryEntry& entry = m_registry[handle];
+    if (entry.Asset != nullptr) {
+        return true;
+    }
+
+    if (entry.Request == nullptr || !entry.Request->Job->isFinished()) {
+        return false;
+    }
+
+    // Asset references form a DAG, so this always terminates
+    for (io::SerializableHandle dependency : entry.Dependencies) {
+        if (this->has(dependency) && !this->isPrefetched(dependency)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void AssetManager::resolveRequests() {
+    for (size_t i = 0; i < m_pending.size(); i++) {
+        const io::SerializableHandle handle = m_pending[i];
+        if (m_registry[handle].Request != nullptr && this->isPrefetched(handle)) {
+            this->get(handle);
+        }
+    }
+
+    // Requests are consumed by get, either directly or while instancing a dependent asset
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+                                   [this](io::SerializableHandle handle) {
+                                       return m_registry[handle].Request == nullptr;
+                                   }),
+                    m_pending.end());
+}
+
+bool AssetManager::saveAsset(io::SerializableAsset* object) {
     // Verify that the object is valid
     ADERITE_DYNAMIC_ASSERT(object != nullptr, "Nullptr object passed to save");
     ADERITE_DYNAMIC_ASSERT(object->getHandle() != c_InvalidHandle, "SerializableAsset with invalid handle passed");
@@ -167,41 +428,75 @@ void AssetManager::save(io::SerializableAsset* object) const {
     // Resolve where to store this object
     LOG_TRACE("[Asset] Emitting {0} to DataChunk", object->getHandle());
     io::DataChunk chunk = aderite::Engine::getFileHandler()->openSerializable(object->getHandle());
-    chunk.Data.resize(out.size());
-    std::memcpy(chunk.Data.data(), out.c_str(), chunk.Data.size());
+    aderite::Engine::getSerializer()->writeDocument(out, chunk);
     aderite::Engine::getFileHandler()->commit(chunk);
+
+    // Keep the dependency graph up to date, it is stored with the registry
+    return this->trackDependencies(object->getHandle());
 }
 
-void AssetManager::track(io::SerializableAsset* object) {
-    m_registry.push_back({object, m_nextFreeHandle++});
-    object->m_handle = m_nextFreeHandle - 1;
+bool AssetManager::trackDependencies(io::SerializableHandle handle) {
+    AssetRegistryEntry& entry = m_registry[handle];
+    if (entry.Asset == nullptr) {
+        return false;
+    }
 
-    // Save registry
-    this->saveRegistry();
+    std::vector<io::SerializableHandle> dependencies;
+    entry.Asset->getDependencies(dependencies);
+    if (dependencies == entry.Dependencies) {
+        return false;
+    }
+
+    entry.Dependencies.swap(dependencies);
+    return true;
 }
 
-void AssetManager::untrack(io::SerializableAsset* asset) {
-    ADERITE_DYNAMIC_ASSERT(asset != nullptr, "Tried to untrack nullptr");
+void AssetManager::freeAsset(AssetRegistryEntry& entry) {
+    entry.Asset->unload();
+
+    // And delete and flag as no meta
+    delete entry.Asset;
+    entry.Asset = nullptr;
+    entry.Generation++;
+}
 
-    // Remove from list
-    auto it = std::find_if(m_registry.begin(), m_registry.end(), [asset](auto& entry) {
-        return entry.Asset != nullptr && entry.Asset == asset;
-    });
+bool AssetManager::makeResident(AssetRegistryEntry& entry) {
+    auto it = m_residency.find(entry.Asset->getType());
+    if (it == m_residency.end()) {
+        return false;
+    }
 
-    if (it != m_registry.end()) {
-        ADERITE_DYNAMIC_ASSERT(it->Asset->getRefCount() == 0, "Tried to untrack asset with outstanding references");
-        m_registry.erase(it);
+    ResidencyPool& pool = it->second;
+    const size_t size = std::max(entry.Asset->getResidentSize(), c_MinResidentSize);
+    if (pool.Budget == 0 || size > pool.Budget) {
+        return false;
     }
+
+    pool.Lru.push_front(entry.Handle);
+    pool.Used += size;
+    entry.Resident = true;
+    entry.ResidentSize = size;
+    entry.ResidentIt = pool.Lru.begin();
+
+    this->trim(pool, pool.Budget);
+    return true;
 }
 
-void AssetManager::saveAllTrackedObjects() const {
-    LOG_TRACE("[Asset] Saving all objects");
-    for (auto& obj : m_registry) {
-        if (obj.Asset != nullptr) {
-            this->save(obj.Asset);
-        }
+void AssetManager::removeResident(AssetRegistryEntry& entry) {
+    ResidencyPool& pool = m_residency[entry.Asset->getType()];
+    pool.Lru.erase(entry.ResidentIt);
+    pool.Used -= entry.ResidentSize;
+    entry.Resident = false;
+    entry.ResidentSize = 0;
+}
+
+void AssetManager::trim(ResidencyPool& pool, size_t bytes) {
+    while (!pool.Lru.empty() && pool.Used > bytes) {
+        AssetRegistryEntry& entry = m_registry[pool.Lru.back()];
+        this->removeResident(entry);
+        this->freeAsset(entry);
+        m_residencyStatistics.Evictions++;
     }
-    LOG_INFO("[Asset] All objects saved");
 }
 
 } // namespace asset
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "aderite/io/LoaderPool.hpp"
 #include "aderite/io/SerializableAsset.hpp"
+#include "aderite/threading/Forward.hpp"
 
 namespace aderite {
 class Engine;
@@ -11,21 +18,85 @@ class Engine;
 namespace asset {
 
 /**
- * @brief AssetManager class is used to hold references and manage asset that are currently loaded
+ * @brief Result of an asynchronous asset get, becomes ready once the asset and its dependencies are instanced
+ */
+using AssetFuture = std::shared_future<io::SerializableAsset*>;
+
+/**
+ * @brief AssetManager class is used to hold references and manage asset that are currently loaded.
+ * The registry is a dense table indexed by the serializable handle, handles are never reused so
+ * untracked handles leave an empty slot behind.
  */
 class AssetManager final {
+public:
+    /**
+     * @brief Residency cache counters, accumulated since the asset manager was created
+     */
+    struct ResidencyStatistics {
+        size_t Hits = 0;      // Zero reference resident assets that were acquired again
+        size_t Misses = 0;    // Assets that had to be instanced from their serialized data
+        size_t Evictions = 0; // Resident assets freed because the budget of their type was exceeded
+    };
+
+    /**
+     * @brief Handle of an asset together with the registry generation of its instance. Unlike an instance pointer it can
+     * be checked for staleness after the instance was freed
+     */
+    struct WeakHandle {
+        io::SerializableHandle Handle = io::SerializableAsset::c_InvalidHandle;
+        uint32_t Generation = 0;
+    };
+
+    /**
+     * @brief Smallest number of bytes a resident asset counts towards the budget, so that assets reporting no size are
+     * evicted as well
+     */
+    static constexpr size_t c_MinResidentSize = 4 * 1024;
+
 private:
+    /**
+     * @brief Outstanding asynchronous get, the document is read and parsed by a job worker and instanced during update
+     */
+    struct AsyncRequest {
+        threading::JobHandle Job;
+        YAML::Node Document;
+        std::promise<io::SerializableAsset*> Promise;
+        AssetFuture Future;
+        size_t Acquires = 0; // References acquired on behalf of getAsync callers once instanced
+    };
+
     struct AssetRegistryEntry {
         io::SerializableAsset* Asset = nullptr;
         io::SerializableHandle Handle = io::SerializableAsset::c_InvalidHandle;
+        uint32_t Generation = 0; // Incremented every time the instance is freed or the handle is untracked
+        bool Tracked = false;
+        bool Dirty = false;
+        std::vector<io::SerializableHandle> Dependencies; // Prefetched together with this asset
+        std::shared_ptr<AsyncRequest> Request;            // Pending asynchronous get, nullptr if none
+
+        // Zero reference assets kept in the residency cache
+        bool Resident = false;
+        size_t ResidentSize = 0;
+        std::list<io::SerializableHandle>::iterator ResidentIt;
+    };
+
+    /**
+     * @brief Zero reference assets of a single type, most recently released first
+     */
+    struct ResidencyPool {
+        size_t Budget = 0;
+        size_t Used = 0;
+        std::list<io::SerializableHandle> Lru;
     };
 
 public:
     /**
      * @brief Initializes the asset manager
+     * @param meshBudget Residency budget of meshes in bytes
+     * @param textureBudget Residency budget of textures in bytes
      * @return True if initialized without error, false otherwise
      */
-    bool init();
+    bool init(size_t meshBudget, size_t textureBudget);
 
     /**
      * @brief Shutdown asset manager
@@ -34,6 +105,7 @@ public:
 
     /**
      * @brief Updates the asset manager, queueing necessary assets, freeing unneeded, etc.
+     * Only assets that were marked dirty since the last update are checked
      */
     void update();
 
@@ -61,10 +133,20 @@ public:
     io::SerializableAsset* get(io::SerializableHandle handle);
 
     /**
-     * @brief Serializes object into a file
+     * @brief Returns object associated with the serializable handle without blocking, the document of the asset and
+     * of all its dependencies is read and parsed on job workers in a single wave and instanced during update.
+     * A reference is acquired on behalf of the caller once the asset is instanced, release it when no longer needed.
+     * @param handle Handle of the object
+     * @param priority Priority of the parse jobs
+     * @return Future of the object instance
+     */
+    AssetFuture getAsync(io::SerializableHandle handle, io::LoaderPool::Priority priority = io::LoaderPool::Priority::NORMAL);
+
+    /**
+     * @brief Serializes object into a file, the registry is saved as well if the dependencies of the object changed
      * @param object Object to serialize
      */
-    void save(io::SerializableAsset* object) const;
+    void save(io::SerializableAsset* object);
 
     /**
      * @brief Adds an object to the asset manager look up table, if already existing object is added
@@ -83,7 +165,55 @@ public:
     /**
      * @brief Utility method for saving all objects that are currently tracked
      */
-    void saveAllTrackedObjects() const;
+    void saveAllTrackedObjects();
+
+    /**
+     * @brief Marks the asset as dirty so it is checked during the next update, called when the reference count changes
+     * @param handle Handle of the asset
+     */
+    void markDirty(io::SerializableHandle handle);
+
+    /**
+     * @brief Returns a weak handle to the current instance of the asset
+     * @param asset Live tracked asset instance
+     */
+    WeakHandle getWeakHandle(const io::SerializableAsset* asset) const;
+
+    /**
+     * @brief Returns true if the instance the weak handle was taken from no longer belongs to the registry, because it was
+     * freed or untracked. The instance itself is never accessed
+     * @param handle Weak handle to check
+     */
+    bool isStale(const WeakHandle& handle) const;
+
+    /**
+     * @brief Returns the number of tracked assets
+     */
+    size_t getTrackedCount() const;
+
+    /**
+     * @brief Sets the number of bytes that zero reference assets of the specified type can keep resident, instead of
+     * being freed immediately they are kept until the budget is exceeded and then evicted least recently used first.
+     * A budget of 0 frees assets as soon as their reference count reaches 0
+     * @param type Asset type
+     * @param bytes Budget in bytes
+     */
+    void setResidencyBudget(reflection::Type type, size_t bytes);
+
+    /**
+     * @brief Returns the residency budget of the specified asset type
+     */
+    size_t getResidencyBudget(reflection::Type type) const;
+
+    /**
+     * @brief Returns the number of bytes currently kept resident by zero reference assets of the specified type
+     */
+    size_t getResidentSize(reflection::Type type) const;
+
+    /**
+     * @brief Returns residency cache counters
+     */
+    const ResidencyStatistics& getResidencyStatistics() const;
 
     auto begin() {
         return m_registry.begin();
@@ -105,10 +235,75 @@ private:
     AssetManager() {}
     friend Engine;
 
+    /**
+     * @brief Schedules parsing of the asset and its dependencies, does nothing for instanced or already requested assets
+     * @param handle Handle of the asset
+     * @param priority Priority of the parse jobs
+     */
+    void prefetch(io::SerializableHandle handle, io::LoaderPool::Priority priority);
+
+    /**
+     * @brief Returns true if the asset and all its dependencies are either instanced or parsed
+     * @param handle Handle of the asset
+     */
+    bool isPrefetched(io::SerializableHandle handle) const;
+
+    /**
+     * @brief Instances pending asynchronous requests whose dependencies are ready
+     */
+    void resolveRequests();
+
+    /**
+     * @brief Serializes object into a file and refreshes its dependencies
+     * @param object Object to serialize
+     * @return True if the dependencies changed and the registry has to be saved, false otherwise
+     */
+    bool saveAsset(io::SerializableAsset* object);
+
+    /**
+     * @brief Refreshes the dependency list of the asset from its instance
+     * @param handle Handle of an instanced asset
+     * @return True if the dependencies changed, false otherwise
+     */
+    bool trackDependencies(io::SerializableHandle handle);
+
+    /**
+     * @brief Unloads and deletes the asset instance of the entry
+     */
+    void freeAsset(AssetRegistryEntry& entry);
+
+    /**
+     * @brief Tries to keep a zero reference asset resident
+     * @return True if the asset is now resident, false if it doesn't fit into the budget of its type
+     */
+    bool makeResident(AssetRegistryEntry& entry);
+
+    /**
+     * @brief Removes the asset from the residency cache without freeing it
+     */
+    void removeResident(AssetRegistryEntry& entry);
+
+    /**
+     * @brief Evicts least recently used assets until the pool fits into the specified number of bytes
+     */
+    void trim(ResidencyPool& pool, size_t bytes);
+
 private:
-    // Registry
+    // Registry, indexed by handle
     io::SerializableHandle m_nextFreeHandle = 0;
     std::vector<AssetRegistryEntry> m_registry;
+    size_t m_trackedCount = 0;
+
+    // Handles whose reference count changed since the last update
+    std::vector<io::SerializableHandle> m_dirty;
+    std::vector<io::SerializableHandle> m_processing;
+
+    // Handles with a pending asynchronous request
+    std::vector<io::SerializableHandle> m_pending;
+
+    // Residency cache
+    std::unordered_map<reflection::Type, ResidencyPool> m_residency;
+    ResidencyStatistics m_residencyStatistics;
 };
 
 } // namespace asset
@@ -15,7 +15,6 @@ namespace asset {
 
 MaterialAsset::~MaterialAsset() {
     LOG_TRACE("[Asset] Destroying {0}", this->getName());
-    std::free(m_udata);
 
     if (m_type != nullptr) {
         m_type->release();
@@ -40,9 +39,6 @@ void MaterialAsset::setMaterialType(MaterialTypeAsset* type) {
     m_type = type;
     m_type->acquire();
 
-    // Samplers
-    const size_t dataSize = m_type->getSize() * 4 * sizeof(float);
-
     // Release previous references
     for (TextureAsset* ta : m_samplers) {
         if (ta != nullptr) {
@@ -52,16 +48,10 @@ void MaterialAsset::setMaterialType(MaterialTypeAsset* type) {
 
     m_samplers.clear();
 
-    float* realloced = static_cast<float*>(std::realloc(m_udata, dataSize));
-    if (realloced != nullptr) {
-        m_udata = realloced;
-    } else {
-        LOG_ERROR("[Asset] Failed to realloc material {0} data array", this->getName());
-        return;
-    }
-
-    std::memset(m_udata, 0, dataSize);
+    // Property data, zeroed
+    m_udata.assign(m_type->getSize() * 4, 0.0f);
 
+    // Samplers
     for (size_t i = 0; i < m_type->getSamplerCount(); i++) {
         m_samplers.push_back(nullptr);
     }
@@ -81,6 +71,18 @@ bool MaterialAsset::isValid() const {
     return true;
 }
 
+void MaterialAsset::getDependencies(std::vector<io::SerializableHandle>& dependencies) const {
+    if (m_type != nullptr) {
+        dependencies.push_back(m_type->getHandle());
+    }
+
+    for (asset::TextureAsset* ta : m_samplers) {
+        if (ta != nullptr) {
+            dependencies.push_back(ta->getHandle());
+        }
+    }
+}
+
 void MaterialAsset::load(const io::Loader* loader) {
     LOG_TRACE("[Asset] Loading {0}", this->getName());
 
@@ -208,8 +210,16 @@ TextureAsset* MaterialAsset::getSampler(size_t index) const {
     return m_samplers[index];
 }
 
-float* MaterialAsset::getPropertyData() const {
-    return m_udata;
+float* MaterialAsset::getPropertyData() {
+    return m_udata.data();
+}
+
+const float* MaterialAsset::getPropertyData() const {
+    return m_udata.data();
+}
+
+size_t MaterialAsset::getPropertySize() const {
+    return m_udata.size();
 }
 
 } // namespace asset
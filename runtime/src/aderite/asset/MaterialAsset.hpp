@@ -56,9 +56,16 @@ public:
     /**
      * @brief Returns material property data array
      */
-    float* getPropertyData() const;
+    float* getPropertyData();
+    const float* getPropertyData() const;
+
+    /**
+     * @brief Returns the number of floats in the material property data array
+     */
+    size_t getPropertySize() const;
 
     // Inherited via SerializableAsset
+    void getDependencies(std::vector<io::SerializableHandle>& dependencies) const override;
     void load(const io::Loader* loader) override;
     void unload() override;
     bool needsLoading() const override;
@@ -69,7 +76,7 @@ public:
 private:
     MaterialTypeAsset* m_type = nullptr; // Material type
     std::vector<TextureAsset*> m_samplers;
-    float* m_udata = nullptr; // Data passed to material uniform
+    std::vector<float> m_udata; // Data passed to material uniform
 };
 
 } // namespace asset
@@ -48,6 +48,22 @@ void MaterialTypeAsset::setSamplerCount(size_t count) {
     m_numSamplers = count;
 }
 
+bool MaterialTypeAsset::isTransparent() const {
+    return m_transparent;
+}
+
+void MaterialTypeAsset::setTransparent(bool value) {
+    m_transparent = value;
+}
+
+bool MaterialTypeAsset::usesMaterialBuffer() const {
+    return m_materialBuffer;
+}
+
+void MaterialTypeAsset::setMaterialBuffer(bool value) {
+    m_materialBuffer = value;
+}
+
 std::vector<std::string> MaterialTypeAsset::getSamplerNames() const {
     return m_samplerNames;
 }
@@ -77,6 +93,13 @@ void MaterialTypeAsset::load(const io::Loader* loader) {
     // Create program
     m_shaderHandle = bgfx::createProgram(vsh, fsh, true);
 
+    // Depth variant, transparent types are never drawn in the depth prepass
+    if (!m_transparent && slr.DepthVertexSource.size() > 0 && slr.DepthFragmentSource.size() > 0) {
+        bgfx::ShaderHandle dvsh = load_shader(slr.DepthVertexSource, this->getName() + " depth vertex");
+        bgfx::ShaderHandle dfsh = load_shader(slr.DepthFragmentSource, this->getName() + " depth fragment");
+        m_depthShaderHandle = bgfx::createProgram(dvsh, dfsh, true);
+    }
+
     // Create uniform
     m_uniformHandle = bgfx::createUniform(("mf_mat_buffer_" + this->getName()).c_str(), bgfx::UniformType::Vec4, m_size);
 
@@ -98,6 +121,11 @@ void MaterialTypeAsset::unload() {
         m_shaderHandle = BGFX_INVALID_HANDLE;
     }
 
+    if (bgfx::isValid(m_depthShaderHandle)) {
+        bgfx::destroy(m_depthShaderHandle);
+        m_depthShaderHandle = BGFX_INVALID_HANDLE;
+    }
+
     if (bgfx::isValid(m_uniformHandle)) {
         bgfx::destroy(m_uniformHandle);
         m_uniformHandle = BGFX_INVALID_HANDLE;
@@ -130,6 +158,8 @@ reflection::Type MaterialTypeAsset::getType() const {
 bool MaterialTypeAsset::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
     emitter << YAML::Key << "DataSize" << YAML::Value << m_size;
     emitter << YAML::Key << "SamplerCount" << YAML::Value << m_numSamplers;
+    emitter << YAML::Key << "Transparent" << YAML::Value << m_transparent;
+    emitter << YAML::Key << "MaterialBuffer" << YAML::Value << m_materialBuffer;
     emitter << YAML::Key << "SamplerNames" << YAML::Flow << YAML::BeginSeq;
     for (const std::string& name : m_samplerNames) {
         emitter << name;
@@ -141,6 +171,12 @@ bool MaterialTypeAsset::serialize(const io::Serializer* serializer, YAML::Emitte
 bool MaterialTypeAsset::deserialize(io::Serializer* serializer, const YAML::Node& data) {
     m_size = data["DataSize"].as<size_t>();
     m_numSamplers = data["SamplerCount"].as<size_t>();
+    if (data["Transparent"]) {
+        m_transparent = data["Transparent"].as<bool>();
+    }
+    if (data["MaterialBuffer"]) {
+        m_materialBuffer = data["MaterialBuffer"].as<bool>();
+    }
     for (const YAML::Node& samplerName : data["SamplerNames"]) {
         m_samplerNames.push_back(samplerName.as<std::string>());
     }
@@ -151,6 +187,10 @@ bgfx::ProgramHandle MaterialTypeAsset::getShaderHandle() const {
     return m_shaderHandle;
 }
 
+bgfx::ProgramHandle MaterialTypeAsset::getDepthShaderHandle() const {
+    return m_depthShaderHandle;
+}
+
 bgfx::UniformHandle MaterialTypeAsset::getUniformHandle() const {
     return m_uniformHandle;
 }
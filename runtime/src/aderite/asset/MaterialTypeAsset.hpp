@@ -22,6 +22,11 @@ public:
      */
     bgfx::ProgramHandle getShaderHandle() const;
 
+    /**
+     * @brief Get the position only shader handle used for the depth prepass, invalid if the type has no depth variant
+     */
+    bgfx::ProgramHandle getDepthShaderHandle() const;
+
     /**
      * @brief Get the uniform handle of the material type
      */
@@ -60,6 +65,29 @@ public:
      */
     void setSamplerCount(size_t count);
 
+    /**
+     * @brief Returns true if materials of this type are alpha blended and drawn back to front after opaque ones
+     */
+    bool isTransparent() const;
+
+    /**
+     * @brief Sets the transparency of the material type
+     * @param value True if alpha blended
+     */
+    void setTransparent(bool value);
+
+    /**
+     * @brief Returns true if the shaders of this type read material properties from the renderer material buffer
+     * instead of the material uniform
+     */
+    bool usesMaterialBuffer() const;
+
+    /**
+     * @brief Sets if the shaders of this type read material properties from the material buffer
+     * @param value True if the material buffer is used
+     */
+    void setMaterialBuffer(bool value);
+
     /**
      * @brief Returns the sampler names of this material type
      */
@@ -82,6 +110,7 @@ public:
 private:
     // Shader
     bgfx::ProgramHandle m_shaderHandle = BGFX_INVALID_HANDLE;
+    bgfx::ProgramHandle m_depthShaderHandle = BGFX_INVALID_HANDLE;
 
     // Material properties
     bgfx::UniformHandle m_uniformHandle = BGFX_INVALID_HANDLE;
@@ -89,6 +118,8 @@ private:
 
     size_t m_size; // Number of vec4 components
     size_t m_numSamplers;
+    bool m_transparent = false;
+    bool m_materialBuffer = false;
     std::vector<std::string> m_samplerNames;
 };
 
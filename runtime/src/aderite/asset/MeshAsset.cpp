@@ -1,5 +1,7 @@
 #include "MeshAsset.hpp"
 
+#include <cstring>
+
 #include "aderite/Aderite.hpp"
 #include "aderite/io/Loader.hpp"
 #include "aderite/utility/Log.hpp"
@@ -16,20 +18,35 @@ MeshAsset::~MeshAsset() {
 }
 
 bool MeshAsset::isValid() const {
-    return bgfx::isValid(m_vbh) && bgfx::isValid(m_ibh);
+    return m_loaded.load(std::memory_order_acquire);
 }
 
-void MeshAsset::load(const io::Loader* loader) {
-    LOG_TRACE("[Asset] Loading {0}", this->getName());
-    ADERITE_DYNAMIC_ASSERT(!bgfx::isValid(m_vbh), "Tried to load already loaded mesh");
+/**
+ * @brief Called by bgfx once a buffer referencing cooked mesh data was uploaded
+ */
+static void releaseSource(void* ptr, void* userData) {
+    delete static_cast<std::shared_ptr<const io::DataChunk>*>(userData);
+}
 
-    // Create layout
+/**
+ * @brief Vertex layout of every mesh, matches the cooked layout
+ */
+static bgfx::VertexLayout meshLayout() {
     bgfx::VertexLayout layout;
     layout.begin();
     layout.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float);
     layout.add(bgfx::Attrib::Normal, 3, bgfx::AttribType::Float);
     layout.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float);
     layout.end();
+    return layout;
+}
+
+void MeshAsset::load(const io::Loader* loader) {
+    LOG_TRACE("[Asset] Loading {0}", this->getName());
+    ADERITE_DYNAMIC_ASSERT(!bgfx::isValid(m_vbh), "Tried to load already loaded mesh");
+
+    // Create layout
+    const bgfx::VertexLayout layout = meshLayout();
 
     // Create handles
     io::Loader::MeshLoadResult result = loader->loadMesh(this->getHandle());
@@ -38,19 +55,79 @@ void MeshAsset::load(const io::Loader* loader) {
         return;
     }
 
-    auto& positionData = result.Vertices;
-    auto& indicesData = result.Indices;
-    m_vbh = bgfx::createVertexBuffer(bgfx::copy(positionData.data(), sizeof(float) * positionData.size()), layout);
-    m_ibh = bgfx::createIndexBuffer(bgfx::copy(indicesData.data(), sizeof(unsigned int) * indicesData.size()), BGFX_BUFFER_INDEX32);
+    ADERITE_DYNAMIC_ASSERT(layout.getStride() == io::MeshCooker::c_VertexStride, "Cooked mesh and vertex layout mismatch");
+
+    // Culling data is read before the source is handed to bgfx, position is the first vertex attribute
+    const io::MeshCooker::View& mesh = result.Mesh;
+    m_bounds = rendering::Bounds::fromPoints(reinterpret_cast<const float*>(mesh.Vertices), mesh.VertexCount,
+                                             io::MeshCooker::c_VertexStride);
+    if (mesh.IndexCount / 3 <= c_MaxOccluderTriangles) {
+        m_occluder = std::make_unique<rendering::OccluderMesh>();
+        m_occluder->Vertices.resize(mesh.VertexCount);
+        for (uint32_t i = 0; i < mesh.VertexCount; i++) {
+            std::memcpy(&m_occluder->Vertices[i], mesh.Vertices + static_cast<size_t>(i) * io::MeshCooker::c_VertexStride,
+                        sizeof(glm::vec3));
+        }
+
+        m_occluder->Indices.resize(mesh.IndexCount);
+        for (uint32_t i = 0; i < mesh.IndexCount; i++) {
+            if (mesh.Index32) {
+                std::memcpy(&m_occluder->Indices[i], mesh.Indices + i * sizeof(uint32_t), sizeof(uint32_t));
+            } else {
+                uint16_t index;
+                std::memcpy(&index, mesh.Indices + i * sizeof(uint16_t), sizeof(uint16_t));
+                m_occluder->Indices[i] = index;
+            }
+        }
+    }
+
+    m_lodCount = mesh.LodCount;
+    std::memcpy(m_lods, mesh.Lods, sizeof(m_lods));
+
+    size_t residentSize = static_cast<size_t>(mesh.VertexSize) + mesh.IndexSize;
+    if (m_occluder != nullptr) {
+        residentSize += m_occluder->Vertices.size() * sizeof(glm::vec3) + m_occluder->Indices.size() * sizeof(uint32_t);
+    }
+    m_residentSize = residentSize;
+
+    // Cooked data is uploaded in place, the buffers keep the source alive until bgfx is done with it
+    m_vbh = bgfx::createVertexBuffer(
+        bgfx::makeRef(mesh.Vertices, mesh.VertexSize, releaseSource, new std::shared_ptr<const io::DataChunk>(result.Source)), layout);
+    m_ibh = bgfx::createIndexBuffer(
+        bgfx::makeRef(mesh.Indices, mesh.IndexSize, releaseSource, new std::shared_ptr<const io::DataChunk>(result.Source)),
+        mesh.Index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
 
     bgfx::setName(m_vbh, this->getName().c_str());
     bgfx::setName(m_ibh, this->getName().c_str());
 
+    // Published last, the main thread reads the other fields only after seeing the mesh as valid
+    m_loaded.store(true, std::memory_order_release);
+
     LOG_INFO("[Asset] Loaded {0}", this->getName());
 }
 
+void MeshAsset::create(const std::vector<float>& vertices, const std::vector<uint32_t>& indices) {
+    ADERITE_DYNAMIC_ASSERT(!bgfx::isValid(m_vbh), "Tried to create already loaded mesh");
+    ADERITE_DYNAMIC_ASSERT(vertices.size() % 8 == 0, "Generated mesh vertices don't match the vertex layout");
+
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size() / 8);
+    m_bounds = rendering::Bounds::fromPoints(vertices.data(), vertexCount, io::MeshCooker::c_VertexStride);
+
+    const uint32_t vertexSize = static_cast<uint32_t>(vertices.size() * sizeof(float));
+    const uint32_t indexSize = static_cast<uint32_t>(indices.size() * sizeof(uint32_t));
+    m_vbh = bgfx::createVertexBuffer(bgfx::copy(vertices.data(), vertexSize), meshLayout());
+    m_ibh = bgfx::createIndexBuffer(bgfx::copy(indices.data(), indexSize), BGFX_BUFFER_INDEX32);
+
+    m_lodCount = 1;
+    m_lods[0] = {0, static_cast<uint32_t>(indices.size())};
+
+    m_residentSize = static_cast<size_t>(vertexSize) + indexSize;
+    m_loaded.store(true, std::memory_order_release);
+}
+
 void MeshAsset::unload() {
     LOG_TRACE("[Asset] Unloading {0}", this->getName());
+    m_loaded.store(false, std::memory_order_release);
 
     if (bgfx::isValid(m_vbh)) {
         bgfx::destroy(m_vbh);
@@ -62,6 +139,10 @@ void MeshAsset::unload() {
         m_ibh = BGFX_INVALID_HANDLE;
     }
 
+    m_residentSize = 0;
+    m_lodCount = 0;
+    m_occluder.reset();
+
     LOG_INFO("[Asset] Unloaded {0}", this->getName());
 }
 
@@ -69,6 +150,10 @@ bool MeshAsset::needsLoading() const {
     return !this->isValid();
 }
 
+size_t MeshAsset::getResidentSize() const {
+    return m_residentSize;
+}
+
 reflection::Type MeshAsset::getType() const {
     return static_cast<reflection::Type>(reflection::RuntimeTypes::MESH);
 }
@@ -81,6 +166,22 @@ bool MeshAsset::deserialize(io::Serializer* serializer, const YAML::Node& data)
     return true;
 }
 
+uint32_t MeshAsset::getLodCount() const {
+    return m_lodCount;
+}
+
+const io::MeshCooker::Lod& MeshAsset::getLod(uint32_t lod) const {
+    return m_lods[lod];
+}
+
+const rendering::Bounds& MeshAsset::getBounds() const {
+    return m_bounds;
+}
+
+const rendering::OccluderMesh* MeshAsset::getOccluder() const {
+    return m_occluder.get();
+}
+
 bgfx::VertexBufferHandle MeshAsset::getVboHandle() const {
     return m_vbh;
 }
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <bgfx/bgfx.h>
 
+#include "aderite/io/MeshCooker.hpp"
 #include "aderite/io/SerializableAsset.hpp"
+#include "aderite/rendering/Bounds.hpp"
+#include "aderite/rendering/OcclusionBuffer.hpp"
 
 namespace aderite {
 namespace asset {
@@ -11,6 +18,12 @@ namespace asset {
  * @brief Mesh asset implementation
  */
 class MeshAsset final : public io::SerializableAsset {
+public:
+    /**
+     * @brief Meshes with more triangles than this don't keep a CPU copy for occlusion culling
+     */
+    static constexpr uint32_t c_MaxOccluderTriangles = 512;
+
 public:
     ~MeshAsset();
 
@@ -26,7 +39,36 @@ public:
     bgfx::IndexBufferHandle getIboHandle() const;
 
     /**
-     * @brief Returns true if the mesh is valid
+     * @brief Returns the number of detail levels, at least 1 once loaded
+     */
+    uint32_t getLodCount() const;
+
+    /**
+     * @brief Returns the index range of a detail level, 0 is the full detail mesh
+     * @param lod Level index
+     */
+    const io::MeshCooker::Lod& getLod(uint32_t lod) const;
+
+    /**
+     * @brief Returns the object space bounds of the mesh, computed at load
+     */
+    const rendering::Bounds& getBounds() const;
+
+    /**
+     * @brief Returns the occluder of the mesh or nullptr if the mesh is too detailed to be used as one
+     */
+    const rendering::OccluderMesh* getOccluder() const;
+
+    /**
+     * @brief Creates the mesh from data generated at runtime instead of loading it
+     * @param vertices Interleaved vertices, 8 floats per vertex matching the cooked layout
+     * @param indices Indices
+     */
+    void create(const std::vector<float>& vertices, const std::vector<uint32_t>& indices);
+
+    /**
+     * @brief Returns true if the mesh is valid, once true every getter returns the loaded values even if the mesh was
+     * loaded by a loader job
      */
     bool isValid() const;
 
@@ -34,14 +76,29 @@ public:
     void load(const io::Loader* loader) override;
     void unload() override;
     bool needsLoading() const override;
+    size_t getResidentSize() const override;
     reflection::Type getType() const override;
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
     bool deserialize(io::Serializer* serializer, const YAML::Node& data) override;
 
 private:
+    // Set after every other field was written, loader jobs publish the mesh with it
+    std::atomic<bool> m_loaded {false};
+
     // BGFX resource handles
     bgfx::VertexBufferHandle m_vbh = BGFX_INVALID_HANDLE;
     bgfx::IndexBufferHandle m_ibh = BGFX_INVALID_HANDLE;
+
+    // Size of the uploaded buffers
+    std::atomic<size_t> m_residentSize {0}; // Written by loader jobs, read during asset manager update
+
+    // Detail levels, index ranges into the index buffer
+    uint32_t m_lodCount = 0;
+    io::MeshCooker::Lod m_lods[io::MeshCooker::c_MaxLods] = {};
+
+    // Culling
+    rendering::Bounds m_bounds;
+    std::unique_ptr<rendering::OccluderMesh> m_occluder;
 };
 
 } // namespace asset
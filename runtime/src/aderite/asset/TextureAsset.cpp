@@ -1,5 +1,7 @@
 #include "TextureAsset.hpp"
 
+#include <memory>
+
 #include "aderite/Aderite.hpp"
 #include "aderite/io/Loader.hpp"
 #include "aderite/utility/Log.hpp"
@@ -19,28 +21,64 @@ bool TextureAsset::isValid() const {
     return bgfx::isValid(m_handle);
 }
 
+bool TextureAsset::isFullyResident() const {
+    return this->isValid() && m_residentLevel == 0;
+}
+
+/**
+ * @brief Called by bgfx once a texture referencing cooked texture data was uploaded
+ */
+static void releaseSource(void* ptr, void* userData) {
+    delete static_cast<std::shared_ptr<const io::DataChunk>*>(userData);
+}
+
 void TextureAsset::load(const io::Loader* loader) {
     LOG_TRACE("[Asset] Loading {0}", this->getName());
-    ADERITE_DYNAMIC_ASSERT(!bgfx::isValid(m_handle), "Tried to load already loaded texture");
+    ADERITE_DYNAMIC_ASSERT(!this->isFullyResident(), "Tried to load already loaded texture");
 
     if (m_isCubemap) {
         LOG_ERROR("Cubemap not implemented");
         return;
     } else {
-        io::Loader::TextureLoadResult<unsigned char> result = loader->loadTexture(this->getHandle());
+        io::Loader::CookedTextureLoadResult result = loader->loadTexture(this->getHandle());
         if (!result.Error.empty()) {
             return;
         }
 
-        m_handle = bgfx::createTexture2D(static_cast<uint16_t>(result.Width), static_cast<uint16_t>(result.Height), false, 1,
-                                         static_cast<bgfx::TextureFormat::Enum>(result.Format),
-                                         BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP,
-                                         bgfx::copy(result.Data.get(), result.Width * result.Height * result.BPP));
+        const io::TextureCooker::View& texture = result.Texture;
+        const bgfx::TextureFormat::Enum format = static_cast<bgfx::TextureFormat::Enum>(texture.Format);
+        const uint64_t flags = BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP | BGFX_SAMPLER_W_CLAMP;
+        if (!bgfx::isTextureValid(0, false, 1, format, flags)) {
+            LOG_ERROR("[Asset] {0} format {1} is not supported by the renderer", this->getName(), texture.Format);
+            return;
+        }
+
+        // Start with the mip tail so the texture is usable right away, every following load streams in larger levels
+        uint32_t level = io::TextureCooker::getStreamingBase(texture, c_StreamingTailSize);
+        if (bgfx::isValid(m_handle)) {
+            level = m_residentLevel > c_StreamingStep ? m_residentLevel - c_StreamingStep : 0;
+        }
+
+        // Levels are stored largest first and contiguous, so the chain starting at any level can be uploaded in place
+        const io::TextureCooker::Level& base = texture.Levels[level];
+        const io::TextureCooker::Level& last = texture.Levels.back();
+        const uint32_t size = static_cast<uint32_t>(last.Data + last.Size - base.Data);
+        const bgfx::TextureHandle handle = bgfx::createTexture2D(
+            static_cast<uint16_t>(base.Width), static_cast<uint16_t>(base.Height), level + 1 < texture.Levels.size(), 1, format, flags,
+            bgfx::makeRef(base.Data, size, releaseSource, new std::shared_ptr<const io::DataChunk>(result.Source)));
+        bgfx::setName(handle, this->getName().c_str());
+
+        if (bgfx::isValid(m_handle)) {
+            // bgfx defers destruction until the frame that might still use the old texture is done
+            bgfx::destroy(m_handle);
+        }
 
-        bgfx::setName(m_handle, this->getName().c_str());
+        m_handle = handle;
+        m_residentLevel = level;
+        m_residentSize = size;
     }
 
-    LOG_INFO("[Asset] Loaded {0}", this->getName());
+    LOG_INFO("[Asset] Loaded {0} from level {1}", this->getName(), m_residentLevel);
 }
 
 void TextureAsset::unload() {
@@ -51,11 +89,18 @@ void TextureAsset::unload() {
         m_handle = BGFX_INVALID_HANDLE;
     }
 
+    m_residentSize = 0;
+    m_residentLevel = 0;
+
     LOG_INFO("[Asset] Unloaded {0}", this->getName());
 }
 
 bool TextureAsset::needsLoading() const {
-    return !this->isValid();
+    return !this->isValid() || !this->isFullyResident();
+}
+
+size_t TextureAsset::getResidentSize() const {
+    return m_residentSize;
 }
 
 reflection::Type TextureAsset::getType() const {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include <bgfx/bgfx.h>
 
 #include "aderite/io/SerializableAsset.hpp"
@@ -8,9 +10,17 @@ namespace aderite {
 namespace asset {
 
 /**
- * @brief Texture asset implementation
+ * @brief Texture asset implementation, cooked textures are streamed in starting from the smallest mips, every load
+ * after the first one replaces the texture with one that has more levels until the full chain is resident
  */
 class TextureAsset final : public io::SerializableAsset {
+public:
+    // Largest level uploaded by the first load
+    static constexpr uint32_t c_StreamingTailSize = 64;
+
+    // Number of levels added by every following load
+    static constexpr uint32_t c_StreamingStep = 2;
+
 public:
     ~TextureAsset();
 
@@ -46,10 +56,16 @@ public:
      */
     bool isValid() const;
 
+    /**
+     * @brief Returns true if every mip level of the texture is resident
+     */
+    bool isFullyResident() const;
+
     // Inherited via SerializableAsset
     void load(const io::Loader* loader) override;
     void unload() override;
     bool needsLoading() const override;
+    size_t getResidentSize() const override;
     reflection::Type getType() const override;
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
     bool deserialize(io::Serializer* serializer, const YAML::Node& data) override;
@@ -57,6 +73,16 @@ public:
 private:
     bgfx::TextureHandle m_handle = BGFX_INVALID_HANDLE;
 
+    /**
+     * @brief Size of the uploaded texture data
+     */
+    std::atomic<size_t> m_residentSize {0}; // Written by loader jobs, read during asset manager update
+
+    /**
+     * @brief Largest resident mip level, 0 once the texture is fully streamed in
+     */
+    uint32_t m_residentLevel = 0;
+
     /**
      * @brief If true then the texture data is treated as floating point instead of unsigned int
      */
@@ -116,7 +116,7 @@ void AudioController::loadMasterBank() {
     io::DataChunk masterChunk = ::aderite::Engine::getFileHandler()->openReservedLoadable(io::FileHandler::Reserved::MasterAudioBank);
     io::DataChunk stringsChunk = ::aderite::Engine::getFileHandler()->openReservedLoadable(io::FileHandler::Reserved::StringsAudioBank);
 
-    if (masterChunk.Data.size() == 0 || stringsChunk.Data.size() == 0) {
+    if (masterChunk.size() == 0 || stringsChunk.size() == 0) {
         LOG_WARN("[Audio] Ignored loadMasterBank call, cause no master or strings bank was found");
         return;
     }
@@ -138,13 +138,13 @@ void AudioController::loadMasterBank() {
     LOG_TRACE("[Audio] Loading banks from memory");
 
     // Load
-    FMOD_RESULT result = m_fmodSystem->loadBankMemory(reinterpret_cast<const char*>(stringsChunk.Data.data()), stringsChunk.Data.size(),
+    FMOD_RESULT result = m_fmodSystem->loadBankMemory(reinterpret_cast<const char*>(stringsChunk.data()), stringsChunk.size(),
                                                       FMOD_STUDIO_LOAD_MEMORY, FMOD_STUDIO_LOAD_BANK_NORMAL, &m_stringBank);
 
     ADERITE_DYNAMIC_ASSERT(result == FMOD_OK, "Failed to load strings bank");
 
     // Load
-    result = m_fmodSystem->loadBankMemory(reinterpret_cast<const char*>(masterChunk.Data.data()), masterChunk.Data.size(),
+    result = m_fmodSystem->loadBankMemory(reinterpret_cast<const char*>(masterChunk.data()), masterChunk.size(),
                                           FMOD_STUDIO_LOAD_MEMORY, FMOD_STUDIO_LOAD_BANK_NORMAL, &m_masterBank);
 
     ADERITE_DYNAMIC_ASSERT(result == FMOD_OK, "Failed to load master bank");
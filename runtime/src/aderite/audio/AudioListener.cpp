@@ -26,7 +26,7 @@ void AudioListener::update(float delta) {
     }
 
     FMOD_3D_ATTRIBUTES listener3dAttributes = {};
-    const glm::vec3& position = transform->getPosition();
+    const glm::vec3 position = transform->getWorldPosition();
 
     listener3dAttributes.position = {position.x, position.y, position.z};
 
@@ -47,7 +47,7 @@ void AudioSource::update(float delta) {
     }
 
     FMOD_3D_ATTRIBUTES source3dAttributes = {};
-    const glm::vec3& position = transform->getPosition();
+    const glm::vec3 position = transform->getWorldPosition();
 
     source3dAttributes.position = {position.x, position.y, position.z};
 
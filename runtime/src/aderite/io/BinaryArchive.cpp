@@ -0,0 +1,431 @@
+#include "BinaryArchive.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <streambuf>
+#include <unordered_map>
+
+#include <yaml-cpp/eventhandler.h>
+
+#include "aderite/io/Versions.hpp"
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+
+namespace aderite {
+namespace io {
+
+namespace {
+
+/**
+ * @brief Helper for writing archives
+ */
+class ArchiveWriter {
+public:
+    void writeVarint(uint64_t value) {
+        while (value >= 0x80) {
+            m_tree.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        m_tree.push_back(static_cast<unsigned char>(value));
+    }
+
+    void writeString(const std::string& value) {
+        auto it = m_stringIndices.find(value);
+        if (it == m_stringIndices.end()) {
+            it = m_stringIndices.emplace(value, m_strings.size()).first;
+            m_strings.push_back(&it->first);
+        }
+        this->writeVarint(it->second);
+    }
+
+    void writeNode(const YAML::Node& node) {
+        switch (node.Type()) {
+        case YAML::NodeType::Scalar: {
+            m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::SCALAR));
+            this->writeString(node.Scalar());
+            break;
+        }
+        case YAML::NodeType::Sequence: {
+            m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::SEQUENCE));
+            this->writeVarint(node.size());
+            for (const YAML::Node& child : node) {
+                this->writeNode(child);
+            }
+            break;
+        }
+        case YAML::NodeType::Map: {
+            m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::MAP));
+            this->writeVarint(node.size());
+            for (const auto& kvp : node) {
+                this->writeNode(kvp.first);
+                this->writeNode(kvp.second);
+            }
+            break;
+        }
+        default: {
+            m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::NIL));
+            break;
+        }
+        }
+    }
+
+    std::vector<unsigned char> finish(reflection::Type type) {
+        // Version and string table share the varint helper, so the tree is moved aside and they are written into m_tree
+        std::vector<unsigned char> tree;
+        m_tree.swap(tree);
+
+        this->writeVarint(std::strlen(c_CurrentVersion));
+        m_tree.insert(m_tree.end(), c_CurrentVersion, c_CurrentVersion + std::strlen(c_CurrentVersion));
+        this->writeVarint(m_strings.size());
+        for (const std::string* value : m_strings) {
+            this->writeVarint(value->size());
+            m_tree.insert(m_tree.end(), value->begin(), value->end());
+        }
+
+        std::vector<unsigned char> strings;
+        m_tree.swap(strings);
+
+        BinaryArchive::Header header = {};
+        std::memcpy(header.Magic, BinaryArchive::c_Magic, sizeof(header.Magic));
+        header.Version = BinaryArchive::c_FormatVersion;
+        header.Type = type;
+
+        std::vector<unsigned char> result;
+        result.reserve(sizeof(header) + strings.size() + tree.size());
+        result.insert(result.end(), reinterpret_cast<const unsigned char*>(&header),
+                      reinterpret_cast<const unsigned char*>(&header) + sizeof(header));
+        result.insert(result.end(), strings.begin(), strings.end());
+        result.insert(result.end(), tree.begin(), tree.end());
+        return result;
+    }
+
+protected:
+    /**
+     * @brief Inserts a varint at the specified position of the tree, used for counts that are only known afterwards
+     */
+    void insertVarint(size_t position, uint64_t value) {
+        unsigned char bytes[10];
+        size_t count = 0;
+        while (value >= 0x80) {
+            bytes[count++] = static_cast<unsigned char>(value | 0x80);
+            value >>= 7;
+        }
+        bytes[count++] = static_cast<unsigned char>(value);
+        m_tree.insert(m_tree.begin() + position, bytes, bytes + count);
+    }
+
+protected:
+    std::vector<unsigned char> m_tree;
+    std::unordered_map<std::string, size_t> m_stringIndices;
+    std::vector<const std::string*> m_strings;
+};
+
+/**
+ * @brief Encodes YAML parser events straight into an archive, so text is converted without building a node tree
+ */
+class ArchiveEncoder final : public ArchiveWriter, public YAML::EventHandler {
+public:
+    bool failed() const {
+        return m_failed;
+    }
+
+    reflection::Type getType() const {
+        return m_type;
+    }
+
+    void OnDocumentStart(const YAML::Mark& mark) override {}
+
+    void OnDocumentEnd() override {}
+
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override {
+        this->beginNode(nullptr);
+        m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::NIL));
+    }
+
+    void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override {
+        // Serializers never emit anchors, the archive has no way to store them
+        m_failed = true;
+    }
+
+    void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, const std::string& value) override {
+        if (this->beginNode(&value)) {
+            // Root object type is stored in the header so it can be read without decoding
+            std::from_chars(value.data(), value.data() + value.size(), m_type);
+        }
+
+        m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::SCALAR));
+        this->writeString(value);
+    }
+
+    void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override {
+        this->beginNode(nullptr);
+        m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::SEQUENCE));
+        m_containers.push_back({m_tree.size(), 0, false});
+    }
+
+    void OnSequenceEnd() override {
+        this->endContainer();
+    }
+
+    void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor, YAML::EmitterStyle::value style) override {
+        this->beginNode(nullptr);
+        m_tree.push_back(static_cast<unsigned char>(BinaryArchive::Tag::MAP));
+        m_containers.push_back({m_tree.size(), 0, true});
+    }
+
+    void OnMapEnd() override {
+        this->endContainer();
+    }
+
+private:
+    /**
+     * @brief Open sequence or map, its child count is written once it ends
+     */
+    struct Container {
+        size_t Start;
+        uint64_t Children;
+        bool Map;
+    };
+
+    /**
+     * @brief Counts the node in its parent, returns true if the node is the value of the root Type key
+     * @param scalar Value of the node, nullptr if the node is not a scalar
+     */
+    bool beginNode(const std::string* scalar) {
+        if (m_containers.empty()) {
+            return false;
+        }
+
+        Container& parent = m_containers.back();
+        bool isType = false;
+        if (m_containers.size() == 1 && parent.Map) {
+            if (parent.Children % 2 == 0) {
+                m_rootKeyIsType = scalar != nullptr && *scalar == "Type";
+            } else {
+                isType = scalar != nullptr && m_rootKeyIsType;
+            }
+        }
+
+        parent.Children++;
+        return isType;
+    }
+
+    void endContainer() {
+        const Container container = m_containers.back();
+        m_containers.pop_back();
+
+        // Maps store the number of key value pairs, only the innermost open container is after Start so the insert
+        // moves its own children
+        this->insertVarint(container.Start, container.Map ? container.Children / 2 : container.Children);
+    }
+
+private:
+    std::vector<Container> m_containers;
+    bool m_rootKeyIsType = false;
+    reflection::Type m_type = c_InvalidHandle;
+    bool m_failed = false;
+};
+
+/**
+ * @brief Read only stream buffer over YAML text
+ */
+class TextBuffer final : public std::streambuf {
+public:
+    TextBuffer(const char* text, size_t size) {
+        char* begin = const_cast<char*>(text);
+        this->setg(begin, begin, begin + size);
+    }
+};
+
+/**
+ * @brief Helper for reading archives
+ */
+class ArchiveReader {
+public:
+    ArchiveReader(const unsigned char* data, size_t size) : m_data(data), m_end(data + size) {}
+
+    bool failed() const {
+        return m_failed;
+    }
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        int shift = 0;
+        while (m_data < m_end && shift < 64) {
+            const unsigned char byte = *m_data++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+            shift += 7;
+        }
+
+        m_failed = true;
+        return 0;
+    }
+
+    std::string readRaw() {
+        const uint64_t length = this->readVarint();
+        if (m_failed || static_cast<uint64_t>(m_end - m_data) < length) {
+            m_failed = true;
+            return "";
+        }
+
+        std::string value(reinterpret_cast<const char*>(m_data), static_cast<size_t>(length));
+        m_data += length;
+        return value;
+    }
+
+    bool readStrings() {
+        const uint64_t count = this->readVarint();
+        if (m_failed || count > static_cast<uint64_t>(m_end - m_data)) {
+            return false;
+        }
+
+        m_strings.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count && !m_failed; i++) {
+            m_strings.push_back(this->readRaw());
+        }
+
+        return !m_failed;
+    }
+
+    YAML::Node readNode() {
+        if (m_data >= m_end) {
+            m_failed = true;
+            return YAML::Node();
+        }
+
+        const BinaryArchive::Tag tag = static_cast<BinaryArchive::Tag>(*m_data++);
+        switch (tag) {
+        case BinaryArchive::Tag::SCALAR: {
+            const uint64_t index = this->readVarint();
+            if (m_failed || index >= m_strings.size()) {
+                m_failed = true;
+                return YAML::Node();
+            }
+            return YAML::Node(m_strings[static_cast<size_t>(index)]);
+        }
+        case BinaryArchive::Tag::SEQUENCE: {
+            YAML::Node node(YAML::NodeType::Sequence);
+            const uint64_t count = this->readVarint();
+            for (uint64_t i = 0; i < count && !m_failed; i++) {
+                node.push_back(this->readNode());
+            }
+            return node;
+        }
+        case BinaryArchive::Tag::MAP: {
+            YAML::Node node(YAML::NodeType::Map);
+            const uint64_t count = this->readVarint();
+            for (uint64_t i = 0; i < count && !m_failed; i++) {
+                YAML::Node key = this->readNode();
+                YAML::Node value = this->readNode();
+
+                // Keys are unique by construction, skip the lookup operator[] would do
+                node.force_insert(key, value);
+            }
+            return node;
+        }
+        case BinaryArchive::Tag::NIL: {
+            return YAML::Node(YAML::NodeType::Null);
+        }
+        default: {
+            m_failed = true;
+            return YAML::Node();
+        }
+        }
+    }
+
+private:
+    const unsigned char* m_data = nullptr;
+    const unsigned char* m_end = nullptr;
+    bool m_failed = false;
+    std::vector<std::string> m_strings;
+};
+
+} // namespace
+
+bool BinaryArchive::isBinary(const unsigned char* data, size_t size) {
+    return data != nullptr && size >= sizeof(Header) && std::memcmp(data, c_Magic, sizeof(c_Magic)) == 0;
+}
+
+std::vector<unsigned char> BinaryArchive::write(const YAML::Node& document) {
+    reflection::Type type = c_InvalidHandle;
+    if (document.IsMap() && document["Type"]) {
+        type = document["Type"].as<reflection::Type>();
+    }
+
+    ArchiveWriter writer;
+    writer.writeNode(document);
+    return writer.finish(type);
+}
+
+YAML::Node BinaryArchive::read(const unsigned char* data, size_t size) {
+    if (!isBinary(data, size)) {
+        LOG_ERROR("[IO] Tried to read data that is not a binary archive");
+        return YAML::Node();
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.Version != c_FormatVersion) {
+        LOG_ERROR("[IO] Unsupported binary archive version {0}", header.Version);
+        return YAML::Node();
+    }
+
+    ArchiveReader reader(data + sizeof(Header), size - sizeof(Header));
+    const std::string version = reader.readRaw();
+    if (version != c_CurrentVersion) {
+        LOG_WARN("[IO] Binary archive was written with serializer version {0}, current is {1}", version, c_CurrentVersion);
+    }
+
+    if (!reader.readStrings()) {
+        LOG_ERROR("[IO] Corrupted binary archive string table");
+        return YAML::Node();
+    }
+
+    YAML::Node document = reader.readNode();
+    if (reader.failed()) {
+        LOG_ERROR("[IO] Corrupted binary archive node tree");
+        return YAML::Node();
+    }
+
+    return document;
+}
+
+reflection::Type BinaryArchive::readType(const unsigned char* data, size_t size) {
+    if (!isBinary(data, size)) {
+        return c_InvalidHandle;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    return static_cast<reflection::Type>(header.Type);
+}
+
+std::vector<unsigned char> BinaryArchive::convert(const std::string& text) {
+    return convert(text.data(), text.size());
+}
+
+std::vector<unsigned char> BinaryArchive::convert(const char* text, size_t size) {
+    TextBuffer buffer(text, size);
+    std::istream stream(&buffer);
+    YAML::Parser parser(stream);
+
+    ArchiveEncoder encoder;
+    if (!parser.HandleNextDocument(encoder)) {
+        // Empty text is a null document
+        encoder.OnNull(YAML::Mark::null_mark(), YAML::NullAnchor);
+    }
+
+    if (encoder.failed()) {
+        LOG_ERROR("[IO] Document contains aliases which binary archives can't store");
+        return {};
+    }
+
+    return encoder.finish(encoder.getType());
+}
+
+} // namespace io
+} // namespace aderite
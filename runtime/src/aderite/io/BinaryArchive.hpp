@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "aderite/Handles.hpp"
+
+namespace aderite {
+namespace io {
+
+/**
+ * @brief Compact binary encoding of serialized documents, used instead of YAML text for shipping builds.
+ * Every ISerializable still reads and writes YAML nodes, the archive only replaces the text representation
+ * so the costly YAML scanner and parser are skipped when loading.
+ *
+ * Layout:
+ * Header (magic, format version, root reflection::Type)
+ * Serializer version string (io::c_CurrentVersion at the time of writing)
+ * String table, every key and scalar is stored once
+ * Node tree, each node is a tag byte followed by string indices or child counts
+ */
+class BinaryArchive final {
+public:
+    static constexpr char c_Magic[4] = {'A', 'B', 'I', 'N'};
+    static constexpr uint32_t c_FormatVersion = 1;
+
+    /**
+     * @brief Node tags
+     */
+    enum class Tag : uint8_t {
+        NIL = 0,
+        SCALAR = 1,
+        SEQUENCE = 2,
+        MAP = 3,
+    };
+
+    /**
+     * @brief Archive header
+     */
+    struct Header {
+        char Magic[4];
+        uint32_t Version;
+        uint64_t Type; // reflection::Type of the root object, c_InvalidHandle if the root is not an object
+    };
+
+public:
+    /**
+     * @brief Returns true if the data starts with a binary archive header
+     * @param data Data to check
+     * @param size Size of the data
+     */
+    static bool isBinary(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Encodes a document into a binary archive
+     * @param document Document to encode
+     * @return Encoded archive
+     */
+    static std::vector<unsigned char> write(const YAML::Node& document);
+
+    /**
+     * @brief Decodes a binary archive
+     * @param data Archive data
+     * @param size Size of the archive
+     * @return Decoded document, null node if the archive is invalid
+     */
+    static YAML::Node read(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Returns the reflection type of the archive root object without decoding the document
+     * @param data Archive data
+     * @param size Size of the archive
+     * @return Type or c_InvalidHandle
+     */
+    static reflection::Type readType(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Converts a YAML text document into a binary archive
+     * @param text YAML text
+     * @return Encoded archive
+     */
+    static std::vector<unsigned char> convert(const std::string& text);
+
+    /**
+     * @brief Converts a YAML text document into a binary archive, parser events are encoded directly so no node tree
+     * is built
+     * @param text YAML text
+     * @param size Size of the text
+     * @return Encoded archive, empty if the document can't be stored
+     */
+    static std::vector<unsigned char> convert(const char* text, size_t size);
+};
+
+} // namespace io
+} // namespace aderite
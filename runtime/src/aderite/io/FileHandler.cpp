@@ -13,44 +13,64 @@ DataChunk::DataChunk(size_t offset, size_t size, std::string name, std::vector<u
     Name(name),
     Data(std::move(data)) {}
 
-DataChunk FileHandler::openSerializable(SerializableHandle handle) const {
-    LOG_TRACE("[IO] Opening serializable {0}", handle);
-    const std::filesystem::path path = m_rootDir / "Asset" / (std::to_string(handle) + ".asset");
+DataChunk::DataChunk(std::string name, const unsigned char* view, size_t size) :
+    Offset(0),
+    OriginalSize(size),
+    Name(name),
+    m_view(view) {}
+
+const unsigned char* DataChunk::data() const {
+    return this->isView() ? m_view : Data.data();
+}
+
+size_t DataChunk::size() const {
+    return this->isView() ? OriginalSize : Data.size();
+}
 
-    if (!std::filesystem::exists(path)) {
-        return DataChunk(0, 0, ("Asset/" + std::to_string(handle) + ".asset").c_str(), {});
+bool DataChunk::isView() const {
+    // Writing Data replaces the viewed contents
+    return m_view != nullptr && Data.empty();
+}
+
+FileHandler::FileHandler() : m_archive(std::make_unique<PackedArchive>()) {}
+
+FileHandler::~FileHandler() {}
+
+DataChunk FileHandler::open(PackedArchive::EntryKind kind, HandleType handle, const std::string& name) const {
+    // Loose files first, the editor writes to them after a project was packed
+    const std::filesystem::path path = m_rootDir / name;
+    if (std::filesystem::exists(path)) {
+        std::ifstream in(path, std::ios::binary);
+        size_t offset = 0;
+        size_t size = in.seekg(0, std::ios::end).tellg();
+        in.seekg(0, std::ios::beg);
+        std::vector<unsigned char> data;
+        data.resize(size);
+        in.read(reinterpret_cast<char*>(data.data()), data.size());
+        return DataChunk(offset, size, name, std::move(data));
     }
 
-    std::ifstream in(path, std::ios::binary);
-    size_t offset = 0;
-    size_t size = in.seekg(0, std::ios::end).tellg();
-    in.seekg(0, std::ios::beg);
-    std::vector<unsigned char> data;
-    data.resize(size);
-    in.read(reinterpret_cast<char*>(data.data()), data.size());
-    data.push_back('\0');
+    size_t viewSize = 0;
+    const unsigned char* view = m_archive->find(kind, handle, viewSize);
+    if (view != nullptr) {
+        return DataChunk(name, view, viewSize);
+    }
+
+    return DataChunk(0, 0, name, {});
+}
+
+DataChunk FileHandler::openSerializable(SerializableHandle handle) const {
+    LOG_TRACE("[IO] Opening serializable {0}", handle);
+    DataChunk chunk = this->open(PackedArchive::EntryKind::SERIALIZABLE, handle, "Asset/" + std::to_string(handle) + ".asset");
     LOG_INFO("[IO] Serializable {0} opened and loaded", handle);
-    return DataChunk(offset, size, ("Asset/" + std::to_string(handle) + ".asset").c_str(), data);
+    return chunk;
 }
 
 DataChunk FileHandler::openReservedLoadable(LoadableHandle handle) const {
     LOG_TRACE("[IO] Opening RESERVED loadable {0}", handle);
-    const std::filesystem::path path = m_rootDir / "Data" / ("_" + std::to_string(handle) + ".data");
-
-    if (!std::filesystem::exists(path)) {
-        return DataChunk(0, 0, ("Data/_" + std::to_string(handle) + ".data").c_str(), {});
-    }
-
-    std::ifstream in(path, std::ios::binary);
-    size_t offset = 0;
-    size_t size = in.seekg(0, std::ios::end).tellg();
-    in.seekg(0, std::ios::beg);
-    std::vector<unsigned char> data;
-    data.resize(size);
-    in.read(reinterpret_cast<char*>(data.data()), data.size());
-    data.push_back('\0');
+    DataChunk chunk = this->open(PackedArchive::EntryKind::RESERVED, handle, "Data/_" + std::to_string(handle) + ".data");
     LOG_INFO("[IO] Reserved loadable {0} opened and loaded", handle);
-    return DataChunk(offset, size, ("Data/_" + std::to_string(handle) + ".data").c_str(), data);
+    return chunk;
 }
 
 std::filesystem::path FileHandler::pathToReserved(LoadableHandle handle) const {
@@ -59,40 +79,36 @@ std::filesystem::path FileHandler::pathToReserved(LoadableHandle handle) const {
 
 DataChunk FileHandler::openLoadable(SerializableHandle handle) const {
     LOG_TRACE("[IO] Opening loadable {0}", handle);
-    const std::filesystem::path path = m_rootDir / "Data" / (std::to_string(handle) + ".data");
-
-    if (!std::filesystem::exists(path)) {
-        return DataChunk(0, 0, ("Data/" + std::to_string(handle) + ".data").c_str(), {});
-    }
-
-    std::ifstream in(path, std::ios::binary);
-    size_t offset = 0;
-    size_t size = in.seekg(0, std::ios::end).tellg();
-    in.seekg(0, std::ios::beg);
-    std::vector<unsigned char> data;
-    data.resize(size);
-    in.read(reinterpret_cast<char*>(data.data()), data.size());
-    data.push_back('\0');
+    DataChunk chunk = this->open(PackedArchive::EntryKind::LOADABLE, handle, "Data/" + std::to_string(handle) + ".data");
     LOG_INFO("[IO] Loadable {0} opened and loaded", handle);
-    return DataChunk(offset, size, ("Data/" + std::to_string(handle) + ".data").c_str(), data);
+    return chunk;
 }
 
 void FileHandler::commit(const DataChunk& chunk) const {
-    LOG_TRACE("[IO] Commiting chunk of size {0}(Was: {3}) to {1} at offset {2}", chunk.Data.size(), chunk.Name, chunk.Offset,
+    LOG_TRACE("[IO] Commiting chunk of size {0}(Was: {3}) to {1} at offset {2}", chunk.size(), chunk.Name, chunk.Offset,
               chunk.OriginalSize);
 
     // TODO: Resize and move depending on size change
     std::filesystem::path outPath = m_rootDir / std::string(chunk.Name);
     std::ofstream of(outPath, std::ios::binary);
     of.seekp(chunk.Offset);
-    of.write(reinterpret_cast<const char*>(chunk.Data.data()), chunk.Data.size());
+    // Chunks served from the packed archive that weren't written to are copied out of the mapping
+    of.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
     LOG_INFO("[IO] Chunk {0} commited", chunk.Name);
 }
 
 void FileHandler::setRoot(const std::filesystem::path& root) {
     LOG_TRACE("[IO] Setting root to {0}", root.string());
-    ADERITE_DYNAMIC_ASSERT(std::filesystem::exists(root / "Asset/"), "Asset directory doesn't exist in root");
-    ADERITE_DYNAMIC_ASSERT(std::filesystem::exists(root / "Data/"), "Data directory doesn't exist in root");
+    m_archive->close();
+
+    const std::filesystem::path archivePath = root / PackedArchive::c_DefaultName;
+    if (std::filesystem::exists(archivePath)) {
+        m_archive->open(archivePath);
+    } else {
+        ADERITE_DYNAMIC_ASSERT(std::filesystem::exists(root / "Asset/"), "Asset directory doesn't exist in root");
+        ADERITE_DYNAMIC_ASSERT(std::filesystem::exists(root / "Data/"), "Data directory doesn't exist in root");
+    }
+
     m_rootDir = root;
 }
 
@@ -117,11 +133,12 @@ bool FileHandler::exists(LoadableHandle handle) const {
     ADERITE_DYNAMIC_ASSERT(handle != c_InvalidHandle, "Invalid handle passed to exists");
     const std::filesystem::path path = m_rootDir / "Data" / (std::to_string(handle) + ".data");
 
-    if (!std::filesystem::exists(path)) {
-        return false;
+    if (std::filesystem::exists(path)) {
+        return true;
     }
 
-    return true;
+    size_t size = 0;
+    return m_archive->find(PackedArchive::EntryKind::LOADABLE, handle, size) != nullptr;
 }
 
 } // namespace io
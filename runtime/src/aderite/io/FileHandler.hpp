@@ -1,20 +1,48 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "aderite/Handles.hpp"
+#include "aderite/io/PackedArchive.hpp"
 
 namespace aderite {
 namespace io {
 
 /**
- * @brief DataChunk is a piece of memory that the file handler works with
+ * @brief DataChunk is a piece of memory that the file handler works with. A chunk either owns its Data or is a
+ * read only view into a packed archive, use data() and size() when only reading.
  */
 class DataChunk {
 public:
     DataChunk(size_t offset, size_t size, std::string name, std::vector<unsigned char> data);
 
-    // Data of the chunk
+    /**
+     * @brief Creates a read only view chunk
+     * @param name Name of the data chunk
+     * @param view Pointer to the viewed memory, must outlive the chunk
+     * @param size Size of the viewed memory
+     */
+    DataChunk(std::string name, const unsigned char* view, size_t size);
+
+    /**
+     * @brief Returns the chunk contents
+     */
+    const unsigned char* data() const;
+
+    /**
+     * @brief Returns the size of the chunk contents, the same for loose files and packed archive views
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns true if the chunk is a view into a packed archive, writing Data turns it into an owned chunk
+     */
+    bool isView() const;
+
+    // Data of the chunk, empty if the chunk is a view
     std::vector<unsigned char> Data;
 
     // Offset from start of file
@@ -25,10 +53,15 @@ public:
 
     // Name of the data chunk
     std::string Name;
+
+private:
+    const unsigned char* m_view = nullptr;
 };
 
 /**
- * @brief Class that is responsible for reading and writing to device memory
+ * @brief Class that is responsible for reading and writing to device memory. If the root contains a packed
+ * archive, files that don't exist on disk are served from the archive. Loose files always take precedence so
+ * writes made after packing are read back.
  */
 class FileHandler final {
 public:
@@ -44,6 +77,9 @@ public:
     };
 
 public:
+    FileHandler();
+    ~FileHandler();
+
     /**
      * @brief Resolves the handle file and chunk, loads it and returns it
      * @param handle Handle to read
@@ -96,8 +132,19 @@ public:
     */
     bool exists(LoadableHandle handle) const;
 
+private:
+    /**
+     * @brief Returns a chunk for the specified file, first looking on disk then in the packed archive
+     * @param kind Archive entry kind
+     * @param handle Handle of the entry
+     * @param name Name of the file relative to root
+     * @return DataChunk instance, empty if not found
+     */
+    DataChunk open(PackedArchive::EntryKind kind, HandleType handle, const std::string& name) const;
+
 private:
     std::filesystem::path m_rootDir;
+    std::unique_ptr<PackedArchive> m_archive;
 };
 
 } // namespace io
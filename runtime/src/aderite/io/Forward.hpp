@@ -10,7 +10,10 @@
 namespace aderite {
 namespace io {
 
+class BinaryArchive;
+class DataChunk;
 class FileHandler;
+class PackedArchive;
 
 class ISerializable;
 class SerializableAsset;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "aderite/io/Forward.hpp"
 
 namespace aderite {
@@ -31,6 +33,9 @@ public:
 private:
     friend class Loader;
     friend class LoaderPool;
+
+    // True while the loadable is queued or being loaded by the LoaderPool
+    std::atomic<bool> m_queued {false};
 };
 
 } // namespace io
@@ -1,44 +1,30 @@
 #pragma once
 
-#include <condition_variable>
 #include <filesystem>
 #include <memory>
-#include <mutex>
-#include <thread>
+#include <string>
+#include <vector>
 
 #include "aderite/io/Forward.hpp"
+#include "aderite/io/MeshCooker.hpp"
+#include "aderite/io/TextureCooker.hpp"
 
 namespace aderite {
 namespace io {
 
 /**
- * @brief A general purpose data loader, each loader runs on it's own thread
+ * @brief A general purpose data loader, a loader is used by a single job system worker at a time
  */
 class Loader final {
-public: // Thread handling
-    Loader(LoaderPool* pool);
+public:
+    Loader();
     ~Loader();
 
-    /**
-     * @brief Start the worker thread
-     */
-    void startup();
-
-    /**
-     * @brief Terminate the worker thread
-     */
-    void terminate();
-
     /**
      * @brief Returns the current loadable of the loader
      */
     ILoadable* current() const;
 
-    /**
-     * @brief Returns true if the loader instance is ready to load
-     */
-    bool isReady() const;
-
 public: // Loading operations
     struct LoadResult {
     public:
@@ -61,14 +47,32 @@ public: // Loading operations
         std::unique_ptr<T> Data;
     };
 
+    struct CookedTextureLoadResult : public LoadResult {
+        // Cooked texture data, the view points into it, it has to stay alive until the GPU upload is done
+        std::shared_ptr<const DataChunk> Source;
+        TextureCooker::View Texture;
+    };
+
     struct MeshLoadResult : public LoadResult {
-        std::vector<float> Vertices;
-        std::vector<unsigned int> Indices;
+        // Cooked mesh data, the view points into it, it has to stay alive until the GPU upload is done
+        std::shared_ptr<const DataChunk> Source;
+        MeshCooker::View Mesh;
     };
 
+    /**
+     * @brief Shader chunks that contain variants start with this value followed by size prefixed vertex, fragment, depth
+     * vertex and depth fragment binaries. Older chunks start with the vertex shader size followed by the vertex and
+     * fragment shaders.
+     */
+    static constexpr std::uint64_t c_ShaderVariantsMagic = 0x31544e4156524441; // "ADRVANT1"
+
     struct ShaderLoadResult : public LoadResult {
         std::vector<unsigned char> VertexSource;
         std::vector<unsigned char> FragmentSource;
+
+        // Position only variant used for the depth prepass, empty if the shader has none
+        std::vector<unsigned char> DepthVertexSource;
+        std::vector<unsigned char> DepthFragmentSource;
     };
 
     struct BinaryLoadResult : public LoadResult {
@@ -76,18 +80,19 @@ public: // Loading operations
     };
 
     /**
-     * @brief Loads a mesh from specified file
+     * @brief Loads a mesh from specified file, meshes that weren't cooked at import time are cooked in memory
      * @param handle Loadable handle
      * @return MeshLoadResult object
      */
     MeshLoadResult loadMesh(LoadableHandle handle) const;
 
     /**
-     * @brief Loads a texture from specified file
+     * @brief Loads a texture from specified file, textures that weren't cooked at import time are cooked in memory
+     * without compression
      * @param handle Loadable handle
-     * @return ImageLoadResult object
+     * @return CookedTextureLoadResult object
      */
-    TextureLoadResult<unsigned char> loadTexture(LoadableHandle handle) const;
+    CookedTextureLoadResult loadTexture(LoadableHandle handle) const;
 
     /**
      * @brief Loads a HDR texture from specified file
@@ -111,11 +116,15 @@ public: // Loading operations
     BinaryLoadResult loadBinary(LoadableHandle handle) const;
 
 private:
-    LoaderPool* m_pool;
-    std::thread m_thread;
-    bool m_terminated = false;
-    bool m_ready = false;
+    /**
+     * @brief Loads the loadable using this loader
+     * @param loadable Loadable to load
+     */
+    void load(ILoadable* loadable);
 
+    friend class LoaderPool;
+
+private:
     class LoaderImpl;
     LoaderImpl* m_impl = nullptr;
 };
@@ -1,7 +1,10 @@
 #include "LoaderPool.hpp"
 
+#include <thread>
+
 #include "aderite/io/ILoadable.hpp"
 #include "aderite/io/Loader.hpp"
+#include "aderite/threading/JobSystem.hpp"
 #include "aderite/utility/Log.hpp"
 #include "aderite/utility/LogExtensions.hpp"
 #include "aderite/utility/Macros.hpp"
@@ -9,23 +12,14 @@
 namespace aderite {
 namespace io {
 
-LoaderPool::LoaderPool() : LoaderPool(std::thread::hardware_concurrency()) {}
-
-LoaderPool::LoaderPool(size_t threadCount) {
+LoaderPool::LoaderPool(threading::JobSystem* jobSystem) : m_jobSystem(jobSystem) {
     ADERITE_LOG_BLOCK;
-    ADERITE_DYNAMIC_ASSERT(threadCount > 0, "Loader with 0 threads is prohibited");
-    LOG_DEBUG("[IO] Loader pool is created with {0} threads", threadCount);
-    for (size_t i = 0; i < threadCount; i++) {
-        m_loaders.push_back(new Loader(this));
-        m_loaders[i]->startup();
-    }
+    ADERITE_DYNAMIC_ASSERT(jobSystem != nullptr, "Loader pool created without a job system");
+    LOG_DEBUG("[IO] Loader pool is created with {0} loaders", jobSystem->getWorkerCount());
 
-    // Wait until all loaders are ready
-    LOG_TRACE("[IO] Waiting for all loaders to spin up");
-    for (Loader* loader : m_loaders) {
-        // Shouldn't take long so no need to complicate the logic
-        while (!loader->isReady()) {
-        }
+    // Assimp importers are not thread safe, so every worker gets its own loader
+    for (size_t i = 0; i < jobSystem->getWorkerCount() + 1; i++) {
+        m_loaders.push_back(new Loader());
     }
 
     LOG_INFO("[IO] Loader pool created and initialized");
@@ -36,13 +30,12 @@ LoaderPool::~LoaderPool() {
     LOG_TRACE("[IO] Loader pool is shutting down");
     m_terminated = true;
 
-    for (size_t i = 0; i < m_loaders.size(); i++) {
-        LOG_TRACE("[IO] Terminating loader {0}", i);
-        m_loaders[i]->terminate();
+    // Queued loads will be skipped, wait for the ones that already started
+    LOG_TRACE("[IO] Waiting for {0} outstanding loads", m_inFlight.load());
+    while (m_inFlight.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
     }
 
-    m_cvAdded.notify_all();
-
     for (size_t i = 0; i < m_loaders.size(); i++) {
         delete m_loaders[i];
     }
@@ -53,77 +46,44 @@ LoaderPool::~LoaderPool() {
 }
 
 void LoaderPool::enqueue(ILoadable* loadable, Priority priority) {
-    std::unique_lock<std::mutex> lock(m_lock);
-
-    if (this->isLoading(loadable)) {
-        // Already being loaded
-        return;
-    }
+    ADERITE_STATIC_ASSERT(static_cast<int>(Priority::HIGH) == static_cast<int>(threading::Job::Priority::HIGH),
+                          "LoaderPool and Job priorities must match");
 
     if (!loadable->needsLoading()) {
         // Doesn't need to be loaded
         return;
     }
 
-    LOG_TRACE("[IO] Loadable enqueued");
-
-    switch (priority) {
-    case Priority::LOW: {
-        // At the back of the queue
-        m_queue.insert(m_queue.end(), loadable);
-        break;
-    }
-    case Priority::NORMAL: {
-        // Middle
-        m_queue.insert(m_queue.begin() + m_highEnd, loadable);
-        break;
-    }
-    case Priority::HIGH: {
-        // Front
-        m_highEnd++;
-        m_queue.insert(m_queue.begin(), loadable);
-    }
-    }
-
-    m_cvAdded.notify_one();
-}
-
-ILoadable* LoaderPool::getNextLoadable() {
-    std::unique_lock<std::mutex> latch(m_lock);
-    m_cvAdded.wait(latch, [this]() {
-        return m_terminated || !m_queue.empty();
-    });
-
-    if (m_terminated) {
-        return nullptr;
-    }
-
-    ILoadable* loadable = m_queue.front();
-    m_queue.erase(m_queue.begin());
-    if (m_highEnd > 0) {
-        m_highEnd--;
+    bool expected = false;
+    if (!loadable->m_queued.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        // Already being loaded
+        return;
     }
 
-    LOG_TRACE("[IO] Loadable popped");
-    ADERITE_DYNAMIC_ASSERT(loadable != nullptr, "Nullptr loadable being passed from a pool that is not terminated");
-    return loadable;
+    LOG_TRACE("[IO] Loadable enqueued");
+    m_inFlight.fetch_add(1, std::memory_order_acq_rel);
+    m_jobSystem->schedule(
+        [this, loadable]() {
+            this->load(loadable);
+        },
+        static_cast<threading::Job::Priority>(priority));
 }
 
-bool LoaderPool::isLoading(ILoadable* loadable) const {
-    auto it = std::find(m_queue.begin(), m_queue.end(), loadable);
-
-    if (it == m_queue.end()) {
-        // Check if loader is currently loading it
-        for (Loader* l : m_loaders) {
-            if (l->current() == loadable) {
-                return true;
-            }
+void LoaderPool::load(ILoadable* loadable) {
+    if (!m_terminated.load(std::memory_order_acquire)) {
+        LOG_TRACE("[IO] Loadable popped");
+        const size_t worker = threading::JobSystem::getCurrentWorkerIndex();
+        if (worker < m_loaders.size() - 1) {
+            m_loaders[worker]->load(loadable);
+        } else {
+            // Executed by a thread that helps out while waiting
+            std::unique_lock<std::mutex> lock(m_sharedLoaderLock);
+            m_loaders.back()->load(loadable);
         }
-
-        return false;
     }
 
-    return true;
+    loadable->m_queued.store(false, std::memory_order_release);
+    m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
 }
 
 } // namespace io
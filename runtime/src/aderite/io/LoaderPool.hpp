@@ -1,22 +1,23 @@
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
 #include <mutex>
-#include <queue>
 #include <vector>
 
 #include "aderite/io/Forward.hpp"
+#include "aderite/threading/Forward.hpp"
 
 namespace aderite {
 namespace io {
 
 /**
- * @brief Loader pool used to handle asset loading and managing loader instances
+ * @brief Loader pool used to handle asset loading and managing loader instances, the actual loading
+ * is executed by the engine job system
  */
 class LoaderPool final {
 public:
     /**
-     * @brief Priority of loading
+     * @brief Priority of loading, maps directly to threading::Job::Priority
      */
     enum class Priority {
         LOW = 0,
@@ -26,18 +27,13 @@ public:
 
 public:
     /**
-     * Creates a LoaderPool with max amount of threads that are allowed by the system
+     * Creates a LoaderPool that submits loads to the specified job system
+     * @param jobSystem Job system that executes the loads
      */
-    LoaderPool();
+    LoaderPool(threading::JobSystem* jobSystem);
 
     /**
-     * Creates a LoaderPool with specified thread count
-     * @param threadCount The amount of threads inside the pool
-     */
-    LoaderPool(size_t threadCount);
-
-    /**
-     * Waits for all threads to finish and then cleans up
+     * Waits for all outstanding loads to finish and then cleans up
      */
     ~LoaderPool();
 
@@ -50,26 +46,20 @@ public:
 
 private:
     /**
-     * @brief Returns the next loadable instance that needs loading
-     */
-    ILoadable* getNextLoadable();
-
-    /**
-     * @brief Returns true if the specified loadable is already in load queue, false otherwise
-     * @param loadable Loadable to check
+     * @brief Loads the loadable on the calling job worker
+     * @param loadable Loadable to load
      */
-    bool isLoading(ILoadable* loadable) const;
-
-    friend class Loader;
+    void load(ILoadable* loadable);
 
 private:
+    threading::JobSystem* m_jobSystem = nullptr;
+
+    // One loader per job worker, the last one is shared by threads that are not workers
     std::vector<Loader*> m_loaders;
-    std::mutex m_lock;
-    std::condition_variable m_cvAdded;
-    bool m_terminated = false;
+    std::mutex m_sharedLoaderLock;
 
-    size_t m_highEnd = 0;
-    std::vector<ILoadable*> m_queue;
+    std::atomic<size_t> m_inFlight {0};
+    std::atomic<bool> m_terminated {false};
 };
 
 } // namespace io
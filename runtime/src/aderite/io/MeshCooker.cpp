@@ -0,0 +1,487 @@
+#include "MeshCooker.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <glm/glm.hpp>
+
+#include "aderite/utility/Log.hpp"
+
+namespace aderite {
+namespace io {
+
+class MeshCooker::CookerImpl {
+public:
+    Assimp::Importer Importer;
+};
+
+MeshCooker::MeshCooker() : m_impl(new CookerImpl()) {}
+
+MeshCooker::~MeshCooker() {
+    delete m_impl;
+}
+
+bool MeshCooker::cook(const unsigned char* data, size_t size, const std::string& hint, std::vector<unsigned char>& output,
+                      std::string& error) {
+    unsigned int flags = 0;
+
+    // Default flags
+    flags = aiProcessPreset_TargetRealtime_Quality |                     // some optimizations and safety checks
+            aiProcess_OptimizeMeshes |                                   // minimize number of meshes
+            aiProcess_PreTransformVertices |                             // apply node matrices
+            aiProcess_FixInfacingNormals | aiProcess_TransformUVCoords | // apply UV transformations
+            // aiProcess_FlipWindingOrder   | // we cull clock-wise, keep the default CCW winding order
+            aiProcess_MakeLeftHanded | // we set GLM_FORCE_LEFT_HANDED and use left-handed bx matrix functions
+            aiProcess_FlipUVs |
+            // aiProcess_GenNormals |
+            0;
+
+    const aiScene* scene = m_impl->Importer.ReadFileFromMemory(data, size, flags, hint.c_str());
+
+    // Sanity checks
+    if (scene == nullptr) {
+        error = m_impl->Importer.GetErrorString();
+        return false;
+    }
+
+    if (scene->mNumMeshes > 1) {
+        error = "File contains more than 1 mesh";
+        return false;
+    }
+
+    if (scene->mNumMeshes == 0) {
+        error = "File contains no meshes";
+        return false;
+    }
+
+    // There should only be one mesh
+    const aiMesh* mesh = scene->mMeshes[0];
+
+    std::vector<float> vertices(static_cast<size_t>(mesh->mNumVertices) * (c_VertexStride / sizeof(float)));
+    float* vertex = vertices.data();
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+        // Position
+        *vertex++ = mesh->mVertices[i].x;
+        *vertex++ = mesh->mVertices[i].y;
+        *vertex++ = mesh->mVertices[i].z;
+
+        // Normal
+        *vertex++ = mesh->HasNormals() ? mesh->mNormals[i].x : 0.0f;
+        *vertex++ = mesh->HasNormals() ? mesh->mNormals[i].y : 0.0f;
+        *vertex++ = mesh->HasNormals() ? mesh->mNormals[i].z : 0.0f;
+
+        // UV
+        *vertex++ = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0][i].x : 0.0f;
+        *vertex++ = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0][i].y : 0.0f;
+    }
+
+    std::vector<uint32_t> indices;
+    indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+        const aiFace& face = mesh->mFaces[i];
+        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    }
+
+    cook(vertices, indices, output);
+    return true;
+}
+
+void MeshCooker::cook(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, std::vector<unsigned char>& output) {
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size() * sizeof(float) / c_VertexStride);
+    const bool index32 = vertexCount > 0xffff;
+
+    // Detail levels, each one is simplified from the previous level
+    LodTable lods = {};
+    lods.Count = 1;
+    lods.Lods[0] = {0, static_cast<uint32_t>(indices.size())};
+
+    std::vector<uint32_t> allIndices = indices;
+    std::vector<uint32_t> previous = indices;
+    std::vector<uint32_t> simplified;
+    while (lods.Count < c_MaxLods && previous.size() / 3 >= c_MinLodTriangles) {
+        simplify(vertices, previous, previous.size() / 6 * 3, simplified);
+
+        // Not worth a level if the mesh barely got simpler
+        if (simplified.size() * 5 > previous.size() * 4) {
+            break;
+        }
+
+        lods.Lods[lods.Count++] = {static_cast<uint32_t>(allIndices.size()), static_cast<uint32_t>(simplified.size())};
+        allIndices.insert(allIndices.end(), simplified.begin(), simplified.end());
+        previous.swap(simplified);
+    }
+
+    Header header = {};
+    std::memcpy(header.Magic, c_Magic, sizeof(c_Magic));
+    header.Version = c_FormatVersion;
+    header.VertexCount = vertexCount;
+    header.IndexCount = static_cast<uint32_t>(allIndices.size());
+    header.VertexStride = c_VertexStride;
+    header.IndexSize = index32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
+    const uint64_t vertexOffset = sizeof(Header) + sizeof(LodTable);
+    const uint64_t vertexSize = static_cast<uint64_t>(vertexCount) * c_VertexStride;
+    header.IndexOffset = (vertexOffset + vertexSize + c_Alignment - 1) & ~(c_Alignment - 1);
+
+    output.assign(static_cast<size_t>(header.IndexOffset + header.IndexSize * allIndices.size()), 0);
+    std::memcpy(output.data(), &header, sizeof(Header));
+    std::memcpy(output.data() + sizeof(Header), &lods, sizeof(LodTable));
+    std::memcpy(output.data() + vertexOffset, vertices.data(), static_cast<size_t>(vertexSize));
+
+    unsigned char* indexData = output.data() + header.IndexOffset;
+    if (index32) {
+        std::memcpy(indexData, allIndices.data(), allIndices.size() * sizeof(uint32_t));
+    } else {
+        uint16_t* index = reinterpret_cast<uint16_t*>(indexData);
+        for (uint32_t value : allIndices) {
+            *index++ = static_cast<uint16_t>(value);
+        }
+    }
+}
+
+/**
+ * @brief Symmetric 4x4 error quadric of a set of planes, the error of a point is the sum of its squared distances to
+ * the planes
+ */
+struct Quadric {
+    double A2 = 0.0, B2 = 0.0, C2 = 0.0, AB = 0.0, AC = 0.0, BC = 0.0, AD = 0.0, BD = 0.0, CD = 0.0, D2 = 0.0;
+
+    /**
+     * @brief Adds the plane through the point with the normal, weighted
+     */
+    void addPlane(const glm::dvec3& n, const glm::dvec3& point, double weight) {
+        const double d = -glm::dot(n, point);
+        A2 += weight * n.x * n.x;
+        B2 += weight * n.y * n.y;
+        C2 += weight * n.z * n.z;
+        AB += weight * n.x * n.y;
+        AC += weight * n.x * n.z;
+        BC += weight * n.y * n.z;
+        AD += weight * n.x * d;
+        BD += weight * n.y * d;
+        CD += weight * n.z * d;
+        D2 += weight * d * d;
+    }
+
+    Quadric& operator+=(const Quadric& o) {
+        A2 += o.A2;
+        B2 += o.B2;
+        C2 += o.C2;
+        AB += o.AB;
+        AC += o.AC;
+        BC += o.BC;
+        AD += o.AD;
+        BD += o.BD;
+        CD += o.CD;
+        D2 += o.D2;
+        return *this;
+    }
+
+    double evaluate(const glm::dvec3& p) const {
+        return A2 * p.x * p.x + B2 * p.y * p.y + C2 * p.z * p.z + 2.0 * (AB * p.x * p.y + AC * p.x * p.z + BC * p.y * p.z) +
+               2.0 * (AD * p.x + BD * p.y + CD * p.z) + D2;
+    }
+};
+
+/**
+ * @brief Cosine of the largest angle a triangle normal may turn by in a collapse
+ */
+static constexpr double c_MaxNormalTurn = 0.2;
+
+/**
+ * @brief Edge collapse candidate, From is moved onto To
+ */
+struct Collapse {
+    double Cost;
+    uint32_t From;
+    uint32_t To;
+};
+
+float MeshCooker::simplify(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount,
+                           std::vector<uint32_t>& output) {
+    const size_t floatsPerVertex = c_VertexStride / sizeof(float);
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size() / floatsPerVertex);
+    output = indices;
+    if (output.size() <= targetIndexCount || vertexCount == 0) {
+        return 0.0f;
+    }
+
+    std::vector<glm::dvec3> positions(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float* p = vertices.data() + static_cast<size_t>(i) * floatsPerVertex;
+        positions[i] = glm::dvec3(p[0], p[1], p[2]);
+    }
+
+    // Vertices with the same position are welded for topology, every index refers to the first of them
+    std::vector<uint32_t> weld(vertexCount);
+    std::vector<uint8_t> locked(vertexCount, 0);
+    std::unordered_map<uint64_t, uint32_t> byPosition;
+    byPosition.reserve(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float* p = vertices.data() + static_cast<size_t>(i) * floatsPerVertex;
+        uint32_t bits[3];
+        std::memcpy(bits, p, sizeof(bits));
+        const uint64_t key = (static_cast<uint64_t>(bits[0]) * 73856093u) ^ (static_cast<uint64_t>(bits[1]) * 19349663u << 16) ^
+                             (static_cast<uint64_t>(bits[2]) * 83492791u << 32);
+
+        auto it = byPosition.find(key);
+        if (it != byPosition.end() && positions[it->second] == positions[i]) {
+            // Seam, moving it would tear the mesh apart
+            weld[i] = it->second;
+            locked[it->second] = 1;
+        } else {
+            weld[i] = i;
+            byPosition.emplace(key, i);
+        }
+    }
+
+    // Topology works on welded indices, the output keeps the original ones
+    std::vector<uint32_t> topology(output.size());
+    for (size_t i = 0; i < output.size(); i++) {
+        topology[i] = weld[output[i]];
+    }
+
+    // Open edges are used by a single triangle
+    std::unordered_map<uint64_t, uint32_t> edgeUse;
+    edgeUse.reserve(output.size());
+    for (size_t t = 0; t < output.size(); t += 3) {
+        for (int e = 0; e < 3; e++) {
+            const uint32_t a = topology[t + e];
+            const uint32_t b = topology[t + (e + 1) % 3];
+            edgeUse[(static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b)]++;
+        }
+    }
+
+    for (const auto& kvp : edgeUse) {
+        if (kvp.second == 1) {
+            locked[kvp.first >> 32] = 1;
+            locked[kvp.first & 0xffffffff] = 1;
+        }
+    }
+
+    // Quadrics of the planes around every vertex, weighted by triangle area
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t t = 0; t < output.size(); t += 3) {
+        const glm::dvec3& p0 = positions[topology[t]];
+        const glm::dvec3 normal = glm::cross(positions[topology[t + 1]] - p0, positions[topology[t + 2]] - p0);
+        const double length = glm::length(normal);
+        if (length <= 0.0) {
+            continue;
+        }
+
+        Quadric q;
+        q.addPlane(normal / length, p0, length * 0.5);
+        for (int c = 0; c < 3; c++) {
+            quadrics[topology[t + c]] += q;
+        }
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> adjacencyFill;
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    double maxError = 0.0;
+
+    while (output.size() > targetIndexCount) {
+        // Triangles around every vertex
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : topology) {
+            adjacencyOffsets[index + 1]++;
+        }
+
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+        }
+
+        adjacency.resize(output.size());
+        adjacencyFill.assign(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < output.size(); i++) {
+            adjacency[adjacencyFill[topology[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Every edge in both directions, locked vertices only receive collapses
+        collapses.clear();
+        for (size_t t = 0; t < output.size(); t += 3) {
+            for (int e = 0; e < 3; e++) {
+                const uint32_t a = topology[t + e];
+                const uint32_t b = topology[t + (e + 1) % 3];
+                Quadric q = quadrics[a];
+                q += quadrics[b];
+
+                if (!locked[a]) {
+                    collapses.push_back({q.evaluate(positions[b]), a, b});
+                }
+
+                if (!locked[b]) {
+                    collapses.push_back({q.evaluate(positions[a]), b, a});
+                }
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) {
+            return l.Cost < r.Cost;
+        });
+
+        // Cheapest first, a vertex is changed at most once per pass so the flip test stays valid. Every collapse
+        // removes about two triangles.
+        const size_t budget = (output.size() - targetIndexCount) / 6 + 1;
+        size_t collapsed = 0;
+        std::fill(touched.begin(), touched.end(), 0);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            collapseTo[i] = i;
+        }
+
+        for (const Collapse& collapse : collapses) {
+            if (collapsed >= budget) {
+                break;
+            }
+
+            if (touched[collapse.From] || touched[collapse.To]) {
+                continue;
+            }
+
+            // Reject collapses that flip a remaining triangle
+            bool flips = false;
+            for (uint32_t a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1] && !flips; a++) {
+                const uint32_t* tri = &topology[static_cast<size_t>(adjacency[a]) * 3];
+                if (tri[0] == collapse.To || tri[1] == collapse.To || tri[2] == collapse.To) {
+                    // Removed by the collapse
+                    continue;
+                }
+
+                glm::dvec3 p[3];
+                for (int c = 0; c < 3; c++) {
+                    p[c] = positions[tri[c]];
+                }
+
+                const glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                for (int c = 0; c < 3; c++) {
+                    if (tri[c] == collapse.From) {
+                        p[c] = positions[collapse.To];
+                    }
+                }
+
+                // Normals turning by more than ~80 degrees count as flips too, they leave slivers standing on edge
+                const glm::dvec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                flips = glm::dot(before, after) <= c_MaxNormalTurn * glm::length(before) * glm::length(after);
+            }
+
+            if (flips) {
+                continue;
+            }
+
+            // Neighbours are frozen for the rest of the pass
+            for (uint32_t a = adjacencyOffsets[collapse.From]; a < adjacencyOffsets[collapse.From + 1]; a++) {
+                const uint32_t* tri = &topology[static_cast<size_t>(adjacency[a]) * 3];
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+            }
+
+            collapseTo[collapse.From] = collapse.To;
+            quadrics[collapse.To] += quadrics[collapse.From];
+            maxError = std::max(maxError, collapse.Cost);
+            collapsed++;
+        }
+
+        if (collapsed == 0) {
+            break;
+        }
+
+        // Apply and drop the triangles that became degenerate. Collapsed vertices are never seams, so the welded index
+        // of the target is a vertex with its position.
+        size_t write = 0;
+        for (size_t t = 0; t < topology.size(); t += 3) {
+            uint32_t welded[3];
+            for (int c = 0; c < 3; c++) {
+                welded[c] = collapseTo[topology[t + c]];
+            }
+
+            if (welded[0] == welded[1] || welded[1] == welded[2] || welded[0] == welded[2]) {
+                continue;
+            }
+
+            for (int c = 0; c < 3; c++) {
+                output[write + c] = welded[c] != topology[t + c] ? welded[c] : output[t + c];
+                topology[write + c] = welded[c];
+            }
+
+            write += 3;
+        }
+
+        output.resize(write);
+        topology.resize(write);
+    }
+
+    return static_cast<float>(maxError);
+}
+
+bool MeshCooker::isCooked(const unsigned char* data, size_t size) {
+    return data != nullptr && size >= sizeof(Header) && std::memcmp(data, c_Magic, sizeof(c_Magic)) == 0;
+}
+
+bool MeshCooker::read(const unsigned char* data, size_t size, View& view) {
+    if (!isCooked(data, size)) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.Version == 0 || header.Version > c_FormatVersion || header.VertexStride != c_VertexStride ||
+        (header.IndexSize != sizeof(uint16_t) && header.IndexSize != sizeof(uint32_t))) {
+        LOG_ERROR("[IO] Unsupported cooked mesh version {0}", header.Version);
+        return false;
+    }
+
+    // Version 1 meshes have a single level and no lod table
+    LodTable lods = {};
+    lods.Count = 1;
+    lods.Lods[0] = {0, header.IndexCount};
+    uint64_t vertexOffset = sizeof(Header);
+    if (header.Version >= 2) {
+        if (size < sizeof(Header) + sizeof(LodTable)) {
+            LOG_ERROR("[IO] Corrupted cooked mesh");
+            return false;
+        }
+
+        std::memcpy(&lods, data + sizeof(Header), sizeof(LodTable));
+        vertexOffset += sizeof(LodTable);
+    }
+
+    const uint64_t vertexSize = static_cast<uint64_t>(header.VertexCount) * header.VertexStride;
+    const uint64_t indexSize = static_cast<uint64_t>(header.IndexCount) * header.IndexSize;
+    if (vertexOffset + vertexSize > header.IndexOffset || header.IndexOffset + indexSize > size) {
+        LOG_ERROR("[IO] Corrupted cooked mesh");
+        return false;
+    }
+
+    if (lods.Count == 0 || lods.Count > c_MaxLods) {
+        LOG_ERROR("[IO] Corrupted cooked mesh lod table");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < lods.Count; i++) {
+        if (static_cast<uint64_t>(lods.Lods[i].FirstIndex) + lods.Lods[i].IndexCount > header.IndexCount) {
+            LOG_ERROR("[IO] Corrupted cooked mesh lod table");
+            return false;
+        }
+    }
+
+    view.Vertices = data + vertexOffset;
+    view.VertexSize = static_cast<uint32_t>(vertexSize);
+    view.Indices = data + header.IndexOffset;
+    view.IndexSize = static_cast<uint32_t>(indexSize);
+    view.VertexCount = header.VertexCount;
+    view.IndexCount = lods.Lods[0].IndexCount;
+    view.Index32 = header.IndexSize == sizeof(uint32_t);
+    view.LodCount = lods.Count;
+    std::memcpy(view.Lods, lods.Lods, sizeof(view.Lods));
+    return true;
+}
+
+} // namespace io
+} // namespace aderite
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aderite/io/Forward.hpp"
+
+namespace aderite {
+namespace io {
+
+/**
+ * @brief Converts source meshes (obj, fbx, etc.) into a GPU ready binary layout once at import time, so that the
+ * runtime doesn't have to run the Assimp pipeline every time a mesh is loaded.
+ *
+ * Layout:
+ * Header
+ * Lod table, since version 2
+ * Interleaved vertex data (position, normal, uv), matches the MeshAsset vertex layout
+ * Index data, 16 bit if the vertex count allows it otherwise 32 bit, starts at Header::IndexOffset
+ *
+ * Lower detail levels are generated at cook time with quadric error simplification. Every level indexes the same
+ * vertices and the index lists of all levels are stored one after another, full detail first.
+ */
+class MeshCooker final {
+public:
+    /**
+     * @brief Cooked mesh header
+     */
+    struct Header {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t VertexCount;
+        uint32_t IndexCount;
+        uint32_t VertexStride; // Bytes per vertex
+        uint32_t IndexSize;    // 2 or 4
+        uint64_t IndexOffset;  // From the start of the header
+    };
+
+    /**
+     * @brief Index range of a detail level
+     */
+    struct Lod {
+        uint32_t FirstIndex;
+        uint32_t IndexCount;
+    };
+
+    static constexpr uint32_t c_MaxLods = 4;
+
+    /**
+     * @brief Lod table, stored right after the header
+     */
+    struct LodTable {
+        uint32_t Count;
+        uint32_t Reserved;
+        Lod Lods[c_MaxLods];
+    };
+
+    /**
+     * @brief Pointers into a cooked mesh
+     */
+    struct View {
+        const unsigned char* Vertices = nullptr;
+        uint32_t VertexSize = 0;
+        const unsigned char* Indices = nullptr;
+        uint32_t IndexSize = 0;
+        uint32_t VertexCount = 0;
+        uint32_t IndexCount = 0; // Of the full detail level, IndexSize covers every level
+        bool Index32 = false;
+        uint32_t LodCount = 1;
+        Lod Lods[c_MaxLods] = {};
+    };
+
+    static constexpr char c_Magic[4] = {'A', 'M', 'S', 'H'};
+    static constexpr uint32_t c_FormatVersion = 2;
+
+    /**
+     * @brief Meshes with fewer triangles don't get lower detail levels
+     */
+    static constexpr uint32_t c_MinLodTriangles = 64;
+    static constexpr uint32_t c_VertexStride = 8 * sizeof(float);
+    static constexpr uint64_t c_Alignment = 16;
+
+public:
+    MeshCooker();
+    MeshCooker(const MeshCooker& o) = delete;
+    ~MeshCooker();
+
+    /**
+     * @brief Imports a source mesh and cooks it
+     * @param data Source file data
+     * @param size Size of the source data
+     * @param hint File extension hint for the importer e.g. "obj"
+     * @param output Cooked mesh
+     * @param error Set if the mesh couldn't be cooked
+     * @return True if cooked, false otherwise
+     */
+    bool cook(const unsigned char* data, size_t size, const std::string& hint, std::vector<unsigned char>& output,
+              std::string& error);
+
+    /**
+     * @brief Cooks already interleaved vertex data and 32 bit indices, lower detail levels are generated from them
+     * @param vertices Interleaved vertices, 8 floats per vertex
+     * @param indices Indices
+     * @param output Cooked mesh
+     */
+    static void cook(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, std::vector<unsigned char>& output);
+
+    /**
+     * @brief Simplifies a triangle list by collapsing edges in order of their quadric error. Vertices are never moved or
+     * added so the result indexes the same vertices. Vertices on open edges or shared by several vertices with the same
+     * position (uv and normal seams) are kept in place.
+     * @param vertices Interleaved vertices, 8 floats per vertex
+     * @param indices Triangle list to simplify
+     * @param targetIndexCount Number of indices to reduce to, the result can have more if no more edges can be collapsed
+     * @param output Simplified triangle list
+     * @return Largest quadric error of a collapse
+     */
+    static float simplify(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, size_t targetIndexCount,
+                          std::vector<uint32_t>& output);
+
+    /**
+     * @brief Returns true if the data starts with a cooked mesh header
+     */
+    static bool isCooked(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Validates a cooked mesh and returns pointers into it
+     * @param data Cooked mesh data
+     * @param size Size of the data
+     * @param view View to fill
+     * @return True if the data is a valid cooked mesh, false otherwise
+     */
+    static bool read(const unsigned char* data, size_t size, View& view);
+
+private:
+    class CookerImpl;
+    CookerImpl* m_impl = nullptr;
+};
+
+} // namespace io
+} // namespace aderite
@@ -0,0 +1,309 @@
+#include "PackedArchive.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+
+#ifdef ADERITE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace aderite {
+namespace io {
+
+/**
+ * @brief Comparison used to sort and search the table of contents
+ */
+static bool tocLess(const PackedArchive::TocEntry& l, const PackedArchive::TocEntry& r) {
+    if (l.Kind != r.Kind) {
+        return l.Kind < r.Kind;
+    }
+
+    return l.Handle < r.Handle;
+}
+
+PackedArchive::~PackedArchive() {
+    this->close();
+}
+
+bool PackedArchive::open(const std::filesystem::path& path) {
+    ADERITE_DYNAMIC_ASSERT(!this->isOpen(), "Tried to open an already open archive");
+    LOG_TRACE("[IO] Opening packed archive {0}", path.string());
+
+#ifdef ADERITE_PLATFORM_WINDOWS
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("[IO] Failed to open packed archive {0}", path.string());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        LOG_ERROR("[IO] Failed to create file mapping for {0}", path.string());
+        CloseHandle(file);
+        return false;
+    }
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        LOG_ERROR("[IO] Failed to map view of {0}", path.string());
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_base = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("[IO] Failed to open packed archive {0}", path.string());
+        return false;
+    }
+
+    struct stat st;
+    fstat(fd, &st);
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        LOG_ERROR("[IO] Failed to map packed archive {0}", path.string());
+        return false;
+    }
+
+    m_base = static_cast<const unsigned char*>(view);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    // Validate header
+    const Header* header = reinterpret_cast<const Header*>(m_base);
+    if (m_size < sizeof(Header) || std::memcmp(header->Magic, c_Magic, sizeof(c_Magic)) != 0) {
+        LOG_ERROR("[IO] {0} is not a packed archive", path.string());
+        this->close();
+        return false;
+    }
+
+    if (header->Version != c_FormatVersion) {
+        LOG_ERROR("[IO] {0} has unsupported archive version {1}", path.string(), header->Version);
+        this->close();
+        return false;
+    }
+
+    if (header->TocOffset > m_size || header->EntryCount > (m_size - header->TocOffset) / sizeof(TocEntry)) {
+        LOG_ERROR("[IO] {0} has a corrupted table of contents", path.string());
+        this->close();
+        return false;
+    }
+
+    m_toc = reinterpret_cast<const TocEntry*>(m_base + header->TocOffset);
+    m_entryCount = static_cast<size_t>(header->EntryCount);
+
+    LOG_INFO("[IO] Packed archive {0} opened, it contains {1} entries", path.string(), m_entryCount);
+    return true;
+}
+
+void PackedArchive::close() {
+    if (m_base == nullptr) {
+        return;
+    }
+
+#ifdef ADERITE_PLATFORM_WINDOWS
+    UnmapViewOfFile(m_base);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    CloseHandle(static_cast<HANDLE>(m_file));
+#else
+    munmap(const_cast<unsigned char*>(m_base), m_size);
+#endif
+
+    m_base = nullptr;
+    m_size = 0;
+    m_toc = nullptr;
+    m_entryCount = 0;
+    m_file = nullptr;
+    m_mapping = nullptr;
+}
+
+bool PackedArchive::isOpen() const {
+    return m_base != nullptr;
+}
+
+const unsigned char* PackedArchive::find(EntryKind kind, HandleType handle, size_t& size) const {
+    if (m_toc == nullptr) {
+        return nullptr;
+    }
+
+    TocEntry key = {};
+    key.Kind = kind;
+    key.Handle = handle;
+
+    const TocEntry* end = m_toc + m_entryCount;
+    const TocEntry* it = std::lower_bound(m_toc, end, key, tocLess);
+    if (it == end || it->Kind != kind || it->Handle != handle) {
+        return nullptr;
+    }
+
+    // Every payload is followed by its null terminator, entries that end past the mapping are corrupted
+    if (it->Offset < sizeof(Header) || it->Offset >= m_size || it->Size >= m_size - it->Offset) {
+        LOG_ERROR("[IO] Packed archive entry {0} of kind {1} is out of range", handle, static_cast<uint32_t>(kind));
+        return nullptr;
+    }
+
+    size = static_cast<size_t>(it->Size);
+    return m_base + it->Offset;
+}
+
+bool PackedArchive::pack(const std::filesystem::path& root, const std::filesystem::path& output, const PayloadTransform& transform) {
+    LOG_TRACE("[IO] Packing {0} into {1}", root.string(), output.string());
+
+    // Collect entries
+    struct Source {
+        TocEntry Entry;
+        std::filesystem::path Path;
+    };
+
+    std::vector<Source> sources;
+    auto collect = [&sources](const std::filesystem::path& dir, const std::string& extension, bool reserved, EntryKind kind) {
+        if (!std::filesystem::exists(dir)) {
+            return;
+        }
+
+        for (const auto& file : std::filesystem::directory_iterator(dir)) {
+            if (!file.is_regular_file() || file.path().extension() != extension) {
+                continue;
+            }
+
+            std::string stem = file.path().stem().string();
+            const bool isReserved = !stem.empty() && stem[0] == '_';
+            if (isReserved != reserved) {
+                continue;
+            }
+
+            if (reserved) {
+                stem = stem.substr(1);
+            }
+
+            // Only files named after their handle belong to the project
+            uint64_t handle = 0;
+            const std::from_chars_result result = std::from_chars(stem.data(), stem.data() + stem.size(), handle);
+            if (stem.empty() || result.ec != std::errc() || result.ptr != stem.data() + stem.size()) {
+                LOG_WARN("[IO] Skipping {0}, its name is not a handle", file.path().string());
+                continue;
+            }
+
+            Source source = {};
+            source.Entry.Kind = kind;
+            source.Entry.Handle = handle;
+            source.Path = file.path();
+            sources.push_back(source);
+        }
+    };
+
+    collect(root / "Asset", ".asset", false, EntryKind::SERIALIZABLE);
+    collect(root / "Data", ".data", false, EntryKind::LOADABLE);
+    collect(root / "Data", ".data", true, EntryKind::RESERVED);
+
+    std::sort(sources.begin(), sources.end(), [](const Source& l, const Source& r) {
+        return tocLess(l.Entry, r.Entry);
+    });
+
+    // Written next to the output and renamed once complete, so a failed pack never leaves a partial archive behind
+    std::filesystem::path temporary = output;
+    temporary += ".tmp";
+    std::ofstream out(temporary, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("[IO] Failed to create packed archive {0}", temporary.string());
+        return false;
+    }
+
+    const auto fail = [&out, &temporary]() {
+        out.close();
+        std::error_code ec;
+        std::filesystem::remove(temporary, ec);
+        return false;
+    };
+
+    // Header is rewritten at the end once the table of contents offset is known
+    Header header = {};
+    std::memcpy(header.Magic, c_Magic, sizeof(c_Magic));
+    header.Version = c_FormatVersion;
+    header.EntryCount = sources.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    const char padding[c_Alignment] = {};
+    uint64_t offset = sizeof(Header);
+    std::vector<char> buffer;
+    for (Source& source : sources) {
+        // Align payload start
+        const uint64_t aligned = (offset + c_Alignment - 1) & ~(c_Alignment - 1);
+        out.write(padding, aligned - offset);
+        offset = aligned;
+
+        std::ifstream in(source.Path, std::ios::binary);
+        const size_t size = in.seekg(0, std::ios::end).tellg();
+        in.seekg(0, std::ios::beg);
+        buffer.resize(size);
+        if (!in.read(buffer.data(), buffer.size())) {
+            LOG_ERROR("[IO] Failed to read {0}", source.Path.string());
+            return fail();
+        }
+
+        if (transform && !transform(source.Entry, buffer)) {
+            LOG_ERROR("[IO] Failed to transform {0}", source.Path.string());
+            return fail();
+        }
+
+        source.Entry.Offset = offset;
+        source.Entry.Size = buffer.size();
+        out.write(buffer.data(), buffer.size());
+
+        // Null terminator, so text payloads can also be read as C strings straight from the mapping
+        out.write(padding, 1);
+        offset += buffer.size() + 1;
+    }
+
+    // Table of contents
+    const uint64_t tocOffset = (offset + c_Alignment - 1) & ~(c_Alignment - 1);
+    out.write(padding, tocOffset - offset);
+    for (const Source& source : sources) {
+        out.write(reinterpret_cast<const char*>(&source.Entry), sizeof(TocEntry));
+    }
+
+    header.TocOffset = tocOffset;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    out.close();
+    if (!out) {
+        LOG_ERROR("[IO] Failed to write packed archive {0}", temporary.string());
+        return fail();
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, output, ec);
+    if (ec) {
+        LOG_ERROR("[IO] Failed to move packed archive to {0}: {1}", output.string(), ec.message());
+        return fail();
+    }
+
+    LOG_INFO("[IO] Packed {0} entries into {1}", sources.size(), output.string());
+    return true;
+}
+
+} // namespace io
+} // namespace aderite
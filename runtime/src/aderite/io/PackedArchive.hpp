@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "aderite/Handles.hpp"
+
+namespace aderite {
+namespace io {
+
+/**
+ * @brief Read only archive that packs every serializable and loadable file of a project into a single file.
+ * The archive is memory mapped once and entries are handed out as pointers into the mapping.
+ *
+ * Layout:
+ * Header
+ * Payloads, every payload starts at a c_Alignment boundary and is followed by at least one null byte
+ * Table of contents, sorted by (Kind, Handle)
+ */
+class PackedArchive final {
+public:
+    /**
+     * @brief Kind of the stored entry, the same handle can exist in multiple kinds
+     */
+    enum class EntryKind : uint32_t {
+        SERIALIZABLE = 0, // Asset/<handle>.asset
+        LOADABLE = 1,     // Data/<handle>.data
+        RESERVED = 2,     // Data/_<handle>.data
+    };
+
+    /**
+     * @brief Archive file header
+     */
+    struct Header {
+        char Magic[4];
+        uint32_t Version;
+        uint64_t EntryCount;
+        uint64_t TocOffset;
+    };
+
+    /**
+     * @brief Table of contents entry
+     */
+    struct TocEntry {
+        uint64_t Handle;
+        EntryKind Kind;
+        uint32_t Reserved;
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    static constexpr char c_Magic[4] = {'A', 'P', 'A', 'K'};
+    static constexpr uint32_t c_FormatVersion = 1;
+    static constexpr uint64_t c_Alignment = 16;
+
+    /**
+     * @brief Default file name of the archive inside a project root
+     */
+    static constexpr const char* c_DefaultName = "Game.apak";
+
+    /**
+     * @brief Optional transform applied to every payload before it is written, returns false to abort packing
+     */
+    using PayloadTransform = std::function<bool(const TocEntry& entry, std::vector<char>& payload)>;
+
+public:
+    PackedArchive() {}
+    PackedArchive(const PackedArchive& o) = delete;
+    ~PackedArchive();
+
+    /**
+     * @brief Memory maps the archive and validates its header
+     * @param path Path to the archive
+     * @return True if opened, false otherwise
+     */
+    bool open(const std::filesystem::path& path);
+
+    /**
+     * @brief Unmaps the archive, all previously returned pointers become invalid
+     */
+    void close();
+
+    /**
+     * @brief Returns true if the archive is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Finds an entry in the archive
+     * @param kind Kind of the entry
+     * @param handle Handle of the entry
+     * @param size Size of the entry, set only if found
+     * @return Pointer to the entry data or nullptr if not found or out of range, valid while the archive is open
+     */
+    const unsigned char* find(EntryKind kind, HandleType handle, size_t& size) const;
+
+    /**
+     * @brief Builds an archive from a project root that has Asset/ and Data/ directories
+     * @param root Project root directory
+     * @param output Path of the archive to create
+     * @param transform Optional payload transform, e.g. converting serializables to binary archives
+     * @return True if the archive was created, false otherwise, the output is left untouched on failure
+     */
+    static bool pack(const std::filesystem::path& root, const std::filesystem::path& output, const PayloadTransform& transform = nullptr);
+
+private:
+    const unsigned char* m_base = nullptr;
+    size_t m_size = 0;
+    const TocEntry* m_toc = nullptr;
+    size_t m_entryCount = 0;
+
+    // Platform mapping handles
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+};
+
+} // namespace io
+} // namespace aderite
@@ -1,5 +1,7 @@
 #include "SerializableAsset.hpp"
 
+#include "aderite/Aderite.hpp"
+#include "aderite/asset/AssetManager.hpp"
 #include "aderite/utility/Log.hpp"
 #include "aderite/utility/Macros.hpp"
 
@@ -27,11 +29,25 @@ void SerializableAsset::release() {
     LOG_TRACE("[Asset] Releasing {0}(handle: {2}) reference, there are currently {1} references", this->getName(), m_refCount, m_handle);
     ADERITE_DYNAMIC_ASSERT(m_refCount > 0, "Never acquired object was released");
     m_refCount--;
+
+    if (m_handle != c_InvalidHandle) {
+        ::aderite::Engine::getAssetManager()->markDirty(m_handle);
+    }
 }
 
 void SerializableAsset::acquire() {
     LOG_TRACE("[Asset] Acquiring {0}(handle: {2}) reference, there are currently {1} references", this->getName(), m_refCount, m_handle);
     m_refCount++;
+
+    if (m_handle != c_InvalidHandle) {
+        ::aderite::Engine::getAssetManager()->markDirty(m_handle);
+    }
+}
+
+void SerializableAsset::getDependencies(std::vector<SerializableHandle>& dependencies) const {}
+
+size_t SerializableAsset::getResidentSize() const {
+    return 0;
 }
 
 void SerializableAsset::load(const io::Loader* loader) {}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "aderite/asset/Forward.hpp"
 #include "aderite/io/ILoadable.hpp"
 #include "aderite/io/SerializableObject.hpp"
@@ -39,6 +42,17 @@ public:
      */
     void acquire();
 
+    /**
+     * @brief Appends the handles of assets referenced by this asset, they are prefetched together with this asset
+     * @param dependencies Vector to append to
+     */
+    virtual void getDependencies(std::vector<SerializableHandle>& dependencies) const;
+
+    /**
+     * @brief Returns the number of bytes this asset keeps resident while loaded, used for the asset manager residency budget
+     */
+    virtual size_t getResidentSize() const;
+
     // Inherited via ILoadable
     virtual void load(const io::Loader* loader) override;
     virtual void unload() override;
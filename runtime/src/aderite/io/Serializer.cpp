@@ -1,6 +1,13 @@
 #include "Serializer.hpp"
 
+#include <cstring>
+#include <istream>
+#include <streambuf>
+
 #include "aderite/Aderite.hpp"
+#include "aderite/Config.hpp"
+#include "aderite/io/BinaryArchive.hpp"
+#include "aderite/io/FileHandler.hpp"
 #include "aderite/io/SerializableAsset.hpp"
 #include "aderite/io/SerializableObject.hpp"
 #include "aderite/reflection/Reflector.hpp"
@@ -53,5 +60,36 @@ void Serializer::writeObject(YAML::Emitter& emitter, const SerializableObject* o
     emitter << YAML::EndMap;
 }
 
+/**
+ * @brief Read only stream buffer over chunk contents, so documents are parsed without copying them into a string
+ */
+class ChunkBuffer final : public std::streambuf {
+public:
+    ChunkBuffer(const unsigned char* data, size_t size) {
+        char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+        this->setg(begin, begin, begin + size);
+    }
+};
+
+YAML::Node Serializer::readDocument(const DataChunk& chunk) const {
+    if (BinaryArchive::isBinary(chunk.data(), chunk.size())) {
+        return BinaryArchive::read(chunk.data(), chunk.size());
+    }
+
+    ChunkBuffer buffer(chunk.data(), chunk.size());
+    std::istream stream(&buffer);
+    return YAML::Load(stream);
+}
+
+void Serializer::writeDocument(const YAML::Emitter& emitter, DataChunk& chunk) const {
+#if BINARY_SAVE_TYPE == 1
+    std::vector<unsigned char> archive = BinaryArchive::convert(emitter.c_str(), emitter.size());
+    chunk.Data.swap(archive);
+#else
+    chunk.Data.resize(emitter.size());
+    std::memcpy(chunk.Data.data(), emitter.c_str(), chunk.Data.size());
+#endif
+}
+
 } // namespace io
 } // namespace aderite
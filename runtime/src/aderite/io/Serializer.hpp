@@ -81,6 +81,20 @@ public:
      */
     void writeObject(YAML::Emitter& emitter, const SerializableObject* object) const;
 
+    /**
+     * @brief Reads a document from a data chunk, binary archives are detected automatically so both formats can be read
+     * @param chunk Chunk to read
+     * @return Root node of the document
+     */
+    YAML::Node readDocument(const DataChunk& chunk) const;
+
+    /**
+     * @brief Writes an emitted document to a data chunk, the format is selected by the save type in Config.hpp
+     * @param emitter Emitter containing the document
+     * @param chunk Chunk to write to
+     */
+    void writeDocument(const YAML::Emitter& emitter, DataChunk& chunk) const;
+
 private:
     Serializer() {}
     friend Engine;
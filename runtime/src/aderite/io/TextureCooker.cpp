@@ -0,0 +1,474 @@
+#include "TextureCooker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <bgfx/bgfx.h>
+#include <stb_image.h>
+
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+
+namespace aderite {
+namespace io {
+
+namespace {
+
+/**
+ * @brief Returns true if the value is a power of two
+ */
+bool isPowerOfTwo(uint32_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+/**
+ * @brief Returns the number of bytes a block or a pixel of the format takes
+ */
+uint32_t getBlockBytes(uint32_t format) {
+    switch (format) {
+    case bgfx::TextureFormat::BC1:
+    case bgfx::TextureFormat::BC4: {
+        return 8;
+    }
+    case bgfx::TextureFormat::BC3:
+    case bgfx::TextureFormat::BC5: {
+        return 16;
+    }
+    case bgfx::TextureFormat::R8: {
+        return 1;
+    }
+    case bgfx::TextureFormat::RG8: {
+        return 2;
+    }
+    case bgfx::TextureFormat::RGBA8: {
+        return 4;
+    }
+    default: {
+        return 0;
+    }
+    }
+}
+
+/**
+ * @brief Returns true if the format is block compressed
+ */
+bool isCompressed(uint32_t format) {
+    return format == bgfx::TextureFormat::BC1 || format == bgfx::TextureFormat::BC3 || format == bgfx::TextureFormat::BC4 ||
+           format == bgfx::TextureFormat::BC5;
+}
+
+/**
+ * @brief Returns the size of a level in the specified format
+ */
+uint64_t getLevelSize(uint32_t format, uint32_t width, uint32_t height) {
+    if (isCompressed(format)) {
+        const uint64_t blocksX = (width + TextureCooker::c_BlockSize - 1) / TextureCooker::c_BlockSize;
+        const uint64_t blocksY = (height + TextureCooker::c_BlockSize - 1) / TextureCooker::c_BlockSize;
+        return blocksX * blocksY * getBlockBytes(format);
+    }
+
+    return static_cast<uint64_t>(width) * height * getBlockBytes(format);
+}
+
+/**
+ * @brief Halves the image with a box filter, odd edges are clamped
+ */
+std::vector<unsigned char> downsample(const std::vector<unsigned char>& source, uint32_t width, uint32_t height, uint32_t channels) {
+    const uint32_t levelWidth = std::max(1u, width / 2);
+    const uint32_t levelHeight = std::max(1u, height / 2);
+    std::vector<unsigned char> level(static_cast<size_t>(levelWidth) * levelHeight * channels);
+
+    for (uint32_t y = 0; y < levelHeight; y++) {
+        const uint32_t y0 = std::min(y * 2, height - 1);
+        const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+        for (uint32_t x = 0; x < levelWidth; x++) {
+            const uint32_t x0 = std::min(x * 2, width - 1);
+            const uint32_t x1 = std::min(x * 2 + 1, width - 1);
+            for (uint32_t c = 0; c < channels; c++) {
+                const uint32_t sum = source[(static_cast<size_t>(y0) * width + x0) * channels + c] +
+                                     source[(static_cast<size_t>(y0) * width + x1) * channels + c] +
+                                     source[(static_cast<size_t>(y1) * width + x0) * channels + c] +
+                                     source[(static_cast<size_t>(y1) * width + x1) * channels + c];
+                level[(static_cast<size_t>(y) * levelWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+
+    return level;
+}
+
+uint16_t pack565(const unsigned char* color) {
+    return static_cast<uint16_t>(((color[0] * 31 + 127) / 255) << 11 | ((color[1] * 63 + 127) / 255) << 5 | ((color[2] * 31 + 127) / 255));
+}
+
+void unpack565(uint16_t value, int* color) {
+    const int r = value >> 11;
+    const int g = (value >> 5) & 0x3f;
+    const int b = value & 0x1f;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * @brief Encodes a 4x4 block of RGBA pixels into a BC1 color block, endpoints are the extremes along the principal axis
+ */
+void encodeColorBlock(const unsigned char (&block)[16][4], unsigned char* output) {
+    float mean[3] = {};
+    for (const auto& pixel : block) {
+        for (int c = 0; c < 3; c++) {
+            mean[c] += pixel[c] / 16.0f;
+        }
+    }
+
+    // xx, xy, xz, yy, yz, zz
+    float covariance[6] = {};
+    for (const auto& pixel : block) {
+        const float r = pixel[0] - mean[0];
+        const float g = pixel[1] - mean[1];
+        const float b = pixel[2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // Power iteration, a handful of steps is enough to separate the endpoints
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int i = 0; i < 4; i++) {
+        const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        const float length = std::max(std::fabs(x), std::max(std::fabs(y), std::fabs(z)));
+        if (length < 1e-6f) {
+            break;
+        }
+
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    int minIndex = 0;
+    int maxIndex = 0;
+    float minProjection = 0.0f;
+    float maxProjection = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        const float projection = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+        if (i == 0 || projection < minProjection) {
+            minProjection = projection;
+            minIndex = i;
+        }
+        if (i == 0 || projection > maxProjection) {
+            maxProjection = projection;
+            maxIndex = i;
+        }
+    }
+
+    uint16_t color0 = pack565(block[maxIndex]);
+    uint16_t color1 = pack565(block[minIndex]);
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    // Four color mode requires color0 > color1, equal endpoints mean a solid block
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        int palette[4][3];
+        unpack565(color0, palette[0]);
+        unpack565(color1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestDistance = INT32_MAX;
+            for (int p = 0; p < 4; p++) {
+                const int r = block[i][0] - palette[p][0];
+                const int g = block[i][1] - palette[p][1];
+                const int b = block[i][2] - palette[p][2];
+                const int distance = r * r + g * g + b * b;
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+
+            indices |= static_cast<uint32_t>(best) << (2 * i);
+        }
+    }
+
+    output[0] = static_cast<unsigned char>(color0 & 0xff);
+    output[1] = static_cast<unsigned char>(color0 >> 8);
+    output[2] = static_cast<unsigned char>(color1 & 0xff);
+    output[3] = static_cast<unsigned char>(color1 >> 8);
+    for (int i = 0; i < 4; i++) {
+        output[4 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+/**
+ * @brief Encodes a 4x4 block of single channel values into a BC4 block, also used for BC3 alpha and BC5 channels
+ */
+void encodeChannelBlock(const unsigned char (&values)[16], unsigned char* output) {
+    const int maxValue = *std::max_element(values, values + 16);
+    const int minValue = *std::min_element(values, values + 16);
+
+    // Eight value mode requires value0 > value1, equal endpoints mean a solid block
+    uint64_t indices = 0;
+    if (maxValue != minValue) {
+        int palette[8] = {maxValue, minValue};
+        for (int p = 2; p < 8; p++) {
+            palette[p] = ((8 - p) * maxValue + (p - 1) * minValue + 3) / 7;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestDistance = INT32_MAX;
+            for (int p = 0; p < 8; p++) {
+                const int distance = std::abs(values[i] - palette[p]);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+
+            indices |= static_cast<uint64_t>(best) << (3 * i);
+        }
+    }
+
+    output[0] = static_cast<unsigned char>(maxValue);
+    output[1] = static_cast<unsigned char>(minValue);
+    for (int i = 0; i < 6; i++) {
+        output[2 + i] = static_cast<unsigned char>(indices >> (8 * i));
+    }
+}
+
+/**
+ * @brief Copies a single channel out of a block
+ */
+void gatherChannel(const unsigned char (&block)[16][4], int channel, unsigned char (&values)[16]) {
+    for (int i = 0; i < 16; i++) {
+        values[i] = block[i][channel];
+    }
+}
+
+/**
+ * @brief Block compresses a single level
+ */
+void compressLevel(const std::vector<unsigned char>& pixels, uint32_t width, uint32_t height, uint32_t channels, uint32_t format,
+                   unsigned char* output) {
+    const uint32_t blocksX = (width + TextureCooker::c_BlockSize - 1) / TextureCooker::c_BlockSize;
+    const uint32_t blocksY = (height + TextureCooker::c_BlockSize - 1) / TextureCooker::c_BlockSize;
+
+    for (uint32_t by = 0; by < blocksY; by++) {
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            // Gather the block, pixels outside of the level repeat the edge
+            unsigned char block[16][4] = {};
+            for (uint32_t i = 0; i < 16; i++) {
+                const uint32_t x = std::min(bx * 4 + i % 4, width - 1);
+                const uint32_t y = std::min(by * 4 + i / 4, height - 1);
+                const unsigned char* pixel = &pixels[(static_cast<size_t>(y) * width + x) * channels];
+                for (uint32_t c = 0; c < channels; c++) {
+                    block[i][c] = pixel[c];
+                }
+            }
+
+            unsigned char first[16];
+            unsigned char second[16];
+            switch (format) {
+            case bgfx::TextureFormat::BC1: {
+                encodeColorBlock(block, output);
+                break;
+            }
+            case bgfx::TextureFormat::BC3: {
+                gatherChannel(block, 3, first);
+                encodeChannelBlock(first, output);
+                encodeColorBlock(block, output + 8);
+                break;
+            }
+            case bgfx::TextureFormat::BC4: {
+                gatherChannel(block, 0, first);
+                encodeChannelBlock(first, output);
+                break;
+            }
+            case bgfx::TextureFormat::BC5: {
+                gatherChannel(block, 0, first);
+                gatherChannel(block, 1, second);
+                encodeChannelBlock(first, output);
+                encodeChannelBlock(second, output + 8);
+                break;
+            }
+            }
+
+            output += getBlockBytes(format);
+        }
+    }
+}
+
+} // namespace
+
+bool TextureCooker::cook(const unsigned char* data, size_t size, bool compress, std::vector<unsigned char>& output, std::string& error) {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 0);
+    if (pixels == nullptr) {
+        error = stbi_failure_reason();
+        return false;
+    }
+
+    cook(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint32_t>(channels), compress, output);
+    stbi_image_free(pixels);
+    return true;
+}
+
+void TextureCooker::cook(const unsigned char* pixels, uint32_t width, uint32_t height, uint32_t channels, bool compress,
+                         std::vector<unsigned char>& output) {
+    ADERITE_DYNAMIC_ASSERT(channels >= 1 && channels <= 4, "Unsupported channel count");
+
+    // RGB is stored as RGBA, there is no 3 channel format worth sampling from
+    const uint32_t levelChannels = channels == 3 ? 4 : channels;
+    std::vector<unsigned char> level(static_cast<size_t>(width) * height * levelChannels);
+    bool opaque = true;
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        for (uint32_t c = 0; c < levelChannels; c++) {
+            level[i * levelChannels + c] = c < channels ? pixels[i * channels + c] : 255;
+        }
+
+        opaque = opaque && (channels != 4 || pixels[i * channels + 3] == 255);
+    }
+
+    // Top level of a block compressed texture has to be a multiple of the block size, powers of two keep every level that way
+    uint32_t format = bgfx::TextureFormat::RGBA8;
+    if (compress && isPowerOfTwo(width) && isPowerOfTwo(height) && width >= c_BlockSize && height >= c_BlockSize) {
+        const uint32_t formats[] = {bgfx::TextureFormat::BC4, bgfx::TextureFormat::BC5, bgfx::TextureFormat::BC1,
+                                    opaque ? bgfx::TextureFormat::BC1 : bgfx::TextureFormat::BC3};
+        format = formats[channels - 1];
+    } else {
+        const uint32_t formats[] = {bgfx::TextureFormat::R8, bgfx::TextureFormat::RG8, bgfx::TextureFormat::RGBA8,
+                                    bgfx::TextureFormat::RGBA8};
+        format = formats[channels - 1];
+    }
+
+    // Full chain down to 1x1, bgfx doesn't support partial chains
+    std::vector<LevelEntry> entries;
+    uint32_t levelWidth = width;
+    uint32_t levelHeight = height;
+    uint64_t offset = 0;
+    while (true) {
+        entries.push_back({levelWidth, levelHeight, offset, getLevelSize(format, levelWidth, levelHeight)});
+        offset += entries.back().Size;
+        if (levelWidth == 1 && levelHeight == 1) {
+            break;
+        }
+
+        levelWidth = std::max(1u, levelWidth / 2);
+        levelHeight = std::max(1u, levelHeight / 2);
+    }
+
+    const uint64_t dataOffset = sizeof(Header) + sizeof(LevelEntry) * entries.size();
+    for (LevelEntry& entry : entries) {
+        entry.Offset += dataOffset;
+    }
+
+    Header header = {};
+    std::memcpy(header.Magic, c_Magic, sizeof(c_Magic));
+    header.Version = c_FormatVersion;
+    header.Width = width;
+    header.Height = height;
+    header.LevelCount = static_cast<uint32_t>(entries.size());
+    header.Format = format;
+
+    output.assign(static_cast<size_t>(dataOffset + offset), 0);
+    std::memcpy(output.data(), &header, sizeof(Header));
+    std::memcpy(output.data() + sizeof(Header), entries.data(), sizeof(LevelEntry) * entries.size());
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const LevelEntry& entry = entries[i];
+        if (i > 0) {
+            level = downsample(level, entries[i - 1].Width, entries[i - 1].Height, levelChannels);
+        }
+
+        unsigned char* levelData = output.data() + entry.Offset;
+        if (isCompressed(format)) {
+            compressLevel(level, entry.Width, entry.Height, levelChannels, format, levelData);
+        } else {
+            std::memcpy(levelData, level.data(), static_cast<size_t>(entry.Size));
+        }
+    }
+}
+
+bool TextureCooker::isCooked(const unsigned char* data, size_t size) {
+    return data != nullptr && size >= sizeof(Header) && std::memcmp(data, c_Magic, sizeof(c_Magic)) == 0;
+}
+
+bool TextureCooker::read(const unsigned char* data, size_t size, View& view) {
+    if (!isCooked(data, size)) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.Version != c_FormatVersion || getBlockBytes(header.Format) == 0) {
+        LOG_ERROR("[IO] Unsupported cooked texture version {0} format {1}", header.Version, header.Format);
+        return false;
+    }
+
+    if (header.LevelCount == 0 || header.LevelCount > 32 || sizeof(Header) + sizeof(LevelEntry) * header.LevelCount > size) {
+        LOG_ERROR("[IO] Corrupted cooked texture");
+        return false;
+    }
+
+    view.Format = header.Format;
+    view.Compressed = isCompressed(header.Format);
+    view.Levels.resize(header.LevelCount);
+
+    uint64_t expectedOffset = sizeof(Header) + sizeof(LevelEntry) * header.LevelCount;
+    for (uint32_t i = 0; i < header.LevelCount; i++) {
+        LevelEntry entry;
+        std::memcpy(&entry, data + sizeof(Header) + sizeof(LevelEntry) * i, sizeof(LevelEntry));
+
+        // Levels have to be contiguous so that the tail of the chain can be uploaded directly
+        if (entry.Offset != expectedOffset || entry.Size != getLevelSize(header.Format, entry.Width, entry.Height) ||
+            entry.Offset + entry.Size > size) {
+            LOG_ERROR("[IO] Corrupted cooked texture");
+            return false;
+        }
+
+        view.Levels[i].Data = data + entry.Offset;
+        view.Levels[i].Size = static_cast<uint32_t>(entry.Size);
+        view.Levels[i].Width = entry.Width;
+        view.Levels[i].Height = entry.Height;
+        expectedOffset += entry.Size;
+    }
+
+    return true;
+}
+
+uint32_t TextureCooker::getStreamingBase(const View& view, uint32_t maxSize) {
+    uint32_t base = static_cast<uint32_t>(view.Levels.size()) - 1;
+    for (uint32_t i = 0; i < view.Levels.size(); i++) {
+        if (std::max(view.Levels[i].Width, view.Levels[i].Height) <= maxSize) {
+            base = i;
+            break;
+        }
+    }
+
+    // Block compressed top levels have to be a multiple of the block size
+    while (view.Compressed && base > 0 &&
+           (view.Levels[base].Width % c_BlockSize != 0 || view.Levels[base].Height % c_BlockSize != 0)) {
+        base--;
+    }
+
+    return base;
+}
+
+} // namespace io
+} // namespace aderite
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "aderite/io/Forward.hpp"
+
+namespace aderite {
+namespace io {
+
+/**
+ * @brief Converts source images (png, jpg, etc.) into a GPU ready mip chain once at import time, so that the runtime
+ * doesn't have to decode images every time a texture is loaded.
+ *
+ * Layout:
+ * Header
+ * Level table, one entry per mip level, largest level first
+ * Level data in the same order, stored the way bgfx expects a full mip chain so any suffix of the chain (the
+ * smallest mips) can be uploaded as is
+ *
+ * Single channel images are compressed to BC4, two channel images to BC5, opaque images to BC1 and images with alpha
+ * to BC3. Images that can't be block compressed (non power of two or smaller than a block) are stored uncompressed.
+ */
+class TextureCooker final {
+public:
+    /**
+     * @brief Cooked texture header
+     */
+    struct Header {
+        char Magic[4];
+        uint32_t Version;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t LevelCount;
+        uint32_t Format; // bgfx::TextureFormat::Enum
+    };
+
+    /**
+     * @brief Level table entry
+     */
+    struct LevelEntry {
+        uint32_t Width;
+        uint32_t Height;
+        uint64_t Offset; // From the start of the header
+        uint64_t Size;
+    };
+
+    /**
+     * @brief Pointers into a cooked texture mip level
+     */
+    struct Level {
+        const unsigned char* Data = nullptr;
+        uint32_t Size = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+    };
+
+    /**
+     * @brief Pointers into a cooked texture
+     */
+    struct View {
+        uint32_t Format = 0;
+        bool Compressed = false;
+        std::vector<Level> Levels;
+    };
+
+    static constexpr char c_Magic[4] = {'A', 'T', 'E', 'X'};
+    static constexpr uint32_t c_FormatVersion = 1;
+    static constexpr uint32_t c_BlockSize = 4;
+
+public:
+    /**
+     * @brief Decodes a source image and cooks it
+     * @param data Source file data
+     * @param size Size of the source data
+     * @param compress If true the levels are block compressed, otherwise they are stored as 8 bit per channel
+     * @param output Cooked texture
+     * @param error Set if the texture couldn't be cooked
+     * @return True if cooked, false otherwise
+     */
+    static bool cook(const unsigned char* data, size_t size, bool compress, std::vector<unsigned char>& output, std::string& error);
+
+    /**
+     * @brief Generates the mip chain for decoded pixels and cooks it
+     * @param pixels 8 bit per channel pixels
+     * @param width Width of the image
+     * @param height Height of the image
+     * @param channels Number of channels (1 to 4)
+     * @param compress If true the levels are block compressed, otherwise they are stored as 8 bit per channel
+     * @param output Cooked texture
+     */
+    static void cook(const unsigned char* pixels, uint32_t width, uint32_t height, uint32_t channels, bool compress,
+                     std::vector<unsigned char>& output);
+
+    /**
+     * @brief Returns true if the data starts with a cooked texture header
+     */
+    static bool isCooked(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Validates a cooked texture and returns pointers into it
+     * @param data Cooked texture data
+     * @param size Size of the data
+     * @param view View to fill
+     * @return True if the data is a valid cooked texture, false otherwise
+     */
+    static bool read(const unsigned char* data, size_t size, View& view);
+
+    /**
+     * @brief Returns the level that streaming should start from, the first level that fits into maxSize while still
+     * being a valid top level for the texture format
+     * @param view Cooked texture
+     * @param maxSize Maximum width and height of the level
+     */
+    static uint32_t getStreamingBase(const View& view, uint32_t maxSize);
+};
+
+} // namespace io
+} // namespace aderite
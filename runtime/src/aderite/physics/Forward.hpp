@@ -17,6 +17,7 @@ class RaycastResult;
 class Geometry;
 class BoxGeometry;
 class PhysXActor;
+class JobDispatcher;
 class PhysicsProperties;
 struct TriggerEvent;
 struct CollisionEvent;
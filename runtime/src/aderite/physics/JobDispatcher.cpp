@@ -0,0 +1,27 @@
+#include "JobDispatcher.hpp"
+
+#include <task/PxTask.h>
+
+#include "aderite/threading/JobSystem.hpp"
+
+namespace aderite {
+namespace physics {
+
+JobDispatcher::JobDispatcher(threading::JobSystem* jobSystem) : m_jobSystem(jobSystem) {}
+
+void JobDispatcher::submitTask(physx::PxBaseTask& task) {
+    // The simulation step waits on these, so they go ahead of loading and other background work
+    m_jobSystem->schedule(
+        [&task]() {
+            task.run();
+            task.release();
+        },
+        threading::Job::Priority::HIGH);
+}
+
+uint32_t JobDispatcher::getWorkerCount() const {
+    return static_cast<uint32_t>(m_jobSystem->getWorkerCount());
+}
+
+} // namespace physics
+} // namespace aderite
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <task/PxCpuDispatcher.h>
+
+#include "aderite/threading/Forward.hpp"
+
+namespace aderite {
+namespace physics {
+
+/**
+ * @brief PhysX CPU dispatcher that runs simulation tasks on the engine job system, so physics shares the worker threads
+ * with the rest of the engine instead of owning a separate pool
+ */
+class JobDispatcher final : public physx::PxCpuDispatcher {
+public:
+    /**
+     * @brief Creates a dispatcher that submits tasks to the specified job system
+     * @param jobSystem Job system that executes the tasks
+     */
+    JobDispatcher(threading::JobSystem* jobSystem);
+    JobDispatcher(const JobDispatcher& o) = delete;
+
+    // Inherited via PxCpuDispatcher
+    void submitTask(physx::PxBaseTask& task) override;
+    uint32_t getWorkerCount() const override;
+
+private:
+    threading::JobSystem* m_jobSystem = nullptr;
+};
+
+} // namespace physics
+} // namespace aderite
@@ -11,6 +11,7 @@
 #include "aderite/physics/geometry/Geometry.hpp"
 #include "aderite/scene/GameObject.hpp"
 #include "aderite/scene/Scene.hpp"
+#include "aderite/scripting/ScriptedBehavior.hpp"
 #include "aderite/utility/Macros.hpp"
 
 namespace aderite {
@@ -27,11 +28,35 @@ void PhysXActor::update(float delta) {
     // Check if the actor needs to be converted
     this->createActor();
 
-    // Sync properties
-    if (m_isDynamic) {
-        physx::PxRigidDynamic* dynamic = static_cast<physx::PxRigidDynamic*>(m_actor);
-        dynamic->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, !m_properties.hasGravity());
-        dynamic->setMass(m_properties.getMass());
+    // Sync properties, only after they were changed
+    if (m_properties.havePropertiesChanged()) {
+        if (m_isDynamic) {
+            physx::PxRigidDynamic* dynamic = static_cast<physx::PxRigidDynamic*>(m_actor);
+            dynamic->setActorFlag(physx::PxActorFlag::eDISABLE_GRAVITY, !m_properties.hasGravity());
+            dynamic->setMass(m_properties.getMass());
+        }
+
+        // Reset flag
+        m_properties.resetPropertiesChangedFlag();
+    }
+
+    if (m_gObject->haveBehaviorsChanged() || m_properties.hasGeometryChanged()) {
+        // Pairs only generate events if a behavior of either game object handles them
+        uint32_t listeners = 0;
+        for (scripting::ScriptedBehavior* behavior : m_gObject->getBehaviors()) {
+            if (behavior->listensToCollisions()) {
+                listeners |= Geometry::c_ListenCollisions;
+            }
+            if (behavior->listensToTriggers()) {
+                listeners |= Geometry::c_ListenTriggers;
+            }
+        }
+
+        for (Geometry* geom : m_properties.getAttachedGeometries()) {
+            geom->setListeners(listeners);
+        }
+
+        m_gObject->resetBehaviorsChangedFlag();
     }
 
     if (m_properties.hasGeometryChanged()) {
@@ -48,28 +73,54 @@ void PhysXActor::update(float delta) {
 
     // Sync position
     scene::TransformProvider* const transform = m_gObject->getTransform();
-    if (transform != nullptr) {
-        if (transform->wasModified()) {
-            // Transform was modified sync with it
+    if (transform == nullptr) {
+        return;
+    }
 
-            // Regenerate shapes
-            for (physics::Geometry* geometry : m_properties.getAttachedGeometries()) {
-                geometry->applyScale(transform->getScale());
-            }
+    // Static actors follow their parents, dynamic actors own their world pose and only teleport when set directly
+    if (transform->wasModified() || (!m_isDynamic && transform->isDirty())) {
+        // Transform was modified sync with it
 
-            // Set spatial attributes
-            physx::PxTransform pxt = m_actor->getGlobalPose();
-            pxt.p = {transform->getPosition().x, transform->getPosition().y, transform->getPosition().z};
-            pxt.q = {transform->getRotation().x, transform->getRotation().y, transform->getRotation().z, transform->getRotation().w};
-            m_actor->setGlobalPose(pxt);
-        } else {
-            physx::PxTransform pxt = m_actor->getGlobalPose();
-            transform->setPosition({pxt.p.x, pxt.p.y, pxt.p.z});
-            transform->setRotation({pxt.q.w, pxt.q.x, pxt.q.y, pxt.q.z});
+        // Regenerate shapes
+        const glm::vec3 scale = transform->getWorldScale();
+        for (physics::Geometry* geometry : m_properties.getAttachedGeometries()) {
+            geometry->applyScale(scale);
         }
+
+        // Set spatial attributes, the actor lives in world space
+        const glm::vec3 position = transform->getWorldPosition();
+        const glm::quat rotation = transform->getWorldRotation();
+        physx::PxTransform pxt = m_actor->getGlobalPose();
+        pxt.p = {position.x, position.y, position.z};
+        pxt.q = {rotation.x, rotation.y, rotation.z, rotation.w};
+        m_actor->setGlobalPose(pxt);
+
+        // Teleported, nothing to interpolate from
+        m_previousPose = pxt;
+        m_pose = pxt;
+        m_synced = true;
+    } else if (!m_synced) {
+        // Only actors that moved in the last step are interpolated, an actor that stopped is left at its last pose and
+        // isn't touched again until it moves
+        const bool moving = m_step == m_gObject->getScene()->getStepCount();
+        const float alpha = moving ? ::aderite::Engine::getPhysicsController()->getInterpolation() : 1.0f;
+
+        // Rendered between the last two fixed steps so that motion stays smooth when frames and steps don't line up
+        const physx::PxVec3 p = m_previousPose.p + (m_pose.p - m_previousPose.p) * alpha;
+        const glm::quat previous = {m_previousPose.q.w, m_previousPose.q.x, m_previousPose.q.y, m_previousPose.q.z};
+        const glm::quat current = {m_pose.q.w, m_pose.q.x, m_pose.q.y, m_pose.q.z};
+        transform->setWorldPose({p.x, p.y, p.z}, glm::slerp(previous, current, alpha));
+        m_synced = !moving;
     }
 }
 
+void PhysXActor::onStep(uint64_t step) {
+    m_previousPose = m_pose;
+    m_pose = m_actor->getGlobalPose();
+    m_step = step;
+    m_synced = false;
+}
+
 void PhysXActor::transferGeometry(physx::PxRigidActor* actor) {
     size_t count = m_actor->getNbShapes();
     std::vector<physx::PxShape*> shapes;
@@ -90,7 +141,7 @@ void PhysXActor::freeActor() {
     physx::PxScene* scene = m_actor->getScene();
 
     if (scene != nullptr) {
-        scene->removeActor(*m_actor);
+        static_cast<PhysicsScene*>(scene->userData)->removeActor(this);
     }
     m_actor->userData = nullptr;
     m_actor = nullptr;
@@ -120,6 +171,9 @@ void PhysXActor::createActor() {
         }
 
         m_actor = newInstance;
+        m_previousPose = m_actor->getGlobalPose();
+        m_pose = m_previousPose;
+        m_synced = true;
         m_gObject->getScene()->addActor(this);
     }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include <physx/PxRigidActor.h>
@@ -26,6 +27,13 @@ public:
      */
     void update(float delta);
 
+    /**
+     * @brief Called after every fixed step the actor moved in, the pose of the step becomes the one the transform is
+     * interpolated towards
+     * @param step Index of the step
+     */
+    void onStep(uint64_t step);
+
     /**
      * @brief Returns the PhysX actor instance
      */
@@ -63,6 +71,12 @@ private:
     physx::PxRigidActor* m_actor = nullptr;
     PhysicsProperties m_properties;
     bool m_isDynamic = false; // Used to track state change
+
+    // Poses of the last two fixed steps
+    physx::PxTransform m_previousPose = physx::PxTransform(physx::PxIdentity);
+    physx::PxTransform m_pose = physx::PxTransform(physx::PxIdentity);
+    uint64_t m_step = 0;  // Last step the actor moved in
+    bool m_synced = true; // True if the transform holds the last pose
 };
 
 } // namespace physics
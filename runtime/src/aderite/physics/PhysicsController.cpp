@@ -1,5 +1,7 @@
 #include "PhysicsController.hpp"
 
+#include <algorithm>
+
 #include <PxActor.h>
 #include <PxFoundation.h>
 #include <PxMaterial.h>
@@ -20,7 +22,9 @@
 #include <pvd/PxPvdTransport.h>
 
 #include "aderite/Aderite.hpp"
+#include "aderite/physics/JobDispatcher.hpp"
 #include "aderite/physics/PhysicsScene.hpp"
+#include "aderite/physics/geometry/Geometry.hpp"
 #include "aderite/scene/Scene.hpp"
 #include "aderite/scene/SceneManager.hpp"
 #include "aderite/utility/Log.hpp"
@@ -130,14 +134,11 @@ bool PhysicsController::init() {
     LOG_INFO("[Physics] PhysX extensions initialized");
 
     LOG_TRACE("[Physics] Setting up physics defaults and properties");
-    m_dispatcher = physx::PxDefaultCpuDispatcherCreate(m_numThreads);
+    m_dispatcher = new JobDispatcher(::aderite::Engine::getJobSystem());
 
     // Create default material
     m_defaultMaterial = m_physics->createMaterial(m_defaultStaticFriction, m_defaultDynamicFriction, m_defaultRestitution);
 
-    // Configure collision filter
-    physx::PxSetGroupCollisionFlag(0, 0, true);
-
     LOG_INFO("[Physics] Physics controller initialized");
 
     return true;
@@ -147,8 +148,10 @@ void PhysicsController::shutdown() {
     ADERITE_LOG_BLOCK;
     LOG_TRACE("[Physics] Shutting down physics controller");
 
+    this->fetchResults();
+
     m_cooking->release();
-    m_dispatcher->release();
+    delete m_dispatcher;
     m_physics->release();
     m_pvd->release();
     PxCloseExtensions();
@@ -158,24 +161,72 @@ void PhysicsController::shutdown() {
 }
 
 void PhysicsController::update(float delta) {
-    auto currentScene = ::aderite::Engine::getSceneManager()->getCurrentScene();
+    // A step that is still running from the last update has to finish first
+    this->fetchResults();
 
-    // Simulate a step
+    scene::Scene* currentScene = ::aderite::Engine::getSceneManager()->getCurrentScene();
     if (currentScene == nullptr) {
         return;
     }
 
-    m_accumulator += delta;
+    // Catch up with every step the accumulated time allows, up to the clamp
+    m_accumulator = std::min(m_accumulator + delta, c_FixedUpdateWindow * c_MaxSubsteps);
+    const uint32_t steps = static_cast<uint32_t>(m_accumulator / c_FixedUpdateWindow);
+    m_accumulator -= c_FixedUpdateWindow * steps;
+    m_interpolation = std::min(m_accumulator / c_FixedUpdateWindow, 1.0f);
 
-    if (m_accumulator < c_FixedUpdateWindow) {
+    m_timings = {};
+    m_timings.Steps = steps;
+    if (steps == 0) {
         return;
     }
 
-    m_accumulator -= c_FixedUpdateWindow;
+    // Every step depends on the previous one, only the last one can overlap with the frame
+    for (uint32_t i = 1; i < steps; i++) {
+        currentScene->simulate(c_FixedUpdateWindow);
+        currentScene->fetchResults();
+    }
+
+    m_stepStart = std::chrono::high_resolution_clock::now();
     currentScene->simulate(c_FixedUpdateWindow);
+
+    if (!m_async) {
+        this->fetchResults();
+    }
+}
+
+void PhysicsController::fetchResults() {
+    scene::Scene* currentScene = ::aderite::Engine::getSceneManager()->getCurrentScene();
+    if (currentScene == nullptr || !currentScene->isSimulating()) {
+        return;
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    currentScene->fetchResults();
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    m_timings.WaitMs = std::chrono::duration<double, std::milli>(end - start).count();
+    m_timings.SimulateMs = std::chrono::duration<double, std::milli>(end - m_stepStart).count();
+
     currentScene->sendEvents();
 }
 
+float PhysicsController::getInterpolation() const {
+    return m_interpolation;
+}
+
+bool PhysicsController::isAsync() const {
+    return m_async;
+}
+
+void PhysicsController::setAsync(bool value) {
+    m_async = value;
+}
+
+const PhysicsController::Timings& PhysicsController::getTimings() const {
+    return m_timings;
+}
+
 physx::PxPhysics* PhysicsController::getPhysics() const {
     return m_physics;
 }
@@ -192,15 +243,34 @@ physx::PxFilterFlags PhysicsController::filterShader(physx::PxFilterObjectAttrib
                                                      physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
                                                      physx::PxPairFlags& pairFlags, const void* constantBlock,
                                                      physx::PxU32 constantBlockSize) {
-    // Let triggers through
+    // Layers, the pair is dropped before any narrow phase work if either mask or the scene matrix excludes it
+    if ((filterData0.word1 & filterData1.word0) == 0 || (filterData1.word1 & filterData0.word0) == 0) {
+        return physx::PxFilterFlag::eSUPPRESS;
+    }
+
+    if (constantBlockSize == sizeof(uint32_t) * PhysicsScene::c_LayerCount) {
+        const uint32_t* matrix = static_cast<const uint32_t*>(constantBlock);
+        if ((matrix[filterData0.word3] & filterData1.word0) == 0) {
+            return physx::PxFilterFlag::eSUPPRESS;
+        }
+    }
+
+    // Triggers only report events, so a trigger pair nobody listens to is useless
+    const physx::PxU32 listeners = filterData0.word2 | filterData1.word2;
     if (physx::PxFilterObjectIsTrigger(attributes0) || physx::PxFilterObjectIsTrigger(attributes1)) {
+        if ((listeners & Geometry::c_ListenTriggers) == 0) {
+            return physx::PxFilterFlag::eSUPPRESS;
+        }
+
         pairFlags = physx::PxPairFlag::eTRIGGER_DEFAULT;
         return physx::PxFilterFlag::eDEFAULT;
     }
 
-    // Generate contacts for all that were not filtered above
+    // Generate contacts for all that were not filtered above, events only if a behavior handles them
     pairFlags = physx::PxPairFlag::eCONTACT_DEFAULT;
-    pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_FOUND | physx::PxPairFlag::eNOTIFY_TOUCH_LOST;
+    if (listeners & Geometry::c_ListenCollisions) {
+        pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_FOUND | physx::PxPairFlag::eNOTIFY_TOUCH_LOST;
+    }
 
     return physx::PxFilterFlag::eDEFAULT;
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <vector>
 
 #include <PxPhysics.h>
@@ -16,8 +18,24 @@ namespace physics {
  * @brief Class used to handle all physics related functionality for aderite
  */
 class PhysicsController final {
+public:
     static constexpr float c_FixedUpdateWindow = 0.02f;
 
+    /**
+     * @brief Most fixed steps run by a single update, time past this is dropped so that a slow frame doesn't make the
+     * next one even slower
+     */
+    static constexpr uint32_t c_MaxSubsteps = 4;
+
+    /**
+     * @brief Measurements of the last update
+     */
+    struct Timings {
+        uint32_t Steps = 0;      // Fixed steps run
+        double SimulateMs = 0.0; // From starting the last step until its results were fetched
+        double WaitMs = 0.0;     // Time the main thread was blocked waiting for the simulation
+    };
+
 public:
     /**
      * @brief Initializes the physics controller
@@ -30,11 +48,38 @@ public:
     void shutdown();
 
     /**
-     * @brief Function invoked by the engine when it's time to update physics
+     * @brief Function invoked by the engine when it's time to update physics, runs the fixed steps the accumulated time
+     * allows for. In asynchronous mode the last step keeps running after this returns and its results are fetched with
+     * fetchResults, so the simulation overlaps with the rest of the frame.
      * @param delta Delta between two frames
      */
     void update(float delta);
 
+    /**
+     * @brief Waits for the step started by update to finish and sends its events, does nothing if no step is running
+     */
+    void fetchResults();
+
+    /**
+     * @brief Returns how far between the last two fixed steps the current frame is, in [0, 1)
+     */
+    float getInterpolation() const;
+
+    /**
+     * @brief Returns true if steps are simulated asynchronously
+     */
+    bool isAsync() const;
+
+    /**
+     * @brief Sets if steps are simulated asynchronously, otherwise update blocks until the steps are done
+     */
+    void setAsync(bool value);
+
+    /**
+     * @brief Returns the measurements of the last update
+     */
+    const Timings& getTimings() const;
+
     /**
      * @brief Returns the PhysX physics object instance
      */
@@ -57,8 +102,8 @@ public:
      * @param attributes1 Attributes of the second actor
      * @param filterData1 Filter data of the second actor
      * @param pairFlags Pair flags that are returned
-     * @param constantBlock -
-     * @param constantBlockSize -
+     * @param constantBlock Collision matrix of the scene
+     * @param constantBlockSize Size of the collision matrix
      * @return Filter flag, to be suppressed or not
      */
     static physx::PxFilterFlags filterShader(physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
@@ -73,14 +118,17 @@ private:
     physx::PxFoundation* m_foundation = nullptr;
     physx::PxPhysics* m_physics = nullptr;
     physx::PxCooking* m_cooking = nullptr;
-    physx::PxDefaultCpuDispatcher* m_dispatcher = nullptr;
+    JobDispatcher* m_dispatcher = nullptr;
     physx::PxMaterial* m_defaultMaterial = nullptr;
     physx::PxPvd* m_pvd = nullptr;
 
     float m_accumulator = 0.0f;
+    float m_interpolation = 0.0f;
+    bool m_async = true;
+    Timings m_timings;
+    std::chrono::high_resolution_clock::time_point m_stepStart;
 
     bool m_recordMemoryAllocations = true;
-    size_t m_numThreads = 2;
 
     float m_defaultStaticFriction = 0.5f;
     float m_defaultDynamicFriction = 0.5f;
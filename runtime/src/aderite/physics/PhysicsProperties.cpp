@@ -38,16 +38,26 @@ void PhysicsProperties::resetGeometryChangedFlag() {
     m_geometryChanged = false;
 }
 
+bool PhysicsProperties::havePropertiesChanged() const {
+    return m_propertiesChanged;
+}
+
+void PhysicsProperties::resetPropertiesChangedFlag() {
+    m_propertiesChanged = false;
+}
+
 bool PhysicsProperties::isDynamic() const {
     return m_dynamic;
 }
 
 void PhysicsProperties::makeStatic() {
     m_dynamic = false;
+    m_propertiesChanged = true;
 }
 
 void PhysicsProperties::makeDynamic() {
     m_dynamic = true;
+    m_propertiesChanged = true;
 }
 
 bool PhysicsProperties::hasGravity() const {
@@ -56,10 +66,12 @@ bool PhysicsProperties::hasGravity() const {
 
 void PhysicsProperties::disableGravity() {
     m_hasGravity = false;
+    m_propertiesChanged = true;
 }
 
 void PhysicsProperties::enableGravity() {
     m_hasGravity = true;
+    m_propertiesChanged = true;
 }
 
 float PhysicsProperties::getMass() const {
@@ -68,6 +80,7 @@ float PhysicsProperties::getMass() const {
 
 void PhysicsProperties::setMass(float mass) {
     m_mass = mass;
+    m_propertiesChanged = true;
 }
 
 bool PhysicsProperties::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
@@ -99,6 +112,7 @@ bool PhysicsProperties::deserialize(io::Serializer* serializer, const YAML::Node
     m_dynamic = actorNode["Dynamic"].as<bool>();
     m_mass = actorNode["Mass"].as<float>();
     m_hasGravity = actorNode["HasGravity"].as<bool>();
+    m_propertiesChanged = true;
 
     // Geometry
     for (const YAML::Node& geometryNode : actorNode["Geometry"]) {
@@ -113,6 +127,7 @@ PhysicsProperties& PhysicsProperties::operator=(const PhysicsProperties& other)
     m_dynamic = other.m_dynamic;
     m_hasGravity = other.m_hasGravity;
     m_mass = other.m_mass;
+    m_propertiesChanged = true;
 
     // Copy geometry
     m_geometryChanged = true;
@@ -41,6 +41,16 @@ public:
      */
     void resetGeometryChangedFlag();
 
+    /**
+     * @brief Returns true if the body type, gravity or mass changed since the flag was last reset
+     */
+    bool havePropertiesChanged() const;
+
+    /**
+     * @brief Resets the properties change flag
+     */
+    void resetPropertiesChangedFlag();
+
     /**
      * @brief Returns true if the actor should be dynamic
      */
@@ -90,6 +100,7 @@ public:
 
 private:
     bool m_dynamic = false;
+    bool m_propertiesChanged = true; // Applied to the actor on the first update
 
     bool m_geometryChanged = false;
     std::vector<physics::Geometry*> m_geometry;
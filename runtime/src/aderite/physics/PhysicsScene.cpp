@@ -1,5 +1,8 @@
 #include "PhysicsScene.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "aderite/Aderite.hpp"
 #include "aderite/physics/PhysXActor.hpp"
 #include "aderite/physics/PhysicsController.hpp"
@@ -7,23 +10,123 @@
 #include "aderite/physics/PhysicsSceneQuery.hpp"
 #include "aderite/physics/geometry/Geometry.hpp"
 #include "aderite/scene/GameObject.hpp"
+#include "aderite/threading/JobSystem.hpp"
 #include "aderite/utility/Log.hpp"
 
 namespace aderite {
 namespace physics {
 
+/**
+ * @brief Runs every query of a batch on the job system, query(index, hits) writes the hits of a query and returns their
+ * count. Every query owns its part of the results so the jobs don't need to synchronize.
+ */
+template<typename Fn>
+static void runBatch(physx::PxScene* scene, size_t count, QueryResults& results, Fn query) {
+    constexpr size_t maxHits = PhysicsScene::c_MaxQueryHits;
+
+    // Pending query structure updates would otherwise be applied by whichever job queries first
+    scene->flushQueryUpdates();
+
+    results.Hits.resize(count * maxHits);
+    results.Ranges.resize(count);
+
+    threading::JobSystem* jobSystem = ::aderite::Engine::getJobSystem();
+    std::vector<threading::JobHandle> jobs;
+    for (size_t first = 0; first < count; first += PhysicsScene::c_QueryBatchSize) {
+        const size_t last = std::min(first + PhysicsScene::c_QueryBatchSize, count);
+        jobs.push_back(jobSystem->schedule(
+            [&results, &query, first, last]() {
+                for (size_t i = first; i < last; i++) {
+                    RaycastResult* hits = &results.Hits[i * maxHits];
+                    const size_t found = query(i, hits);
+                    std::sort(hits, hits + found, [](const RaycastResult& a, const RaycastResult& b) {
+                        return a.Distance < b.Distance;
+                    });
+                    results.Ranges[i] = {i * maxHits, found};
+                }
+            },
+            threading::Job::Priority::CRITICAL));
+    }
+
+    // Only help with frame critical work, a load picked up here would stall the caller
+    for (const threading::JobHandle& job : jobs) {
+        jobSystem->wait(job, threading::Job::Priority::CRITICAL);
+    }
+}
+
+/**
+ * @brief Normalizes the direction of a query, PhysX expects unit directions and non negative distances. Queries with a
+ * zero or non finite direction or an invalid distance are not passed on and have no hits.
+ * @param direction Direction of the query
+ * @param maxDistance Distance of the query
+ * @param normalized Unit direction
+ * @return True if the query is valid
+ */
+static bool normalizeQuery(const glm::vec3& direction, float maxDistance, glm::vec3& normalized) {
+    const float length = glm::length(direction);
+    if (!std::isfinite(length) || length < 1e-6f || !std::isfinite(maxDistance) || maxDistance < 0.0f) {
+        return false;
+    }
+
+    normalized = direction / length;
+    return true;
+}
+
+/**
+ * @brief Returns query filter data, layer mask 0 isn't filtered by PhysX
+ * @param layerMask Layers to hit
+ * @param all If true every hit is reported instead of only the closest one
+ */
+static physx::PxQueryFilterData makeFilter(uint32_t layerMask, bool all) {
+    physx::PxQueryFilterData filter;
+    filter.data.word0 = layerMask;
+    filter.flags = physx::PxQueryFlag::eSTATIC | physx::PxQueryFlag::eDYNAMIC;
+    if (all) {
+        filter.flags |= physx::PxQueryFlag::eNO_BLOCK;
+    }
+
+    return filter;
+}
+
+/**
+ * @brief Returns the PhysX geometry of a query shape
+ */
+static physx::PxGeometryHolder makeGeometry(QueryShape shape, const glm::vec3& size) {
+    switch (shape) {
+    case QueryShape::BOX: {
+        return physx::PxGeometryHolder(physx::PxBoxGeometry(size.x, size.y, size.z));
+    }
+    case QueryShape::SPHERE:
+    default: {
+        return physx::PxGeometryHolder(physx::PxSphereGeometry(size.x));
+    }
+    }
+}
+
+/**
+ * @brief Returns the PhysX pose of a query shape
+ */
+static physx::PxTransform makePose(const glm::vec3& position, const glm::quat& rotation) {
+    return physx::PxTransform({position.x, position.y, position.z}, {rotation.x, rotation.y, rotation.z, rotation.w});
+}
+
 PhysicsScene::PhysicsScene() {
     LOG_TRACE("[Physics] Creating physics scene");
 
     auto physics = ::aderite::Engine::getPhysicsController()->getPhysics();
 
+    // Every layer collides with every other
+    m_collisionMatrix.fill(UINT32_MAX);
+
     // TODO: Configure physics properties
     physx::PxSceneDesc sceneDesc(physics->getTolerancesScale());
     sceneDesc.gravity = physx::PxVec3(0.0f, -9.81f, 0.0f);
     sceneDesc.cpuDispatcher = ::aderite::Engine::getPhysicsController()->getDispatcher();
     sceneDesc.filterShader = physics::PhysicsController::filterShader;
+    sceneDesc.filterShaderData = m_collisionMatrix.data();
+    sceneDesc.filterShaderDataSize = sizeof(m_collisionMatrix);
     sceneDesc.simulationEventCallback = this;
-    // sceneDesc.flags = physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS;
+    sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS;
     m_scene = physics->createScene(sceneDesc);
     m_scene->userData = this;
     ADERITE_DYNAMIC_ASSERT(m_scene != nullptr, "Failed to create a PhysX scene");
@@ -37,6 +140,9 @@ PhysicsScene::PhysicsScene() {
 PhysicsScene::~PhysicsScene() {
     LOG_TRACE("[Physics] Destroying physics scene");
 
+    // Can't release a scene that is simulating
+    this->fetchResults();
+
     if (m_scene != nullptr) {
         m_scene->release();
     } else {
@@ -48,15 +154,101 @@ PhysicsScene::~PhysicsScene() {
     LOG_INFO("[Physics] Physics scene destroyed");
 }
 
-void PhysicsScene::simulate(float step) const {
+void PhysicsScene::simulate(float step) {
+    ADERITE_DYNAMIC_ASSERT(!m_simulating, "Physics step started before the results of the previous one were fetched");
     m_scene->simulate(step);
+    m_simulating = true;
+}
+
+void PhysicsScene::fetchResults() {
+    if (!m_simulating) {
+        return;
+    }
+
     m_scene->fetchResults(true);
+    m_simulating = false;
+    m_stepCount++;
+
+    for (physx::PxRigidActor* actor : m_pendingFiltering) {
+        m_scene->resetFiltering(*actor);
+    }
+    m_pendingFiltering.clear();
+
+    // Only actors that moved, sleeping and static actors are left alone
+    physx::PxU32 count = 0;
+    physx::PxActor** actors = m_scene->getActiveActors(count);
+    for (physx::PxU32 i = 0; i < count; i++) {
+        PhysXActor* owner = static_cast<PhysXActor*>(actors[i]->userData);
+        if (owner != nullptr) {
+            owner->onStep(m_stepCount);
+        }
+    }
+}
+
+bool PhysicsScene::isSimulating() const {
+    return m_simulating;
+}
+
+uint64_t PhysicsScene::getStepCount() const {
+    return m_stepCount;
+}
+
+void PhysicsScene::setLayersCollide(uint8_t layer0, uint8_t layer1, bool value) {
+    ADERITE_DYNAMIC_ASSERT(layer0 < c_LayerCount && layer1 < c_LayerCount, "Collision layer out of range");
+
+    if (value) {
+        m_collisionMatrix[layer0] |= 1u << layer1;
+        m_collisionMatrix[layer1] |= 1u << layer0;
+    } else {
+        m_collisionMatrix[layer0] &= ~(1u << layer1);
+        m_collisionMatrix[layer1] &= ~(1u << layer0);
+    }
+
+    this->applyCollisionMatrix();
+}
+
+bool PhysicsScene::doLayersCollide(uint8_t layer0, uint8_t layer1) const {
+    return (m_collisionMatrix[layer0] & (1u << layer1)) != 0;
+}
+
+void PhysicsScene::applyCollisionMatrix() {
+    ADERITE_DYNAMIC_ASSERT(!m_simulating, "Collision matrix changed while the scene is simulating");
+
+    // PhysX keeps its own copy of the data
+    m_scene->setFilterShaderData(m_collisionMatrix.data(), sizeof(m_collisionMatrix));
+
+    // Existing pairs were filtered with the old matrix
+    const physx::PxActorTypeFlags types = physx::PxActorTypeFlag::eRIGID_STATIC | physx::PxActorTypeFlag::eRIGID_DYNAMIC;
+    std::vector<physx::PxActor*> actors(m_scene->getNbActors(types));
+    m_scene->getActors(types, actors.data(), static_cast<physx::PxU32>(actors.size()));
+    for (physx::PxActor* actor : actors) {
+        m_scene->resetFiltering(*actor);
+    }
 }
 
 void PhysicsScene::addActor(PhysXActor* actor) {
     m_scene->addActor(*actor->getActor());
 }
 
+void PhysicsScene::removeActor(PhysXActor* actor) {
+    physx::PxRigidActor* rigidActor = actor->getActor();
+    m_pendingFiltering.erase(std::remove(m_pendingFiltering.begin(), m_pendingFiltering.end(), rigidActor),
+                             m_pendingFiltering.end());
+    m_scene->removeActor(*rigidActor);
+}
+
+void PhysicsScene::resetFiltering(physx::PxRigidActor* actor) {
+    if (!m_simulating) {
+        m_scene->resetFiltering(*actor);
+        return;
+    }
+
+    // PhysX doesn't allow refiltering while a step is running
+    if (std::find(m_pendingFiltering.begin(), m_pendingFiltering.end(), actor) == m_pendingFiltering.end()) {
+        m_pendingFiltering.push_back(actor);
+    }
+}
+
 void PhysicsScene::sendEvents() {
     for (const TriggerEvent& te : m_events->getTriggerEvents()) {
         if (te.Enter) {
@@ -83,8 +275,14 @@ void PhysicsScene::sendEvents() {
 }
 
 bool PhysicsScene::raycastSingle(RaycastResult& result, const glm::vec3& from, const glm::vec3& direction, float maxDistance) {
+    glm::vec3 unit;
+    if (!normalizeQuery(direction, maxDistance, unit)) {
+        LOG_WARN("[Physics] Raycast with a zero direction or an invalid distance was ignored");
+        return false;
+    }
+
     physx::PxRaycastBuffer hit;
-    const bool hadHit = m_scene->raycast({from.x, from.y, from.z}, {direction.x, direction.y, direction.z}, maxDistance, hit);
+    const bool hadHit = m_scene->raycast({from.x, from.y, from.z}, {unit.x, unit.y, unit.z}, maxDistance, hit);
     if (!hadHit) {
         // No hits
         return false;
@@ -97,6 +295,66 @@ bool PhysicsScene::raycastSingle(RaycastResult& result, const glm::vec3& from, c
     return true;
 }
 
+void PhysicsScene::raycastBatch(const std::vector<RaycastQuery>& queries, QueryResults& results) const {
+    runBatch(m_scene, queries.size(), results, [this, &queries](size_t index, RaycastResult* hits) {
+        const RaycastQuery& query = queries[index];
+        glm::vec3 direction;
+        if (!normalizeQuery(query.Direction, query.MaxDistance, direction)) {
+            return size_t(0);
+        }
+
+        physx::PxRaycastHit touches[c_MaxQueryHits];
+        physx::PxRaycastBuffer buffer(touches, c_MaxQueryHits);
+        m_scene->raycast({query.From.x, query.From.y, query.From.z}, {direction.x, direction.y, direction.z}, query.MaxDistance, buffer,
+                         physx::PxHitFlag::eDEFAULT, makeFilter(query.LayerMask, true));
+
+        for (physx::PxU32 i = 0; i < buffer.getNbTouches(); i++) {
+            hits[i] = {static_cast<PhysXActor*>(touches[i].actor->userData), touches[i].distance};
+        }
+
+        return static_cast<size_t>(buffer.getNbTouches());
+    });
+}
+
+void PhysicsScene::sweepBatch(const std::vector<SweepQuery>& queries, QueryResults& results) const {
+    runBatch(m_scene, queries.size(), results, [this, &queries](size_t index, RaycastResult* hits) {
+        const SweepQuery& query = queries[index];
+        glm::vec3 direction;
+        if (!normalizeQuery(query.Direction, query.MaxDistance, direction)) {
+            return size_t(0);
+        }
+
+        physx::PxSweepBuffer buffer;
+        m_scene->sweep(makeGeometry(query.Shape, query.Size).any(), makePose(query.From, query.Rotation),
+                       {direction.x, direction.y, direction.z}, query.MaxDistance, buffer, physx::PxHitFlag::eDEFAULT,
+                       makeFilter(query.LayerMask, false));
+
+        if (!buffer.hasBlock) {
+            return size_t(0);
+        }
+
+        hits[0] = {static_cast<PhysXActor*>(buffer.block.actor->userData), buffer.block.distance};
+        return size_t(1);
+    });
+}
+
+void PhysicsScene::overlapBatch(const std::vector<OverlapQuery>& queries, QueryResults& results) const {
+    runBatch(m_scene, queries.size(), results, [this, &queries](size_t index, RaycastResult* hits) {
+        const OverlapQuery& query = queries[index];
+
+        physx::PxOverlapHit touches[c_MaxQueryHits];
+        physx::PxOverlapBuffer buffer(touches, c_MaxQueryHits);
+        m_scene->overlap(makeGeometry(query.Shape, query.Size).any(), makePose(query.Position, query.Rotation), buffer,
+                         makeFilter(query.LayerMask, true));
+
+        for (physx::PxU32 i = 0; i < buffer.getNbTouches(); i++) {
+            hits[i] = {static_cast<PhysXActor*>(touches[i].actor->userData), 0.0f};
+        }
+
+        return static_cast<size_t>(buffer.getNbTouches());
+    });
+}
+
 void PhysicsScene::onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs) {
     for (physx::PxU32 i = 0; i < nbPairs; i++) {
         const physx::PxContactPair& cp = pairs[i];
@@ -145,6 +403,11 @@ void PhysicsScene::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 nbPairs)
 
 bool PhysicsScene::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
     emitter << YAML::Key << "PhysicsScene" << YAML::BeginMap;
+    emitter << YAML::Key << "CollisionMatrix" << YAML::Flow << YAML::BeginSeq;
+    for (uint32_t row : m_collisionMatrix) {
+        emitter << row;
+    }
+    emitter << YAML::EndSeq;
     emitter << YAML::EndMap;
 
     return true;
@@ -156,6 +419,20 @@ bool PhysicsScene::deserialize(io::Serializer* serializer, const YAML::Node& dat
         return false;
     }
 
+    const YAML::Node& matrixNode = physicsNode["CollisionMatrix"];
+    if (matrixNode) {
+        if (matrixNode.size() != c_LayerCount) {
+            LOG_ERROR("[Physics] Collision matrix has {0} rows instead of {1}", matrixNode.size(), static_cast<size_t>(c_LayerCount));
+            return false;
+        }
+
+        for (size_t i = 0; i < c_LayerCount; i++) {
+            m_collisionMatrix[i] = matrixNode[i].as<uint32_t>();
+        }
+
+        this->applyCollisionMatrix();
+    }
+
     return true;
 }
 
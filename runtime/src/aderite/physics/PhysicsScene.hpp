@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include <PxSimulationEventCallback.h>
 #include <glm/glm.hpp>
 
@@ -15,15 +19,60 @@ namespace physics {
  * @brief Physics scene for aderite
  */
 class PhysicsScene : public physx::PxSimulationEventCallback, public io::ISerializable {
+public:
+    /**
+     * @brief Most hits a single query of a batch reports
+     */
+    static constexpr size_t c_MaxQueryHits = 16;
+
+    /**
+     * @brief Number of queries of a batch executed by a single job
+     */
+    static constexpr size_t c_QueryBatchSize = 64;
+
+    /**
+     * @brief Number of collision layers, every geometry is on exactly one
+     */
+    static constexpr uint8_t c_LayerCount = 32;
+
 public:
     PhysicsScene();
     virtual ~PhysicsScene();
 
     /**
-     * @brief Physics update
+     * @brief Starts a physics step, the step runs on the PhysX dispatcher until fetchResults is called
      * @param step Fixed step size
      */
-    void simulate(float step) const;
+    void simulate(float step);
+
+    /**
+     * @brief Waits for the running step to finish and applies its results, does nothing if no step is running
+     */
+    void fetchResults();
+
+    /**
+     * @brief Returns true if a step was started and its results weren't fetched yet
+     */
+    bool isSimulating() const;
+
+    /**
+     * @brief Returns the number of steps whose results were fetched
+     */
+    uint64_t getStepCount() const;
+
+    /**
+     * @brief Sets if geometries on the two layers can collide, all layers collide by default, can't be called while the
+     * scene is simulating
+     * @param layer0 First layer
+     * @param layer1 Second layer
+     * @param value True if the layers collide, false otherwise
+     */
+    void setLayersCollide(uint8_t layer0, uint8_t layer1, bool value);
+
+    /**
+     * @brief Returns true if geometries on the two layers can collide
+     */
+    bool doLayersCollide(uint8_t layer0, uint8_t layer1) const;
 
     /**
      * @brief Add actor to the scene
@@ -31,6 +80,19 @@ public:
      */
     void addActor(PhysXActor* actor);
 
+    /**
+     * @brief Removes the actor from the scene
+     * @param actor Actor to remove
+     */
+    void removeActor(PhysXActor* actor);
+
+    /**
+     * @brief Refilters the pairs of the actor after the filter data of its shapes changed, deferred until the results of
+     * a running step are fetched
+     * @param actor PhysX actor in this scene
+     */
+    void resetFiltering(physx::PxRigidActor* actor);
+
     /**
      * @brief Sends queued physics events to specified user callbacks
      */
@@ -46,6 +108,29 @@ public:
      */
     bool raycastSingle(RaycastResult& result, const glm::vec3& from, const glm::vec3& direction, float maxDistance);
 
+    /**
+     * @brief Casts every ray of the batch, the rays are split between the job system workers. Rays with a zero or non
+     * finite direction or a negative distance have no hits.
+     * @param queries Rays to cast
+     * @param results Every hit of every ray, at most c_MaxQueryHits per ray
+     */
+    void raycastBatch(const std::vector<RaycastQuery>& queries, QueryResults& results) const;
+
+    /**
+     * @brief Sweeps every shape of the batch, the sweeps are split between the job system workers. Sweeps with a zero or
+     * non finite direction or a negative distance have no hits.
+     * @param queries Sweeps to do
+     * @param results First hit of every sweep
+     */
+    void sweepBatch(const std::vector<SweepQuery>& queries, QueryResults& results) const;
+
+    /**
+     * @brief Finds the actors every shape of the batch overlaps, the queries are split between the job system workers
+     * @param queries Overlaps to test
+     * @param results Overlapped actors of every query, at most c_MaxQueryHits per query
+     */
+    void overlapBatch(const std::vector<OverlapQuery>& queries, QueryResults& results) const;
+
 protected:
     // Inherited via ISerializable
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
@@ -60,9 +145,23 @@ private:
     void onSleep(physx::PxActor**, physx::PxU32) override {}
     void onAdvance(const physx::PxRigidBody* const*, const physx::PxTransform*, const physx::PxU32) override {}
 
+private:
+    /**
+     * @brief Passes the collision matrix to the filter shader and refilters every pair
+     */
+    void applyCollisionMatrix();
+
 private:
     physx::PxScene* m_scene = nullptr;
     PhysicsEventList* m_events = nullptr;
+    bool m_simulating = false;
+    uint64_t m_stepCount = 0;
+
+    // Row per layer, bit per layer it collides with
+    std::array<uint32_t, c_LayerCount> m_collisionMatrix;
+
+    // Actors whose filter data changed while the scene was simulating
+    std::vector<physx::PxRigidActor*> m_pendingFiltering;
 };
 
 } // namespace physics
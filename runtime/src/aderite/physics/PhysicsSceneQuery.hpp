@@ -1,5 +1,11 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
 #include "aderite/physics/Forward.hpp"
 
 namespace aderite {
@@ -20,5 +26,65 @@ struct RaycastResult {
     float Distance = 0.0f;
 };
 
+/**
+ * @brief Shape used by sweep and overlap queries
+ */
+enum class QueryShape {
+    SPHERE = 0, // Size.x is the radius
+    BOX = 1,    // Size is the half extents
+};
+
+/**
+ * @brief Ray that reports every hit along it
+ */
+struct RaycastQuery {
+    glm::vec3 From = {0.0f, 0.0f, 0.0f};
+    glm::vec3 Direction = {0.0f, 0.0f, 1.0f};
+    float MaxDistance = 0.0f;
+
+    /**
+     * @brief Only shapes whose query filter data shares a bit with the mask are hit, 0 hits everything
+     */
+    uint32_t LayerMask = 0;
+};
+
+/**
+ * @brief Shape moved along a direction that reports the first hit
+ */
+struct SweepQuery {
+    QueryShape Shape = QueryShape::SPHERE;
+    glm::vec3 Size = {0.5f, 0.5f, 0.5f};
+    glm::vec3 From = {0.0f, 0.0f, 0.0f};
+    glm::quat Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 Direction = {0.0f, 0.0f, 1.0f};
+    float MaxDistance = 0.0f;
+    uint32_t LayerMask = 0;
+};
+
+/**
+ * @brief Shape that reports every actor it overlaps, distances of overlap hits are 0
+ */
+struct OverlapQuery {
+    QueryShape Shape = QueryShape::SPHERE;
+    glm::vec3 Size = {0.5f, 0.5f, 0.5f};
+    glm::vec3 Position = {0.0f, 0.0f, 0.0f};
+    glm::quat Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    uint32_t LayerMask = 0;
+};
+
+/**
+ * @brief Results of a batch of queries, the hits of query i are Hits[Ranges[i].First, Ranges[i].First + Ranges[i].Count)
+ * sorted by distance
+ */
+struct QueryResults {
+    struct Range {
+        size_t First = 0;
+        size_t Count = 0;
+    };
+
+    std::vector<RaycastResult> Hits;
+    std::vector<Range> Ranges;
+};
+
 } // namespace physics
 } // namespace aderite
@@ -27,6 +27,9 @@ BoxGeometry::BoxGeometry() {
 
     // Set user data
     p_shape->userData = this;
+
+    // Default layer, collides with everything
+    this->applyFilterData();
 }
 
 glm::vec3 BoxGeometry::getSize() const {
@@ -52,12 +55,20 @@ void BoxGeometry::applyScale(const glm::vec3& scale) {
 bool BoxGeometry::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
     emitter << YAML::Key << "Size" << YAML::Value << m_size;
     emitter << YAML::Key << "IsTrigger" << YAML::Value << this->isTrigger();
+    emitter << YAML::Key << "Layer" << YAML::Value << static_cast<uint32_t>(this->getLayer());
+    emitter << YAML::Key << "CollisionMask" << YAML::Value << this->getCollisionMask();
     return true;
 }
 
 bool BoxGeometry::deserialize(io::Serializer* serializer, const YAML::Node& data) {
     setSize(data["Size"].as<glm::vec3>());
     setTrigger(data["IsTrigger"].as<bool>());
+    if (data["Layer"]) {
+        setLayer(static_cast<uint8_t>(data["Layer"].as<uint32_t>()));
+    }
+    if (data["CollisionMask"]) {
+        setCollisionMask(data["CollisionMask"].as<uint32_t>());
+    }
     return true;
 }
 
@@ -69,6 +80,8 @@ Geometry* BoxGeometry::clone() {
     BoxGeometry* bg = new BoxGeometry();
     bg->setSize(bg->getSize());
     bg->setName(bg->getName());
+    bg->setLayer(this->getLayer());
+    bg->setCollisionMask(this->getCollisionMask());
     return bg;
 }
 
@@ -1,6 +1,11 @@
 #include "Geometry.hpp"
 
 #include <PxRigidActor.h>
+#include <PxScene.h>
+
+#include "aderite/physics/PhysicsScene.hpp"
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
 
 namespace aderite {
 namespace physics {
@@ -43,5 +48,50 @@ void Geometry::setTrigger(bool value) {
     p_shape->setFlag(physx::PxShapeFlag::eTRIGGER_SHAPE, value);
 }
 
+uint8_t Geometry::getLayer() const {
+    return m_layer;
+}
+
+void Geometry::setLayer(uint8_t layer) {
+    ADERITE_DYNAMIC_ASSERT(layer < PhysicsScene::c_LayerCount, "Collision layer out of range");
+    m_layer = layer;
+    this->applyFilterData();
+}
+
+uint32_t Geometry::getCollisionMask() const {
+    return m_collisionMask;
+}
+
+void Geometry::setCollisionMask(uint32_t mask) {
+    m_collisionMask = mask;
+    this->applyFilterData();
+}
+
+uint32_t Geometry::getListeners() const {
+    return m_listeners;
+}
+
+void Geometry::setListeners(uint32_t listeners) {
+    if (m_listeners == listeners) {
+        return;
+    }
+
+    m_listeners = listeners;
+    this->applyFilterData();
+}
+
+void Geometry::applyFilterData() {
+    // word0 layer bit, word1 collision mask, word2 listeners, word3 layer index, read by PhysicsController::filterShader
+    const physx::PxU32 layerBit = 1u << m_layer;
+    p_shape->setSimulationFilterData(physx::PxFilterData(layerBit, m_collisionMask, m_listeners, m_layer));
+    p_shape->setQueryFilterData(physx::PxFilterData(layerBit, 0, 0, 0));
+
+    // Existing pairs keep their flags until refiltered
+    physx::PxRigidActor* actor = p_shape->getActor();
+    if (actor != nullptr && actor->getScene() != nullptr) {
+        static_cast<PhysicsScene*>(actor->getScene()->userData)->resetFiltering(actor);
+    }
+}
+
 } // namespace physics
 } // namespace aderite
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include <glm/glm.hpp>
@@ -16,6 +17,17 @@ namespace physics {
  * @brief Geometry is the interface class for geometry types for collider shapes
  */
 class Geometry : public io::SerializableObject {
+public:
+    /**
+     * @brief Listener flag of geometries whose game object has behaviors handling collision events
+     */
+    static constexpr uint32_t c_ListenCollisions = 1 << 0;
+
+    /**
+     * @brief Listener flag of geometries whose game object has behaviors handling trigger events
+     */
+    static constexpr uint32_t c_ListenTriggers = 1 << 1;
+
 public:
     Geometry();
     virtual ~Geometry();
@@ -41,6 +53,41 @@ public:
      */
     void setTrigger(bool value);
 
+    /**
+     * @brief Returns the collision layer of the geometry
+     */
+    uint8_t getLayer() const;
+
+    /**
+     * @brief Sets the collision layer of the geometry, the layer is also the bit scene queries filter the geometry by
+     * @param layer Layer index, less than PhysicsScene::c_LayerCount
+     */
+    void setLayer(uint8_t layer);
+
+    /**
+     * @brief Returns the mask of layers this geometry can collide with
+     */
+    uint32_t getCollisionMask() const;
+
+    /**
+     * @brief Sets the mask of layers this geometry can collide with, a pair collides only if both masks and the layer
+     * matrix of the scene allow it
+     * @param mask Layer mask
+     */
+    void setCollisionMask(uint32_t mask);
+
+    /**
+     * @brief Returns the listener flags of the geometry
+     */
+    uint32_t getListeners() const;
+
+    /**
+     * @brief Sets which events the game object of the geometry listens to, pairs where neither side listens don't
+     * generate events
+     * @param listeners Combination of c_ListenCollisions and c_ListenTriggers
+     */
+    void setListeners(uint32_t listeners);
+
     /**
      * @brief Apply scale to geometry
      * @param scale Scale to apply
@@ -52,8 +99,20 @@ public:
      */
     virtual Geometry* clone() = 0;
 
+protected:
+    /**
+     * @brief Writes the layer, mask and listeners to the shape filter data and refilters the pairs of its actor, can't
+     * be called while the scene is simulating
+     */
+    void applyFilterData();
+
 protected:
     physx::PxShape* p_shape = nullptr;
+
+private:
+    uint8_t m_layer = 0;
+    uint32_t m_collisionMask = UINT32_MAX;
+    uint32_t m_listeners = 0;
 };
 
 } // namespace physics
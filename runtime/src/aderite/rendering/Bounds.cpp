@@ -0,0 +1,140 @@
+#include "Bounds.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "aderite/utility/Macros.hpp"
+
+#ifdef ADERITE_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace aderite {
+namespace rendering {
+
+Bounds Bounds::fromPoints(const float* positions, size_t count, size_t stride) {
+    Bounds result;
+    if (count == 0) {
+        return result;
+    }
+
+    glm::vec3 min(FLT_MAX);
+    glm::vec3 max(-FLT_MAX);
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(positions);
+    for (size_t i = 0; i < count; i++) {
+        glm::vec3 point;
+        std::memcpy(&point, data + i * stride, sizeof(glm::vec3));
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    result.Center = (min + max) * 0.5f;
+    result.Extents = (max - min) * 0.5f;
+    result.Radius = glm::length(result.Extents);
+    return result;
+}
+
+Bounds Bounds::transform(const glm::mat4& matrix) const {
+    Bounds result;
+    result.Center = glm::vec3(matrix * glm::vec4(Center, 1.0f));
+
+    const glm::vec3 x = glm::vec3(matrix[0]);
+    const glm::vec3 y = glm::vec3(matrix[1]);
+    const glm::vec3 z = glm::vec3(matrix[2]);
+    result.Extents = glm::abs(x) * Extents.x + glm::abs(y) * Extents.y + glm::abs(z) * Extents.z;
+    result.Radius = Radius * std::sqrt(std::max({glm::dot(x, x), glm::dot(y, y), glm::dot(z, z)}));
+    return result;
+}
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    // Gribb/Hartmann plane extraction, glm matrices are column major so rows are gathered across columns
+    auto row = [&viewProjection](int i) {
+        return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    };
+
+    // The near plane uses the -1..1 depth range, for 0..1 backends this is a slightly larger volume which is still
+    // conservative
+    const glm::vec4 planes[6] = {
+        row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1), row(3) + row(2), row(3) - row(2),
+    };
+
+    for (size_t i = 0; i < c_PlaneCount; i++) {
+        glm::vec4 plane = planes[std::min<size_t>(i, 5)];
+        plane /= glm::length(glm::vec3(plane));
+        m_x[i] = plane.x;
+        m_y[i] = plane.y;
+        m_z[i] = plane.z;
+        m_w[i] = plane.w;
+    }
+}
+
+bool Frustum::testSphere(const glm::vec3& center, float radius) const {
+#ifdef ADERITE_SIMD_SSE
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    const __m128 r = _mm_set1_ps(-radius);
+
+    int outside = 0;
+    for (size_t i = 0; i < c_PlaneCount; i += 4) {
+        __m128 d = _mm_mul_ps(_mm_load_ps(m_x + i), cx);
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_load_ps(m_y + i), cy));
+        d = _mm_add_ps(d, _mm_mul_ps(_mm_load_ps(m_z + i), cz));
+        d = _mm_add_ps(d, _mm_load_ps(m_w + i));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(d, r));
+    }
+
+    return outside == 0;
+#else
+    for (size_t i = 0; i < c_PlaneCount; i++) {
+        if (m_x[i] * center.x + m_y[i] * center.y + m_z[i] * center.z + m_w[i] < -radius) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+bool Frustum::testBox(const glm::vec3& center, const glm::vec3& extents) const {
+#ifdef ADERITE_SIMD_SSE
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 cx = _mm_set1_ps(center.x);
+    const __m128 cy = _mm_set1_ps(center.y);
+    const __m128 cz = _mm_set1_ps(center.z);
+    const __m128 ex = _mm_set1_ps(extents.x);
+    const __m128 ey = _mm_set1_ps(extents.y);
+    const __m128 ez = _mm_set1_ps(extents.z);
+
+    int outside = 0;
+    for (size_t i = 0; i < c_PlaneCount; i += 4) {
+        const __m128 px = _mm_load_ps(m_x + i);
+        const __m128 py = _mm_load_ps(m_y + i);
+        const __m128 pz = _mm_load_ps(m_z + i);
+
+        // Distance of the center and the projected radius of the box onto the plane normal
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)), _mm_add_ps(_mm_mul_ps(pz, cz), _mm_load_ps(m_w + i)));
+        __m128 r = _mm_mul_ps(_mm_andnot_ps(signMask, px), ex);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_andnot_ps(signMask, py), ey));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_andnot_ps(signMask, pz), ez));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+    }
+
+    return outside == 0;
+#else
+    for (size_t i = 0; i < c_PlaneCount; i++) {
+        const float d = m_x[i] * center.x + m_y[i] * center.y + m_z[i] * center.z + m_w[i];
+        const float r = std::abs(m_x[i]) * extents.x + std::abs(m_y[i]) * extents.y + std::abs(m_z[i]) * extents.z;
+        if (d + r < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+#endif
+}
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Bounding volume of a mesh, an axis aligned box and the sphere enclosing it
+ */
+struct Bounds {
+    glm::vec3 Center = {0.0f, 0.0f, 0.0f};
+    glm::vec3 Extents = {0.0f, 0.0f, 0.0f};
+    float Radius = 0.0f;
+
+    /**
+     * @brief Computes the bounds of a set of points
+     * @param positions Pointer to the first position
+     * @param count Number of points
+     * @param stride Bytes between two positions
+     */
+    static Bounds fromPoints(const float* positions, size_t count, size_t stride);
+
+    /**
+     * @brief Returns the bounds transformed by the matrix, the box stays axis aligned so it grows with rotation
+     * @param matrix Transformation matrix
+     */
+    Bounds transform(const glm::mat4& matrix) const;
+};
+
+/**
+ * @brief View frustum planes extracted from a view projection matrix, stored as structure of arrays so that a volume
+ * is tested against 4 planes at once
+ */
+class Frustum final {
+public:
+    Frustum() = default;
+
+    /**
+     * @brief Extracts the frustum planes from the matrix
+     * @param viewProjection Combined view projection matrix
+     */
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    /**
+     * @brief Returns true if the sphere intersects or is inside the frustum
+     */
+    bool testSphere(const glm::vec3& center, float radius) const;
+
+    /**
+     * @brief Returns true if the axis aligned box intersects or is inside the frustum
+     */
+    bool testBox(const glm::vec3& center, const glm::vec3& extents) const;
+
+private:
+    // 6 planes padded to 8 by repeating the last one, normals point inside
+    static constexpr size_t c_PlaneCount = 8;
+
+    alignas(16) float m_x[c_PlaneCount] = {};
+    alignas(16) float m_y[c_PlaneCount] = {};
+    alignas(16) float m_z[c_PlaneCount] = {};
+    alignas(16) float m_w[c_PlaneCount] = {};
+};
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,224 @@
+#include "Culler.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#include "aderite/asset/MeshAsset.hpp"
+#include "aderite/rendering/DrawCall.hpp"
+#include "aderite/utility/Utility.hpp"
+
+namespace aderite {
+namespace rendering {
+
+CullingStats& CullingStats::operator+=(const CullingStats& other) {
+    Tested += other.Tested;
+    FrustumCulled += other.FrustumCulled;
+    OcclusionCulled += other.OcclusionCulled;
+    Visible += other.Visible;
+    Triangles += other.Triangles;
+    for (uint32_t i = 0; i < io::MeshCooker::c_MaxLods; i++) {
+        Lods[i] += other.Lods[i];
+    }
+    return *this;
+}
+
+/**
+ * @brief Picks the detail level for a screen size, starting from the previous level so thresholds have to be passed by
+ * the hysteresis margin
+ */
+static uint8_t selectLod(float screenSize, uint8_t previous, uint32_t lodCount) {
+    uint32_t lod = std::min<uint32_t>(previous, lodCount - 1);
+    while (lod + 1 < lodCount && screenSize < Culler::c_LodScreenSizes[lod] * (1.0f - Culler::c_LodHysteresis)) {
+        lod++;
+    }
+
+    while (lod > 0 && screenSize > Culler::c_LodScreenSizes[lod - 1] * (1.0f + Culler::c_LodHysteresis)) {
+        lod--;
+    }
+
+    return static_cast<uint8_t>(lod);
+}
+
+void Culler::cull(const glm::mat4& viewProjection, const std::unordered_map<size_t, DrawCall>& drawCalls, size_t camera) {
+    m_stats = {};
+    m_candidates.clear();
+    m_visible.clear();
+    m_transformations.clear();
+    m_cullCount++;
+
+    // Screen size of a sphere is radius * cot(fov / 2) / depth, the length of the y row of the matrix is cot(fov / 2)
+    const glm::vec4 depthRow = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+    const float projectionScale = glm::length(glm::vec3(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1]));
+
+    // 1. Frustum, the sphere rejects most instances cheaply and the box is tighter for the rest
+    const Frustum frustum(viewProjection);
+    for (const auto& kvp : drawCalls) {
+        const DrawCall& dc = kvp.second;
+        if (dc.Transformations.empty()) {
+            // Kept alive by the frame data to reuse its allocation, the assets may already be gone
+            continue;
+        }
+
+        const uint32_t lodCount = dc.Mesh->getLodCount();
+        LodState* state = nullptr;
+        if (lodCount > 1) {
+            state = &m_lodStates[utility::combineHash(camera, kvp.first)];
+            if (state->Lods.size() != dc.Transformations.size()) {
+                state->Lods.assign(dc.Transformations.size(), 0);
+            }
+
+            state->LastCull = m_cullCount;
+        }
+
+        const Bounds& local = dc.Mesh->getBounds();
+        for (size_t i = 0; i < dc.Transformations.size(); i++) {
+            const glm::mat4& transformation = dc.Transformations[i];
+            m_stats.Tested++;
+
+            const Bounds world = local.transform(transformation);
+            if (!frustum.testSphere(world.Center, world.Radius) || !frustum.testBox(world.Center, world.Extents)) {
+                m_stats.FrustumCulled++;
+                continue;
+            }
+
+            uint8_t lod = 0;
+            if (state != nullptr) {
+                const float depth = glm::dot(depthRow, glm::vec4(world.Center, 1.0f));
+                const float screenSize = depth > 0.0f ? world.Radius * projectionScale / depth : FLT_MAX;
+                lod = selectLod(screenSize, state->Lods[i], lodCount);
+                state->Lods[i] = lod;
+            }
+
+            m_candidates.push_back({&dc, &transformation, world, true, lod});
+        }
+    }
+
+    // Forget draw calls that are no longer rendered by any camera
+    for (auto it = m_lodStates.begin(); it != m_lodStates.end();) {
+        if (it->second.LastCull + c_LodStateCalls < m_cullCount) {
+            it = m_lodStates.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 2. Occlusion
+    if (m_occlusionCulling) {
+        this->occlude(viewProjection);
+    }
+
+    // 3. Pack, candidates of a draw call are contiguous and are split into one range per detail level
+    for (size_t first = 0; first < m_candidates.size();) {
+        const DrawCall* call = m_candidates[first].Call;
+        size_t last = first;
+        uint8_t maxLod = 0;
+        while (last < m_candidates.size() && m_candidates[last].Call == call) {
+            maxLod = std::max(maxLod, m_candidates[last].Lod);
+            last++;
+        }
+
+        for (uint8_t lod = 0; lod <= maxLod; lod++) {
+            const size_t before = m_transformations.size();
+            for (size_t i = first; i < last; i++) {
+                const Candidate& candidate = m_candidates[i];
+                if (candidate.Visible && candidate.Lod == lod) {
+                    m_transformations.push_back(*candidate.Transformation);
+                }
+            }
+
+            const size_t count = m_transformations.size() - before;
+            if (count == 0) {
+                continue;
+            }
+
+            m_visible.push_back({call, before, count, lod});
+            m_stats.Lods[lod] += static_cast<uint32_t>(count);
+            if (call->Mesh->getLodCount() > 0) {
+                m_stats.Triangles += static_cast<uint32_t>(count * (call->Mesh->getLod(lod).IndexCount / 3));
+            }
+        }
+
+        first = last;
+    }
+
+    m_stats.Visible = static_cast<uint32_t>(m_transformations.size());
+}
+
+void Culler::occlude(const glm::mat4& viewProjection) {
+    m_occlusion.clear();
+
+    // Front to back so that near occluders are in the buffer before far instances are tested
+    const glm::vec4 depthRow = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+    m_order.resize(m_candidates.size());
+    for (uint32_t i = 0; i < m_order.size(); i++) {
+        m_order[i] = i;
+    }
+
+    std::sort(m_order.begin(), m_order.end(), [this, &depthRow](uint32_t a, uint32_t b) {
+        return glm::dot(depthRow, glm::vec4(m_candidates[a].World.Center, 1.0f)) <
+               glm::dot(depthRow, glm::vec4(m_candidates[b].World.Center, 1.0f));
+    });
+
+    for (uint32_t index : m_order) {
+        Candidate& candidate = m_candidates[index];
+
+        // Screen rectangle and nearest depth of the box
+        glm::vec2 min(FLT_MAX);
+        glm::vec2 max(-FLT_MAX);
+        float nearest = FLT_MAX;
+        bool crossesNear = false;
+        for (int corner = 0; corner < 8; corner++) {
+            const glm::vec3 sign((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+            const glm::vec4 clip = viewProjection * glm::vec4(candidate.World.Center + sign * candidate.World.Extents, 1.0f);
+            if (clip.w <= 0.0f) {
+                crossesNear = true;
+                break;
+            }
+
+            const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+            min = glm::min(min, glm::vec2(ndc));
+            max = glm::max(max, glm::vec2(ndc));
+            nearest = std::min(nearest, ndc.z);
+        }
+
+        if (!crossesNear && !m_occlusion.isVisible(min, max, nearest)) {
+            candidate.Visible = false;
+            m_stats.OcclusionCulled++;
+            continue;
+        }
+
+        // Visible instances become occluders if the mesh has an occluder and covers enough of the screen
+        const OccluderMesh* occluder = candidate.Call->Mesh->getOccluder();
+        if (occluder == nullptr) {
+            continue;
+        }
+
+        const glm::vec2 size = (glm::min(max, glm::vec2(1.0f)) - glm::max(min, glm::vec2(-1.0f))) * 0.5f;
+        if (crossesNear || size.x * size.y >= c_MinOccluderArea) {
+            m_occlusion.rasterize(viewProjection * *candidate.Transformation, *occluder);
+        }
+    }
+}
+
+void Culler::setOcclusionCulling(bool enabled) {
+    m_occlusionCulling = enabled;
+}
+
+bool Culler::isOcclusionCullingEnabled() const {
+    return m_occlusionCulling;
+}
+
+const std::vector<VisibleDrawCall>& Culler::getVisible() const {
+    return m_visible;
+}
+
+const std::vector<glm::mat4>& Culler::getTransformations() const {
+    return m_transformations;
+}
+
+const CullingStats& Culler::getStats() const {
+    return m_stats;
+}
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "aderite/io/MeshCooker.hpp"
+#include "aderite/rendering/Bounds.hpp"
+#include "aderite/rendering/Forward.hpp"
+#include "aderite/rendering/OcclusionBuffer.hpp"
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Culling counters of a camera, summed over all cameras by the renderer
+ */
+struct CullingStats {
+    uint32_t Tested = 0;
+    uint32_t FrustumCulled = 0;
+    uint32_t OcclusionCulled = 0;
+    uint32_t Visible = 0;
+
+    // Triangles of the visible instances at their selected detail level
+    uint32_t Triangles = 0;
+
+    // Visible instances per detail level
+    uint32_t Lods[io::MeshCooker::c_MaxLods] = {};
+
+    CullingStats& operator+=(const CullingStats& other);
+};
+
+/**
+ * @brief Range of visible instances of a draw call inside the culler transformation array, drawn with the same detail
+ * level
+ */
+struct VisibleDrawCall {
+    const DrawCall* Call = nullptr;
+    size_t First = 0;
+    size_t Count = 0;
+    uint32_t Lod = 0;
+};
+
+/**
+ * @brief Per camera culling stage, tests every instance of every draw call against the camera frustum and optionally
+ * against a software occlusion buffer, selects the detail level of every visible instance from its screen size, then
+ * packs the visible transformations so they can be copied into instance buffers in one go
+ */
+class Culler final {
+public:
+    /**
+     * @brief Occluders smaller than this fraction of the screen are not rasterized
+     */
+    static constexpr float c_MinOccluderArea = 0.01f;
+
+    /**
+     * @brief Screen height fraction of the bounding sphere below which the next detail level is used
+     */
+    static constexpr float c_LodScreenSizes[io::MeshCooker::c_MaxLods - 1] = {0.25f, 0.12f, 0.05f};
+
+    /**
+     * @brief Fraction a screen size has to move past a threshold before the detail level changes, avoids popping back
+     * and forth around the threshold
+     */
+    static constexpr float c_LodHysteresis = 0.1f;
+
+    /**
+     * @brief Number of cull calls the detail levels of a draw call are remembered without it being culled
+     */
+    static constexpr uint64_t c_LodStateCalls = 256;
+
+public:
+    /**
+     * @brief Culls the draw calls for the camera, results are valid until the next call
+     * @param viewProjection View projection matrix of the camera
+     * @param drawCalls Draw calls of the frame
+     * @param camera Identifies the camera, detail levels of the previous call with the same camera are used for hysteresis
+     */
+    void cull(const glm::mat4& viewProjection, const std::unordered_map<size_t, DrawCall>& drawCalls, size_t camera = 0);
+
+    /**
+     * @brief Enables or disables software occlusion culling, frustum culling is always done
+     */
+    void setOcclusionCulling(bool enabled);
+
+    /**
+     * @brief Returns true if software occlusion culling is enabled
+     */
+    bool isOcclusionCullingEnabled() const;
+
+    /**
+     * @brief Returns the draw calls that have at least one visible instance
+     */
+    const std::vector<VisibleDrawCall>& getVisible() const;
+
+    /**
+     * @brief Returns the packed transformations of visible instances
+     */
+    const std::vector<glm::mat4>& getTransformations() const;
+
+    /**
+     * @brief Returns the counters of the last cull call
+     */
+    const CullingStats& getStats() const;
+
+private:
+    /**
+     * @brief Instance that passed the frustum test
+     */
+    struct Candidate {
+        const DrawCall* Call;
+        const glm::mat4* Transformation;
+        Bounds World;
+        bool Visible;
+        uint8_t Lod;
+    };
+
+    /**
+     * @brief Detail levels selected for the instances of a draw call by a camera
+     */
+    struct LodState {
+        std::vector<uint8_t> Lods;
+        uint64_t LastCull = 0;
+    };
+
+    /**
+     * @brief Runs the occlusion test front to back, rasterizing visible occluders as they are found
+     */
+    void occlude(const glm::mat4& viewProjection);
+
+private:
+    bool m_occlusionCulling = false;
+    OcclusionBuffer m_occlusion;
+    CullingStats m_stats;
+
+    // Detail level hysteresis, keyed by camera and draw call
+    uint64_t m_cullCount = 0;
+    std::unordered_map<size_t, LodState> m_lodStates;
+
+    // Reused between calls to avoid allocations
+    std::vector<Candidate> m_candidates;
+    std::vector<uint32_t> m_order;
+    std::vector<VisibleDrawCall> m_visible;
+    std::vector<glm::mat4> m_transformations;
+};
+
+} // namespace rendering
+} // namespace aderite
@@ -23,6 +23,12 @@ public:
 
     // Vector containing transformations, for instanced rendering
     std::vector<glm::mat4> Transformations;
+
+    // True if none of the instance transformations changed this frame
+    bool Static = true;
+
+    // Identifies the set and order of instances, combined from the entities that added a transformation
+    size_t Signature = 0;
 };
 
 } // namespace rendering
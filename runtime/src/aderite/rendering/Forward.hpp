@@ -11,8 +11,20 @@ class Renderer;
 class DrawCall;
 class Renderable;
 class RenderableData;
+class Culler;
+class Frustum;
+class MaterialBuffer;
+class OcclusionBuffer;
+class RenderGraph;
+class RenderQueue;
+class StaticBatcher;
+struct Bounds;
 struct CameraData;
+struct CullingStats;
 struct FrameData;
+struct OccluderMesh;
+struct StaticBatch;
+struct VisibleDrawCall;
 
 } // namespace rendering
 } // namespace aderite
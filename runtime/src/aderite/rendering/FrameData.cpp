@@ -0,0 +1,41 @@
+#include "FrameData.hpp"
+
+namespace aderite {
+namespace rendering {
+
+void FrameData::reset() {
+    for (auto it = DrawCalls.begin(); it != DrawCalls.end();) {
+        if (it->second.Transformations.empty()) {
+            // Combination that wasn't rendered for a whole frame, only happens when the scene changes
+            it = DrawCalls.erase(it);
+        } else {
+            it->second.Transformations.clear();
+            it->second.Static = true;
+            it->second.Signature = 0;
+            ++it;
+        }
+    }
+
+    Cameras.clear();
+}
+
+FrameData& FrameDataRing::getWrite() {
+    return m_frames[m_write.load(std::memory_order_relaxed)];
+}
+
+const FrameData& FrameDataRing::getRead() const {
+    return m_frames[m_read.load(std::memory_order_acquire)];
+}
+
+void FrameDataRing::swap() {
+    const uint32_t written = m_write.load(std::memory_order_relaxed);
+    m_read.store(written, std::memory_order_release);
+
+    // The third frame is never the one being read, so it can be reset while the reader still uses the previous one
+    const uint32_t next = (written + 1) % c_FrameCount;
+    m_frames[next].reset();
+    m_write.store(next, std::memory_order_relaxed);
+}
+
+} // namespace rendering
+} // namespace aderite
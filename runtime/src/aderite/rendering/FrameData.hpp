@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <bgfx/bgfx.h>
 
@@ -17,6 +20,9 @@ struct CameraData {
     bgfx::TextureHandle Output;
     glm::mat4 ViewMatrix;
     glm::mat4 ProjectionMatrix;
+
+    // Opaque geometry is drawn depth only first and then shaded with an equal depth test
+    bool DepthPrepass = false;
 };
 
 /**
@@ -32,6 +38,42 @@ struct FrameData {
      * @brief Cameras
      */
     std::vector<CameraData> Cameras;
+
+    /**
+     * @brief Prepares the frame data to be written again, containers keep their capacity and draw calls that received no
+     * transformations since the last reset are erased
+     */
+    void reset();
+};
+
+/**
+ * @brief Ring of frame data, the game loop writes into one frame while the renderer reads the previously committed one.
+ * Frames are swapped by index so nothing is copied and every frame keeps its allocations for the next time it is written.
+ */
+class FrameDataRing final {
+public:
+    static constexpr uint32_t c_FrameCount = 3;
+
+public:
+    /**
+     * @brief Returns the frame that is currently being written
+     */
+    FrameData& getWrite();
+
+    /**
+     * @brief Returns the last committed frame
+     */
+    const FrameData& getRead() const;
+
+    /**
+     * @brief Publishes the write frame for reading and resets the next frame for writing
+     */
+    void swap();
+
+private:
+    FrameData m_frames[c_FrameCount];
+    std::atomic<uint32_t> m_write {0};
+    std::atomic<uint32_t> m_read {c_FrameCount - 1};
 };
 
 } // namespace rendering
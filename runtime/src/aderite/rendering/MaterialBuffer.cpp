@@ -0,0 +1,186 @@
+#include "MaterialBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "aderite/asset/MaterialAsset.hpp"
+#include "aderite/asset/MaterialTypeAsset.hpp"
+#include "aderite/utility/Log.hpp"
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Creates the buffer texture with the number of rows
+ */
+static bgfx::TextureHandle createTexture(uint16_t rows) {
+    const bgfx::TextureHandle texture = bgfx::createTexture2D(
+        MaterialBuffer::c_SlotWidth, rows, false, 1, bgfx::TextureFormat::RGBA32F,
+        BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT | BGFX_SAMPLER_MIP_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP);
+    bgfx::setName(texture, "Material buffer");
+    return texture;
+}
+
+void MaterialBuffer::init() {
+    m_rows = c_InitialMaterials;
+    m_texture = createTexture(m_rows);
+    m_sampler = bgfx::createUniform("s_materialBuffer", bgfx::UniformType::Sampler);
+
+    m_staging.assign(static_cast<size_t>(c_SlotWidth) * m_rows, glm::vec4(0.0f));
+
+    // Lowest slots are handed out first
+    m_free.resize(m_rows);
+    for (uint16_t i = 0; i < m_rows; i++) {
+        m_free[i] = m_rows - 1 - i;
+    }
+}
+
+void MaterialBuffer::shutdown() {
+    if (bgfx::isValid(m_texture)) {
+        bgfx::destroy(m_texture);
+        m_texture = BGFX_INVALID_HANDLE;
+    }
+
+    if (bgfx::isValid(m_sampler)) {
+        bgfx::destroy(m_sampler);
+        m_sampler = BGFX_INVALID_HANDLE;
+    }
+
+    m_rows = 0;
+    m_slots.clear();
+    m_free.clear();
+    m_staging.clear();
+}
+
+bool MaterialBuffer::isStored(const asset::MaterialTypeAsset* type) {
+    return type != nullptr && type->usesMaterialBuffer() && type->getSize() <= c_SlotWidth && type->getSamplerCount() < c_Stage;
+}
+
+uint16_t MaterialBuffer::resolve(const asset::MaterialAsset* material) {
+    if (!bgfx::isValid(m_texture) || !isStored(material->getMaterialType())) {
+        return c_InvalidSlot;
+    }
+
+    auto it = m_slots.find(material->getHandle());
+    if (it == m_slots.end()) {
+        const uint16_t index = this->allocate();
+        if (index == c_InvalidSlot) {
+            return c_InvalidSlot;
+        }
+
+        it = m_slots.emplace(material->getHandle(), Slot {index, 0}).first;
+
+        // Always staged
+        std::memset(&m_staging[static_cast<size_t>(it->second.Index) * c_SlotWidth], 0xff, sizeof(glm::vec4) * c_SlotWidth);
+    }
+
+    Slot& slot = it->second;
+    slot.LastFrame = m_frame;
+
+    // Properties are edited in place, so changes are found by comparing with the staged row
+    glm::vec4* row = &m_staging[static_cast<size_t>(slot.Index) * c_SlotWidth];
+    const size_t size = material->getPropertySize() * sizeof(float);
+    if (std::memcmp(row, material->getPropertyData(), size) != 0) {
+        std::memcpy(row, material->getPropertyData(), size);
+        m_dirtyFirst = std::min(m_dirtyFirst, slot.Index);
+        m_dirtyLast = std::max(m_dirtyLast, slot.Index);
+    }
+
+    return slot.Index;
+}
+
+uint16_t MaterialBuffer::getSlot(const asset::MaterialAsset* material) const {
+    auto it = m_slots.find(material->getHandle());
+    return it != m_slots.end() ? it->second.Index : c_InvalidSlot;
+}
+
+void MaterialBuffer::upload() {
+    if (m_dirtyFirst <= m_dirtyLast) {
+        // Dirty rows are contiguous in the staging memory
+        const uint16_t rows = m_dirtyLast - m_dirtyFirst + 1;
+        const glm::vec4* first = &m_staging[static_cast<size_t>(m_dirtyFirst) * c_SlotWidth];
+        bgfx::updateTexture2D(m_texture, 0, 0, 0, m_dirtyFirst, c_SlotWidth, rows,
+                              bgfx::copy(first, static_cast<uint32_t>(rows) * c_SlotWidth * sizeof(glm::vec4)));
+    }
+
+    m_dirtyFirst = c_InvalidSlot;
+    m_dirtyLast = 0;
+
+    // Materials that weren't drawn for a while
+    for (auto it = m_slots.begin(); it != m_slots.end();) {
+        if (it->second.LastFrame + c_SlotFrames < m_frame) {
+            m_free.push_back(it->second.Index);
+            m_full = false;
+            it = m_slots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_frame++;
+}
+
+uint16_t MaterialBuffer::allocate() {
+    if (m_free.empty()) {
+        // Row of the least recently resolved material that isn't drawn this frame
+        auto lru = m_slots.end();
+        for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+            if (it->second.LastFrame < m_frame && (lru == m_slots.end() || it->second.LastFrame < lru->second.LastFrame)) {
+                lru = it;
+            }
+        }
+
+        if (lru != m_slots.end()) {
+            m_free.push_back(lru->second.Index);
+            m_slots.erase(lru);
+        } else if (!this->grow()) {
+            if (!m_full) {
+                LOG_WARN("[Rendering] Material buffer can't hold every material drawn this frame, {0} rows", m_rows);
+                m_full = true;
+            }
+
+            return c_InvalidSlot;
+        }
+    }
+
+    const uint16_t index = m_free.back();
+    m_free.pop_back();
+    return index;
+}
+
+bool MaterialBuffer::grow() {
+    const uint32_t limit = std::min<uint32_t>(bgfx::getCaps()->limits.maxTextureSize, c_InvalidSlot);
+    if (m_rows >= limit) {
+        return false;
+    }
+
+    const uint16_t rows = static_cast<uint16_t>(std::min<uint32_t>(static_cast<uint32_t>(m_rows) * 2, limit));
+    LOG_INFO("[Rendering] Growing material buffer from {0} to {1} materials", m_rows, rows);
+
+    // Destruction is deferred by bgfx, draws already submitted this frame keep the old texture
+    bgfx::destroy(m_texture);
+    m_texture = createTexture(rows);
+    m_staging.resize(static_cast<size_t>(c_SlotWidth) * rows, glm::vec4(0.0f));
+
+    // Every row that is in use is uploaded into the new texture
+    m_dirtyFirst = 0;
+    m_dirtyLast = std::max(m_dirtyLast, static_cast<uint16_t>(m_rows - 1));
+
+    for (uint16_t i = rows; i > m_rows; i--) {
+        m_free.push_back(i - 1);
+    }
+
+    m_rows = rows;
+    return true;
+}
+
+bgfx::TextureHandle MaterialBuffer::getTexture() const {
+    return m_texture;
+}
+
+bgfx::UniformHandle MaterialBuffer::getSampler() const {
+    return m_sampler;
+}
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+#include <glm/glm.hpp>
+
+#include "aderite/asset/Forward.hpp"
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief GPU side storage of material properties. Every material gets a row of a float texture that is only updated
+ * when its properties change, shaders read the row of the slot stored in the instance data. Draws therefore don't set
+ * material uniforms and instances of different materials of the same type can share a draw.
+ */
+class MaterialBuffer final {
+public:
+    /**
+     * @brief Number of vec4 properties a material type can have to be stored in the buffer
+     */
+    static constexpr uint16_t c_SlotWidth = 16;
+
+    /**
+     * @brief Number of materials the buffer holds when created, it grows when every row is used by a single frame
+     */
+    static constexpr uint16_t c_InitialMaterials = 1024;
+
+    /**
+     * @brief Texture stage the buffer is bound to, after all material samplers
+     */
+    static constexpr uint8_t c_Stage = 15;
+
+    /**
+     * @brief Slot of materials that are not in the buffer
+     */
+    static constexpr uint16_t c_InvalidSlot = UINT16_MAX;
+
+    /**
+     * @brief Frames a slot is kept after its material was last resolved
+     */
+    static constexpr uint64_t c_SlotFrames = 120;
+
+public:
+    MaterialBuffer() = default;
+    MaterialBuffer(const MaterialBuffer& o) = delete;
+
+    /**
+     * @brief Creates the buffer texture and the sampler uniform
+     */
+    void init();
+
+    /**
+     * @brief Destroys the buffer
+     */
+    void shutdown();
+
+    /**
+     * @brief Returns true if the material type reads its properties from the buffer
+     */
+    static bool isStored(const asset::MaterialTypeAsset* type);
+
+    /**
+     * @brief Returns the slot of the material, the material gets one if it has none and its properties are staged if
+     * they changed since the last call. When the buffer is full the row of the least recently resolved material is
+     * reused, the buffer only grows if every row was already resolved this frame.
+     * @param material Material to resolve
+     * @return Slot of the material or c_InvalidSlot if the type isn't stored in the buffer or it can't grow anymore
+     */
+    uint16_t resolve(const asset::MaterialAsset* material);
+
+    /**
+     * @brief Returns the slot of the material without staging anything
+     */
+    uint16_t getSlot(const asset::MaterialAsset* material) const;
+
+    /**
+     * @brief Uploads the rows that changed since the last upload and frees slots that weren't resolved for a while
+     */
+    void upload();
+
+    /**
+     * @brief Returns the buffer texture
+     */
+    bgfx::TextureHandle getTexture() const;
+
+    /**
+     * @brief Returns the sampler uniform of the buffer
+     */
+    bgfx::UniformHandle getSampler() const;
+
+private:
+    struct Slot {
+        uint16_t Index = c_InvalidSlot;
+        uint64_t LastFrame = 0;
+    };
+
+    /**
+     * @brief Takes a free row, evicting or growing if there is none
+     * @return Row index or c_InvalidSlot if there is no row left
+     */
+    uint16_t allocate();
+
+    /**
+     * @brief Doubles the number of rows, the texture is created again and every row is uploaded
+     * @return False if the texture is already as large as it can be
+     */
+    bool grow();
+
+private:
+    uint16_t m_rows = 0;
+    bgfx::TextureHandle m_texture = BGFX_INVALID_HANDLE;
+    bgfx::UniformHandle m_sampler = BGFX_INVALID_HANDLE;
+
+    uint64_t m_frame = 0;
+    std::vector<glm::vec4> m_staging;
+    std::unordered_map<size_t, Slot> m_slots; // Keyed by material handle
+    std::vector<uint16_t> m_free;
+    bool m_full = false; // Reported that the buffer can't grow anymore
+
+    // Dirty rows, inclusive
+    uint16_t m_dirtyFirst = c_InvalidSlot;
+    uint16_t m_dirtyLast = 0;
+};
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,102 @@
+#include "OcclusionBuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Vertices closer than this to the camera plane are not projected
+ */
+static constexpr float c_MinW = 1e-5f;
+
+OcclusionBuffer::OcclusionBuffer() : m_depth(static_cast<size_t>(c_Width) * c_Height, 1.0f) {}
+
+void OcclusionBuffer::clear() {
+    std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+}
+
+void OcclusionBuffer::rasterize(const glm::mat4& modelViewProjection, const OccluderMesh& mesh) {
+    // Project all vertices once, w is kept to reject triangles that cross the near plane
+    m_projected.resize(mesh.Vertices.size());
+    for (size_t i = 0; i < mesh.Vertices.size(); i++) {
+        const glm::vec4 clip = modelViewProjection * glm::vec4(mesh.Vertices[i], 1.0f);
+        if (clip.w <= c_MinW) {
+            m_projected[i] = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+            continue;
+        }
+
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        m_projected[i] = glm::vec4((ndc.x * 0.5f + 0.5f) * c_Width, (ndc.y * 0.5f + 0.5f) * c_Height, ndc.z, 1.0f);
+    }
+
+    for (size_t i = 0; i + 2 < mesh.Indices.size(); i += 3) {
+        glm::vec4 a = m_projected[mesh.Indices[i]];
+        glm::vec4 b = m_projected[mesh.Indices[i + 1]];
+        const glm::vec4 c = m_projected[mesh.Indices[i + 2]];
+        if (a.w < 0.0f || b.w < 0.0f || c.w < 0.0f) {
+            continue;
+        }
+
+        float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (area == 0.0f) {
+            continue;
+        }
+
+        if (area < 0.0f) {
+            // Both windings are accepted, back faces only ever lie behind front faces
+            std::swap(a, b);
+            area = -area;
+        }
+
+        // Farthest depth of the triangle keeps the buffer conservative
+        const float depth = std::max({a.z, b.z, c.z});
+        if (depth > 1.0f) {
+            continue;
+        }
+
+        const int minX = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+        const int maxX = std::min(static_cast<int>(c_Width) - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+        const int minY = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+        const int maxY = std::min(static_cast<int>(c_Height) - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+
+        for (int y = minY; y <= maxY; y++) {
+            const float py = static_cast<float>(y) + 0.5f;
+            float* row = m_depth.data() + static_cast<size_t>(y) * c_Width;
+            for (int x = minX; x <= maxX; x++) {
+                const float px = static_cast<float>(x) + 0.5f;
+
+                // Pixel center has to be on the inner side of all three edges
+                const float e0 = (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+                const float e1 = (c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x);
+                const float e2 = (a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x);
+                if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f) {
+                    row[x] = std::min(row[x], depth);
+                }
+            }
+        }
+    }
+}
+
+bool OcclusionBuffer::isVisible(const glm::vec2& min, const glm::vec2& max, float depth) const {
+    const int minX = std::max(0, static_cast<int>(std::floor((min.x * 0.5f + 0.5f) * c_Width)));
+    const int maxX = std::min(static_cast<int>(c_Width) - 1, static_cast<int>(std::floor((max.x * 0.5f + 0.5f) * c_Width)));
+    const int minY = std::max(0, static_cast<int>(std::floor((min.y * 0.5f + 0.5f) * c_Height)));
+    const int maxY = std::min(static_cast<int>(c_Height) - 1, static_cast<int>(std::floor((max.y * 0.5f + 0.5f) * c_Height)));
+
+    for (int y = minY; y <= maxY; y++) {
+        const float* row = m_depth.data() + static_cast<size_t>(y) * c_Width;
+        for (int x = minX; x <= maxX; x++) {
+            if (row[x] >= depth) {
+                return true;
+            }
+        }
+    }
+
+    // Rectangle outside of the buffer means the object was not projected onto the screen, nothing occludes it
+    return minX > maxX || minY > maxY;
+}
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Simplified copy of a mesh that is rasterized into the occlusion buffer
+ */
+struct OccluderMesh {
+    std::vector<glm::vec3> Vertices;
+    std::vector<uint32_t> Indices;
+};
+
+/**
+ * @brief Low resolution CPU depth buffer used to skip instances hidden behind large occluders. Occluders are written
+ * with the farthest depth of each triangle and instances are tested with their nearest depth, so an instance is only
+ * reported hidden if it is behind the occluders in every pixel it covers.
+ */
+class OcclusionBuffer final {
+public:
+    static constexpr uint32_t c_Width = 128;
+    static constexpr uint32_t c_Height = 64;
+
+public:
+    OcclusionBuffer();
+
+    /**
+     * @brief Resets every pixel to the far plane
+     */
+    void clear();
+
+    /**
+     * @brief Rasterizes the occluder, triangles crossing the near plane are skipped
+     * @param modelViewProjection Matrix transforming occluder vertices to clip space
+     * @param mesh Occluder to rasterize
+     */
+    void rasterize(const glm::mat4& modelViewProjection, const OccluderMesh& mesh);
+
+    /**
+     * @brief Returns true if any pixel of the rectangle is farther than the depth
+     * @param min Minimum corner of the rectangle in normalized device coordinates
+     * @param max Maximum corner of the rectangle in normalized device coordinates
+     * @param depth Nearest depth of the tested object
+     */
+    bool isVisible(const glm::vec2& min, const glm::vec2& max, float depth) const;
+
+private:
+    std::vector<float> m_depth;
+
+    // Projected occluder vertices, reused between occluders
+    std::vector<glm::vec4> m_projected;
+};
+
+} // namespace rendering
+} // namespace aderite
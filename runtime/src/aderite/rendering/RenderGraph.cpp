@@ -0,0 +1,309 @@
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Key of a framebuffer from its attachments, every slot is 16 bits and holds the texture index plus one so that
+ * unused slots can't be mistaken for texture 0
+ */
+static uint64_t framebufferKey(const bgfx::TextureHandle* textures, size_t count) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < count; i++) {
+        ADERITE_DYNAMIC_ASSERT(bgfx::isValid(textures[i]), "Render graph framebuffer attachment is not a valid texture");
+        key |= static_cast<uint64_t>(textures[i].idx + 1) << (i * 16);
+    }
+
+    return key;
+}
+
+/**
+ * @brief Returns true if the framebuffer with the key has the texture attached
+ */
+static bool framebufferUses(uint64_t key, bgfx::TextureHandle texture) {
+    for (size_t slot = 0; slot < RenderGraph::c_MaxAttachments; slot++) {
+        if (((key >> (slot * 16)) & 0xffff) == static_cast<uint64_t>(texture.idx + 1)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool RenderGraph::TextureDesc::operator==(const TextureDesc& other) const {
+    return Format == other.Format && Flags == other.Flags;
+}
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+RenderGraph::Resource RenderGraph::PassBuilder::create(const std::string& name, const TextureDesc& desc) {
+    ResourceNode& node = m_graph.m_resources.emplace_back();
+    node.Name = name;
+    node.Desc = desc;
+    return static_cast<Resource>(m_graph.m_resources.size() - 1);
+}
+
+void RenderGraph::PassBuilder::read(Resource resource) {
+    ADERITE_DYNAMIC_ASSERT(resource < m_graph.m_resources.size(), "Render graph pass read an unknown resource");
+    m_graph.m_passes[m_pass].Reads.push_back(resource);
+}
+
+void RenderGraph::PassBuilder::write(Resource resource) {
+    ADERITE_DYNAMIC_ASSERT(resource < m_graph.m_resources.size(), "Render graph pass wrote an unknown resource");
+    m_graph.m_passes[m_pass].Writes.push_back(resource);
+}
+
+void RenderGraph::PassBuilder::attach(Resource resource) {
+    Pass& pass = m_graph.m_passes[m_pass];
+    ADERITE_DYNAMIC_ASSERT(pass.Attachments.size() < c_MaxAttachments, "Too many render graph pass attachments");
+    this->write(resource);
+    pass.Attachments.push_back(resource);
+}
+
+void RenderGraph::PassBuilder::setClear(uint16_t flags, uint32_t rgba, float depth, uint8_t stencil) {
+    Pass& pass = m_graph.m_passes[m_pass];
+    pass.ClearFlags = flags;
+    pass.ClearColor = rgba;
+    pass.ClearDepth = depth;
+    pass.ClearStencil = stencil;
+}
+
+void RenderGraph::PassBuilder::setSideEffect() {
+    m_graph.m_passes[m_pass].SideEffect = true;
+}
+
+void RenderGraph::shutdown() {
+    for (const auto& kvp : m_framebuffers) {
+        bgfx::destroy(kvp.second);
+    }
+
+    for (const PooledTarget& target : m_pool) {
+        bgfx::destroy(target.Texture);
+    }
+
+    m_framebuffers.clear();
+    m_pool.clear();
+    this->reset();
+}
+
+void RenderGraph::reset() {
+    m_passes.clear();
+    m_resources.clear();
+}
+
+RenderGraph::Resource RenderGraph::import(const std::string& name, bgfx::TextureHandle texture) {
+    ResourceNode& node = m_resources.emplace_back();
+    node.Name = name;
+    node.Imported = true;
+    node.Texture = texture;
+    return static_cast<Resource>(m_resources.size() - 1);
+}
+
+RenderGraph::PassBuilder RenderGraph::addPass(const std::string& name, ExecuteFn execute) {
+    Pass& pass = m_passes.emplace_back();
+    pass.Name = name;
+    pass.Execute = std::move(execute);
+    return PassBuilder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+}
+
+void RenderGraph::compile() {
+    m_frame++;
+    m_stats = {};
+    m_stats.Passes = static_cast<uint32_t>(m_passes.size());
+
+    // 1. Cull, walking backwards a pass is needed if it has side effects or writes something that is needed
+    std::vector<uint8_t> needed(m_resources.size(), 0);
+    for (size_t i = 0; i < m_resources.size(); i++) {
+        needed[i] = m_resources[i].Imported;
+    }
+
+    for (size_t i = m_passes.size(); i-- > 0;) {
+        Pass& pass = m_passes[i];
+        pass.Culled = !pass.SideEffect && std::none_of(pass.Writes.begin(), pass.Writes.end(), [&needed](Resource resource) {
+            return needed[resource] != 0;
+        });
+
+        if (pass.Culled) {
+            m_stats.CulledPasses++;
+            continue;
+        }
+
+        for (Resource resource : pass.Reads) {
+            needed[resource] = 1;
+        }
+    }
+
+    // 2. Lifetimes of transient textures over the remaining passes
+    for (uint32_t i = 0; i < m_passes.size(); i++) {
+        const Pass& pass = m_passes[i];
+        if (pass.Culled) {
+            continue;
+        }
+
+        for (const std::vector<Resource>* list : {&pass.Reads, &pass.Writes}) {
+            for (Resource resource : *list) {
+                ResourceNode& node = m_resources[resource];
+                node.FirstPass = std::min(node.FirstPass, i);
+                node.LastPass = std::max(node.LastPass, i);
+            }
+        }
+    }
+
+    // 3. Views in pass order and targets, a target is free again after the last pass using it since views execute in order
+    uint32_t view = 0;
+    for (uint32_t i = 0; i < m_passes.size(); i++) {
+        Pass& pass = m_passes[i];
+        if (pass.Culled) {
+            continue;
+        }
+
+        ADERITE_DYNAMIC_ASSERT(view < UINT8_MAX, "Render graph ran out of views");
+        pass.View = static_cast<bgfx::ViewId>(view++);
+
+        for (ResourceNode& node : m_resources) {
+            if (!node.Imported && node.FirstPass == i) {
+                node.Texture = this->acquire(node.Desc);
+                m_stats.Transients++;
+            }
+        }
+
+        if (!pass.Attachments.empty()) {
+            pass.Framebuffer = this->getFramebuffer(pass);
+        }
+
+        for (ResourceNode& node : m_resources) {
+            if (!node.Imported && node.LastPass == i && bgfx::isValid(node.Texture)) {
+                this->release(node.Texture);
+            }
+        }
+    }
+
+    this->evict();
+    m_stats.PooledTargets = static_cast<uint32_t>(m_pool.size());
+}
+
+void RenderGraph::execute() {
+    for (const Pass& pass : m_passes) {
+        if (pass.Culled) {
+            continue;
+        }
+
+        bgfx::setViewName(pass.View, pass.Name.c_str());
+        bgfx::setViewRect(pass.View, 0, 0, bgfx::BackbufferRatio::Equal);
+        bgfx::setViewFrameBuffer(pass.View, pass.Framebuffer);
+        bgfx::setViewClear(pass.View, pass.ClearFlags, pass.ClearColor, pass.ClearDepth, pass.ClearStencil);
+        bgfx::touch(pass.View);
+
+        pass.Execute(pass.View);
+    }
+}
+
+bgfx::TextureHandle RenderGraph::getTexture(Resource resource) const {
+    return m_resources[resource].Texture;
+}
+
+bool RenderGraph::isCulled(const std::string& name) const {
+    auto it = std::find_if(m_passes.begin(), m_passes.end(), [&name](const Pass& pass) {
+        return pass.Name == name;
+    });
+
+    return it == m_passes.end() || it->Culled;
+}
+
+const RenderGraph::Stats& RenderGraph::getStats() const {
+    return m_stats;
+}
+
+void RenderGraph::readTimings() {
+    const bgfx::Stats* stats = bgfx::getStats();
+    m_timings.resize(stats->numViews);
+    for (uint16_t i = 0; i < stats->numViews; i++) {
+        const bgfx::ViewStats& view = stats->viewStats[i];
+        PassTiming& timing = m_timings[i];
+        timing.Name = view.name;
+        timing.CpuMs = stats->cpuTimerFreq > 0 ? 1000.0 * (view.cpuTimeEnd - view.cpuTimeBegin) / stats->cpuTimerFreq : 0.0;
+        timing.GpuMs = stats->gpuTimerFreq > 0 ? 1000.0 * (view.gpuTimeEnd - view.gpuTimeBegin) / stats->gpuTimerFreq : 0.0;
+    }
+}
+
+const std::vector<RenderGraph::PassTiming>& RenderGraph::getTimings() const {
+    return m_timings;
+}
+
+bgfx::TextureHandle RenderGraph::acquire(const TextureDesc& desc) {
+    for (PooledTarget& target : m_pool) {
+        if (!target.InUse && target.Desc == desc) {
+            target.InUse = true;
+            target.LastFrame = m_frame;
+            return target.Texture;
+        }
+    }
+
+    PooledTarget& target = m_pool.emplace_back();
+    target.Desc = desc;
+    target.Texture = bgfx::createTexture2D(bgfx::BackbufferRatio::Equal, false, 1, desc.Format, desc.Flags);
+    target.LastFrame = m_frame;
+    target.InUse = true;
+    bgfx::setName(target.Texture, "Render graph target");
+
+    LOG_TRACE("[Rendering] Created render graph target, {0} pooled", m_pool.size());
+    return target.Texture;
+}
+
+void RenderGraph::release(bgfx::TextureHandle texture) {
+    for (PooledTarget& target : m_pool) {
+        if (target.Texture.idx == texture.idx) {
+            target.InUse = false;
+            return;
+        }
+    }
+}
+
+bgfx::FrameBufferHandle RenderGraph::getFramebuffer(const Pass& pass) {
+    bgfx::TextureHandle textures[c_MaxAttachments];
+    for (size_t i = 0; i < pass.Attachments.size(); i++) {
+        textures[i] = m_resources[pass.Attachments[i]].Texture;
+    }
+
+    const uint64_t key = framebufferKey(textures, pass.Attachments.size());
+    auto it = m_framebuffers.find(key);
+    if (it != m_framebuffers.end()) {
+        return it->second;
+    }
+
+    // Targets are owned by the pool
+    const bgfx::FrameBufferHandle framebuffer = bgfx::createFrameBuffer(static_cast<uint8_t>(pass.Attachments.size()), textures, false);
+    m_framebuffers.emplace(key, framebuffer);
+    return framebuffer;
+}
+
+void RenderGraph::evict() {
+    for (size_t i = 0; i < m_pool.size();) {
+        const PooledTarget& target = m_pool[i];
+        if (target.InUse || target.LastFrame + c_PoolFrames >= m_frame) {
+            i++;
+            continue;
+        }
+
+        // Framebuffers referencing the target go with it
+        for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();) {
+            if (framebufferUses(it->first, target.Texture)) {
+                bgfx::destroy(it->second);
+                it = m_framebuffers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        bgfx::destroy(target.Texture);
+        m_pool.erase(m_pool.begin() + i);
+    }
+}
+
+} // namespace rendering
+} // namespace aderite
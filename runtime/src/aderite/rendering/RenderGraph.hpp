@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Declarative description of the passes of a frame. Passes declare the textures they read and write, the graph
+ * then culls passes whose outputs are never used, assigns bgfx view indices in pass order and backs transient textures
+ * with pooled render targets. Transient textures whose lifetimes don't overlap share the same render target, so
+ * cameras rendered one after another use the same memory.
+ *
+ * The graph is rebuilt every frame: reset, add passes, compile, execute. Pooled targets survive between frames.
+ */
+class RenderGraph final {
+public:
+    /**
+     * @brief Index of a texture in the graph
+     */
+    using Resource = uint32_t;
+    static constexpr Resource c_InvalidResource = UINT32_MAX;
+
+    /**
+     * @brief Render targets are at most attached this many at once
+     */
+    static constexpr size_t c_MaxAttachments = 4;
+
+    /**
+     * @brief Pooled targets that weren't used for this many frames are destroyed
+     */
+    static constexpr uint64_t c_PoolFrames = 60;
+
+    /**
+     * @brief Transient texture description, transient textures always match the backbuffer size
+     */
+    struct TextureDesc {
+        bgfx::TextureFormat::Enum Format = bgfx::TextureFormat::BGRA8;
+        uint64_t Flags = BGFX_TEXTURE_RT;
+
+        bool operator==(const TextureDesc& other) const;
+    };
+
+    /**
+     * @brief Counters of the last compile
+     */
+    struct Stats {
+        uint32_t Passes = 0;
+        uint32_t CulledPasses = 0;
+        uint32_t Transients = 0;
+        uint32_t PooledTargets = 0;
+    };
+
+    /**
+     * @brief Time spent on a pass, measured by bgfx
+     */
+    struct PassTiming {
+        std::string Name;
+        double CpuMs = 0.0;
+        double GpuMs = 0.0;
+    };
+
+    /**
+     * @brief Executes a pass, the view is already set up with the pass targets
+     */
+    using ExecuteFn = std::function<void(bgfx::ViewId view)>;
+
+    /**
+     * @brief Declares the resources of a pass
+     */
+    class PassBuilder final {
+    public:
+        PassBuilder(RenderGraph& graph, uint32_t pass);
+
+        /**
+         * @brief Creates a transient texture written by this pass
+         * @param name Debug name
+         * @param desc Texture description
+         */
+        Resource create(const std::string& name, const TextureDesc& desc);
+
+        /**
+         * @brief Declares that the pass reads the resource, a pass that writes a resource written before it has to
+         * read it too, otherwise the earlier writer can be culled
+         */
+        void read(Resource resource);
+
+        /**
+         * @brief Declares that the pass writes the resource without rendering into it, e.g. a blit destination
+         */
+        void write(Resource resource);
+
+        /**
+         * @brief Attaches the resource as a render target of the pass, in attachment order
+         */
+        void attach(Resource resource);
+
+        /**
+         * @brief Sets how the targets are cleared before the pass
+         * @param flags BGFX_CLEAR_* flags
+         * @param rgba Clear color
+         * @param depth Clear depth
+         * @param stencil Clear stencil
+         */
+        void setClear(uint16_t flags, uint32_t rgba = 0x000000ff, float depth = 1.0f, uint8_t stencil = 0);
+
+        /**
+         * @brief Marks the pass as never culled even if nothing reads its outputs
+         */
+        void setSideEffect();
+
+    private:
+        RenderGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+public:
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph& o) = delete;
+
+    /**
+     * @brief Destroys every pooled target
+     */
+    void shutdown();
+
+    /**
+     * @brief Removes all passes and resources, pooled targets are kept
+     */
+    void reset();
+
+    /**
+     * @brief Imports a texture owned outside of the graph, passes writing imported textures are never culled
+     * @param name Debug name
+     * @param texture Texture to import
+     */
+    Resource import(const std::string& name, bgfx::TextureHandle texture);
+
+    /**
+     * @brief Adds a pass, passes are executed in the order they are added
+     * @param name Name of the pass, used as the view name
+     * @param execute Function submitting the work of the pass
+     * @return Builder to declare the resources of the pass with
+     */
+    PassBuilder addPass(const std::string& name, ExecuteFn execute);
+
+    /**
+     * @brief Culls unused passes, assigns views and backs transient textures with pooled targets
+     */
+    void compile();
+
+    /**
+     * @brief Sets up the views of the compiled passes and executes them in order
+     */
+    void execute();
+
+    /**
+     * @brief Returns the texture backing the resource, valid after compile
+     */
+    bgfx::TextureHandle getTexture(Resource resource) const;
+
+    /**
+     * @brief Returns true if the pass was culled by the last compile
+     * @param name Name of the pass
+     */
+    bool isCulled(const std::string& name) const;
+
+    /**
+     * @brief Returns the counters of the last compile
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @brief Reads the pass timings of the last submitted frame from bgfx, the bgfx profiler has to be enabled
+     */
+    void readTimings();
+
+    /**
+     * @brief Returns the timings read by the last readTimings call
+     */
+    const std::vector<PassTiming>& getTimings() const;
+
+private:
+    struct Pass {
+        std::string Name;
+        ExecuteFn Execute;
+        std::vector<Resource> Reads;
+        std::vector<Resource> Writes;
+        std::vector<Resource> Attachments;
+        uint16_t ClearFlags = BGFX_CLEAR_NONE;
+        uint32_t ClearColor = 0x000000ff;
+        float ClearDepth = 1.0f;
+        uint8_t ClearStencil = 0;
+        bool SideEffect = false;
+        bool Culled = false;
+        bgfx::ViewId View = 0;
+        bgfx::FrameBufferHandle Framebuffer = BGFX_INVALID_HANDLE;
+    };
+
+    struct ResourceNode {
+        std::string Name;
+        TextureDesc Desc;
+        bool Imported = false;
+        bgfx::TextureHandle Texture = BGFX_INVALID_HANDLE;
+        uint32_t FirstPass = UINT32_MAX;
+        uint32_t LastPass = 0;
+    };
+
+    struct PooledTarget {
+        TextureDesc Desc;
+        bgfx::TextureHandle Texture = BGFX_INVALID_HANDLE;
+        uint64_t LastFrame = 0;
+        bool InUse = false;
+    };
+
+    /**
+     * @brief Returns a free pooled target matching the description, one is created if there is none
+     */
+    bgfx::TextureHandle acquire(const TextureDesc& desc);
+
+    /**
+     * @brief Returns the target back to the pool
+     */
+    void release(bgfx::TextureHandle texture);
+
+    /**
+     * @brief Returns the framebuffer of the attachments, framebuffers are cached for as long as their targets live
+     */
+    bgfx::FrameBufferHandle getFramebuffer(const Pass& pass);
+
+    /**
+     * @brief Destroys targets that weren't used for a while and the framebuffers using them
+     */
+    void evict();
+
+private:
+    uint64_t m_frame = 0;
+    Stats m_stats;
+    std::vector<Pass> m_passes;
+    std::vector<ResourceNode> m_resources;
+    std::vector<PassTiming> m_timings;
+
+    // Persistent between frames
+    std::vector<PooledTarget> m_pool;
+    std::unordered_map<uint64_t, bgfx::FrameBufferHandle> m_framebuffers;
+};
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,88 @@
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Monotonic 16 bit quantization of a non negative depth, the exponent and the top of the mantissa of the float
+ */
+static uint64_t quantizeDepth(float depth) {
+    depth = std::max(depth, 0.0f);
+
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(float));
+    return (bits >> 15) & 0xffff;
+}
+
+uint64_t RenderQueue::makeKey(uint8_t view, bool transparent, uint16_t program, uint16_t material, uint16_t mesh, float depth) {
+    const uint64_t state = (static_cast<uint64_t>(program & 0x7ff) << 28) | (static_cast<uint64_t>(material) << 12) | (mesh & 0xfff);
+    const uint64_t quantized = quantizeDepth(depth);
+
+    uint64_t key = static_cast<uint64_t>(view) << 56;
+    if (transparent) {
+        key |= 1ull << 55;
+        key |= (0xffff - quantized) << 39;
+        key |= state;
+    } else {
+        key |= state << 16;
+        key |= quantized;
+    }
+
+    return key;
+}
+
+void RenderQueue::clear() {
+    m_items.clear();
+}
+
+void RenderQueue::push(uint64_t key, uint32_t index) {
+    m_items.push_back({key, index});
+}
+
+void RenderQueue::sort() {
+    if (m_items.size() < 2) {
+        return;
+    }
+
+    // Histograms of all 8 bytes in a single pass
+    uint32_t counts[8][256] = {};
+    for (const Item& item : m_items) {
+        for (int pass = 0; pass < 8; pass++) {
+            counts[pass][(item.Key >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    m_scratch.resize(m_items.size());
+    for (int pass = 0; pass < 8; pass++) {
+        uint32_t* count = counts[pass];
+        const uint32_t shift = pass * 8;
+
+        // Every key has the same byte, nothing to reorder
+        if (count[(m_items.front().Key >> shift) & 0xff] == m_items.size()) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            const uint32_t bucketCount = count[bucket];
+            count[bucket] = offset;
+            offset += bucketCount;
+        }
+
+        for (const Item& item : m_items) {
+            m_scratch[count[(item.Key >> shift) & 0xff]++] = item;
+        }
+
+        m_items.swap(m_scratch);
+    }
+}
+
+const std::vector<RenderQueue::Item>& RenderQueue::getItems() const {
+    return m_items;
+}
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Queue of draws ordered by a 64 bit sort key, so that draws sharing a program, material and mesh end up next to
+ * each other and only the state that actually changes has to be bound
+ *
+ * Key layout from the most significant bit:
+ * Opaque:      view (8) | 0 (1) | program (11) | material (16) | mesh (12) | depth (16), front to back
+ * Transparent: view (8) | 1 (1) | inverted depth (16) | program (11) | material (16) | mesh (12), back to front
+ */
+class RenderQueue final {
+public:
+    /**
+     * @brief Queued draw, Index refers to whatever the caller queued
+     */
+    struct Item {
+        uint64_t Key;
+        uint32_t Index;
+    };
+
+public:
+    /**
+     * @brief Builds a sort key, identifiers wider than their field are truncated which only affects batching
+     * @param view View the draw is submitted to
+     * @param transparent True if the draw is blended
+     * @param program Program identifier
+     * @param material Material identifier
+     * @param mesh Mesh identifier
+     * @param depth View space depth of the draw
+     */
+    static uint64_t makeKey(uint8_t view, bool transparent, uint16_t program, uint16_t material, uint16_t mesh, float depth);
+
+    /**
+     * @brief Removes all items, the capacity is kept
+     */
+    void clear();
+
+    /**
+     * @brief Adds a draw to the queue
+     * @param key Sort key created with makeKey
+     * @param index Caller defined index
+     */
+    void push(uint64_t key, uint32_t index);
+
+    /**
+     * @brief Sorts the items by key with a least significant digit radix sort, byte passes where all keys are equal are
+     * skipped so typical queues only need a few passes
+     */
+    void sort();
+
+    /**
+     * @brief Returns the items, sorted after a call to sort
+     */
+    const std::vector<Item>& getItems() const;
+
+private:
+    std::vector<Item> m_items;
+    std::vector<Item> m_scratch;
+};
+
+} // namespace rendering
+} // namespace aderite
@@ -6,25 +6,17 @@
 #include "aderite/scene/GameObject.hpp"
 #include "aderite/scene/TransformProvider.hpp"
 #include "aderite/utility/Macros.hpp"
+#include "aderite/utility/Utility.hpp"
 
 namespace aderite {
 namespace rendering {
 
-inline glm::mat4 calculateTransformationMatrix(scene::TransformProvider* transform) {
-    glm::vec3 position = transform->getPosition();
-    glm::quat rotation = transform->getRotation();
-    glm::vec3 scale = transform->getScale();
-
-    glm::mat4 rMat = glm::toMat4(rotation);
-    return glm::translate(glm::mat4(1.0f), position) * rMat * glm::scale(glm::mat4(1.0f), scale);
-}
-
 Renderable::Renderable(scene::GameObject* gObject) : m_gObject(gObject) {}
 
 Renderable::~Renderable() {}
 
 void Renderable::update(float delta) {
-    if (!m_data.isValid()) {
+    if (m_batch != nullptr || !m_data.isValid()) {
         return;
     }
 
@@ -39,12 +31,26 @@ void Renderable::update(float delta) {
     rendering::DrawCall& dc = fd.DrawCalls[m_data.hash()];
     dc.Material = m_data.getMaterial();
     dc.Mesh = m_data.getMesh();
-    dc.Transformations.push_back(calculateTransformationMatrix(transform));
+    dc.Transformations.push_back(transform->getWorldMatrix());
+    dc.Static = dc.Static && !transform->wasWorldModified();
+    dc.Signature = utility::combineHash(dc.Signature, m_gObject->getEntity());
 }
 
 RenderableData& Renderable::getData() {
     return m_data;
 }
 
+void Renderable::setBatch(asset::MaterialAsset* material) {
+    m_batch = material;
+}
+
+asset::MaterialAsset* Renderable::getBatch() const {
+    return m_batch;
+}
+
+bool Renderable::isBatched() const {
+    return m_batch != nullptr;
+}
+
 } // namespace rendering
 } // namespace aderite
@@ -26,9 +26,26 @@ public:
      */
     RenderableData& getData();
 
+    /**
+     * @brief Set by the static batcher, batched renderables are drawn as part of their batch and don't add draw calls
+     * @param material Material of the batch or nullptr if not batched
+     */
+    void setBatch(asset::MaterialAsset* material);
+
+    /**
+     * @brief Returns the material of the static batch the renderable is part of, nullptr if it isn't batched
+     */
+    asset::MaterialAsset* getBatch() const;
+
+    /**
+     * @brief Returns true if the renderable is part of a static batch
+     */
+    bool isBatched() const;
+
 private:
     scene::GameObject* m_gObject = nullptr;
     RenderableData m_data;
+    asset::MaterialAsset* m_batch = nullptr;
 };
 
 } // namespace rendering
@@ -30,6 +30,10 @@ size_t RenderableData::hash() const {
 }
 
 void RenderableData::setMesh(asset::MeshAsset* mesh) {
+    if (mesh == m_mesh) {
+        return;
+    }
+
     if (m_mesh != nullptr) {
         m_mesh->release();
     }
@@ -39,9 +43,14 @@ void RenderableData::setMesh(asset::MeshAsset* mesh) {
     }
 
     m_mesh = mesh;
+    m_changed = true;
 }
 
 void RenderableData::setMaterial(asset::MaterialAsset* material) {
+    if (material == m_material) {
+        return;
+    }
+
     if (m_material != nullptr) {
         m_material->release();
     }
@@ -51,6 +60,26 @@ void RenderableData::setMaterial(asset::MaterialAsset* material) {
     }
 
     m_material = material;
+    m_changed = true;
+}
+
+void RenderableData::setStatic(bool value) {
+    if (value != m_static) {
+        m_static = value;
+        m_changed = true;
+    }
+}
+
+bool RenderableData::isStatic() const {
+    return m_static;
+}
+
+bool RenderableData::hasChanged() const {
+    return m_changed;
+}
+
+void RenderableData::resetChangedFlag() {
+    m_changed = false;
 }
 
 asset::MeshAsset* RenderableData::getMesh() const {
@@ -70,6 +99,8 @@ bool RenderableData::serialize(const io::Serializer* serializer, YAML::Emitter&
     if (m_material) {
         emitter << YAML::Key << "Material" << YAML::Value << m_material->getHandle();
     }
+
+    emitter << YAML::Key << "Static" << YAML::Value << m_static;
     emitter << YAML::EndMap;
 
     return true;
@@ -91,12 +122,17 @@ bool RenderableData::deserialize(io::Serializer* serializer, const YAML::Node& d
         this->setMaterial(static_cast<asset::MaterialAsset*>(::aderite::Engine::getAssetManager()->get(handle)));
     }
 
+    if (renderNode["Static"]) {
+        this->setStatic(renderNode["Static"].as<bool>());
+    }
+
     return true;
 }
 
 RenderableData& RenderableData::operator=(const RenderableData& other) {
     this->setMaterial(other.getMaterial());
     this->setMesh(other.getMesh());
+    this->setStatic(other.m_static);
     return *this;
 }
 
@@ -35,6 +35,29 @@ public:
      */
     void setMaterial(asset::MaterialAsset* material);
 
+    /**
+     * @brief Marks the renderable as immovable, static renderables are merged into static batches while the scene runs
+     * and their transform is no longer read, moving one builds its batch again
+     * @param value True if static
+     */
+    void setStatic(bool value);
+
+    /**
+     * @brief Returns true if the renderable is static
+     */
+    bool isStatic() const;
+
+    /**
+     * @brief Returns true if the mesh, material or static flag changed since the flag was last reset, static batches
+     * that contain the renderable have to be built again
+     */
+    bool hasChanged() const;
+
+    /**
+     * @brief Resets the change flag
+     */
+    void resetChangedFlag();
+
     /**
      * @brief Returns mesh instance
      */
@@ -54,6 +77,8 @@ public:
 private:
     asset::MeshAsset* m_mesh = nullptr;
     asset::MaterialAsset* m_material = nullptr;
+    bool m_static = false;
+    bool m_changed = false;
 };
 
 } // namespace rendering
@@ -1,5 +1,8 @@
 #include "Renderer.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 #include <bgfx/bgfx.h>
 #include <bx/string.h>
 #include <glm/gtc/type_ptr.hpp>
@@ -16,6 +19,7 @@
 #include "aderite/scene/Scene.hpp"
 #include "aderite/scene/SceneManager.hpp"
 #include "aderite/scene/TransformProvider.hpp"
+#include "aderite/threading/JobSystem.hpp"
 #include "aderite/utility/Log.hpp"
 #include "aderite/utility/LogExtensions.hpp"
 #include "aderite/window/WindowManager.hpp"
@@ -86,33 +90,43 @@ bgfx::TextureFormat::Enum findDepthFormat(uint64_t textureFlags, bool stencil =
     return depthFormat;
 }
 
-bgfx::FrameBufferHandle createFramebuffer(bool blittable = false, bool hdr = false, bool depth = true, bool stencil = true) {
-    bgfx::TextureHandle textures[2];
-    uint8_t attachments = 0;
-
-    const uint64_t textureFlags = BGFX_TEXTURE_RT_MSAA_X4 | 0;
+/**
+ * @brief Sampler flags of the camera render targets
+ */
+static constexpr uint64_t c_SamplerFlags =
+    BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT | BGFX_SAMPLER_MIP_POINT | BGFX_SAMPLER_U_CLAMP | BGFX_SAMPLER_V_CLAMP;
 
-    const uint64_t samplerFlags = BGFX_SAMPLER_MIN_POINT | BGFX_SAMPLER_MAG_POINT | BGFX_SAMPLER_MIP_POINT | BGFX_SAMPLER_U_CLAMP |
-                                  BGFX_SAMPLER_V_CLAMP | (blittable ? BGFX_TEXTURE_BLIT_DST : 0) | 0;
+/**
+ * @brief Flags of the camera render targets
+ */
+static constexpr uint64_t c_TargetFlags = BGFX_TEXTURE_RT_MSAA_X4 | c_SamplerFlags;
 
-    // BGRA is often faster (internal GPU format)
-    bgfx::TextureFormat::Enum format = hdr ? bgfx::TextureFormat::RGBA16F : bgfx::TextureFormat::BGRA8;
-    assert(bgfx::isTextureValid(0, false, 1, format, BGFX_TEXTURE_RT | samplerFlags));
-    textures[attachments++] =
-        bgfx::createTexture2D(bgfx::BackbufferRatio::Equal, false, 1, format, BGFX_TEXTURE_RT | samplerFlags | textureFlags);
+/**
+ * @brief Clear color of the camera render targets
+ */
+static constexpr uint32_t c_ClearColor = 0x9ACBFFFF;
 
-    if (depth) {
-        bgfx::TextureFormat::Enum depthFormat = findDepthFormat(BGFX_TEXTURE_RT_WRITE_ONLY | samplerFlags, stencil);
-        assert(depthFormat != bgfx::TextureFormat::Enum::Count);
-        textures[attachments++] = bgfx::createTexture2D(bgfx::BackbufferRatio::Equal, false, 1, depthFormat,
-                                                        BGFX_TEXTURE_RT_WRITE_ONLY | samplerFlags | textureFlags);
-    }
+/**
+ * @brief Stride of the per instance data, a transformation matrix
+ */
+static constexpr uint16_t c_InstanceStride = sizeof(glm::mat4);
+ADERITE_STATIC_ASSERT(c_InstanceStride % 16 == 0, "Instance stride must be divisible by 16");
 
-    bgfx::FrameBufferHandle handle = bgfx::createFrameBuffer(attachments, textures, true);
-    return handle;
+/**
+ * @brief Layout of instance data stored in vertex buffers, matches the transient instance data
+ */
+static bgfx::VertexLayout instanceLayout() {
+    bgfx::VertexLayout layout;
+    layout.begin();
+    layout.add(bgfx::Attrib::TexCoord7, 4, bgfx::AttribType::Float);
+    layout.add(bgfx::Attrib::TexCoord6, 4, bgfx::AttribType::Float);
+    layout.add(bgfx::Attrib::TexCoord5, 4, bgfx::AttribType::Float);
+    layout.add(bgfx::Attrib::TexCoord4, 4, bgfx::AttribType::Float);
+    layout.end();
+    return layout;
 }
 
-bool Renderer::init() {
+bool Renderer::init(bool noop) {
     ADERITE_LOG_BLOCK;
     LOG_DEBUG("[Rendering] Initializing BGFX Renderer");
 
@@ -125,13 +139,14 @@ bool Renderer::init() {
 
     bgfx::Init bgfxInit;
     bgfxInit.platformData = pd;
-    bgfxInit.type = bgfx::RendererType::Count; // Automatically choose a backend
+    bgfxInit.type = noop ? bgfx::RendererType::Noop : bgfx::RendererType::Count; // Automatically choose a backend
     bgfxInit.resolution.width = size.x;
     bgfxInit.resolution.height = size.y;
     bgfxInit.resolution.reset = BGFX_RESET_VSYNC;
     bgfxInit.callback = &::impl::g_cb;
 
-    // TODO: Add multi threaded
+    // An encoder for every job worker and one for the main thread
+    bgfxInit.limits.maxEncoders = static_cast<uint16_t>(::aderite::Engine::getJobSystem()->getWorkerCount() + 1);
 
     if (!bgfx::init(bgfxInit)) {
         LOG_ERROR("[Rendering] Failed to initialize BGFX");
@@ -141,10 +156,10 @@ bool Renderer::init() {
     auto windowSize = ::aderite::Engine::getWindowManager()->getSize();
     this->onWindowResized(windowSize.x, windowSize.y, false);
 
-    if (!this->createTargets()) {
-        LOG_ERROR("[Rendering] Failed to create targets");
-        return false;
-    }
+    // Camera targets are created by the render graph, BGRA is often faster (internal GPU format)
+    assert(bgfx::isTextureValid(0, false, 1, bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_RT | c_SamplerFlags));
+    m_depthFormat = findDepthFormat(BGFX_TEXTURE_RT_WRITE_ONLY | c_SamplerFlags);
+    m_materialBuffer.init();
 
     // Finish any queued operations
     bgfx::frame();
@@ -161,7 +176,22 @@ void Renderer::shutdown() {
     ADERITE_LOG_BLOCK;
     LOG_TRACE("[Rendering] Shutting down");
 
-    bgfx::destroy(m_mainFbo);
+    m_graph.shutdown();
+    m_materialBuffer.shutdown();
+
+    for (auto& kvp : m_persistentInstances) {
+        if (bgfx::isValid(kvp.second.Buffer)) {
+            bgfx::destroy(kvp.second.Buffer);
+        }
+    }
+    m_persistentInstances.clear();
+
+    for (const OverflowBuffer& overflow : m_overflowBuffers) {
+        if (bgfx::isValid(overflow.Buffer)) {
+            bgfx::destroy(overflow.Buffer);
+        }
+    }
+    m_overflowBuffers.clear();
 
     bgfx::shutdown();
 
@@ -203,79 +233,29 @@ void Renderer::render() {
     // Clear state
     bgfx::discard(BGFX_DISCARD_ALL);
 
-    // Render for each camera
-    uint8_t viewIdx = 0;
-    for (rendering::CameraData& cd : m_readData.Cameras) {
-        // Debug values
-        bgfx::setName(cd.Output, cd.Name.c_str());
-
-        // Setup view
-        this->setupView(viewIdx, cd.Name);
-        bgfx::setViewFrameBuffer(viewIdx, m_mainFbo);
-        bgfx::touch(viewIdx);
-        bgfx::touch(viewIdx + 1);
-
-        // Setup persistent matrices
-        bgfx::setViewTransform(viewIdx, glm::value_ptr(cd.ViewMatrix), glm::value_ptr(cd.ProjectionMatrix));
-
-        // Discard previous state
-        bgfx::discard(BGFX_DISCARD_ALL);
-
-        // 4. Submit draw calls
-        for (auto& kvp : m_readData.DrawCalls) {
-            // Extract assets
-            const asset::MaterialAsset* material = kvp.second.Material;
-            const asset::MeshAsset* mesh = kvp.second.Mesh;
-            const asset::MaterialTypeAsset* mType = material->getMaterialType();
-
-            // TODO : Check for frame miss and available size
-            const uint16_t instanceStride = sizeof(glm::mat4);
-            uint32_t modelCount = bgfx::getAvailInstanceDataBuffer(kvp.second.Transformations.size(), instanceStride);
-
-            ADERITE_STATIC_ASSERT(instanceStride % 16 == 0, "Instance stride must be divisible by 16");
-
-            // Allocate instance data buffer
-            bgfx::InstanceDataBuffer idb;
-            bgfx::allocInstanceDataBuffer(&idb, modelCount, instanceStride);
-
-            // Fill instance buffer
-            uint8_t* data = idb.data;
-            for (uint32_t i = 0; i < modelCount; i++) {
-                // TODO : Can probably be optimized
-                std::memcpy(data, glm::value_ptr(kvp.second.Transformations[i]), instanceStride);
-                data += instanceStride;
-            }
-
-            // Uniform
-            bgfx::setUniform(mType->getUniformHandle(), material->getPropertyData(), UINT16_MAX);
-
-            // Samplers
-            for (size_t i = 0; i < material->getSamplerCount(); i++) {
-                bgfx::setTexture(i, mType->getSampler(i), material->getSampler(i)->getTextureHandle());
-            }
-
-            // Bind buffers
-            bgfx::setVertexBuffer(0, mesh->getVboHandle());
-            bgfx::setIndexBuffer(mesh->getIboHandle());
-            bgfx::setInstanceDataBuffer(&idb);
-
-            // Set render state
-            uint64_t state = 0 | BGFX_STATE_WRITE_R | BGFX_STATE_WRITE_G | BGFX_STATE_WRITE_B | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
-                             BGFX_STATE_DEPTH_TEST_LESS | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA;
-
-            bgfx::setState(state);
+    // Render for each camera, the graph assigns views and shares targets between cameras
+    m_cullingStats = {};
+    m_overflowBuffersUsed = 0;
+    m_overflowInstances = 0;
+    m_graph.reset();
+    const FrameData& frame = m_frames.getRead();
+    for (const rendering::CameraData& cd : frame.Cameras) {
+        this->addCameraPasses(frame, cd);
+    }
 
-            // uint8_t flags = BGFX_DISCARD_ALL &
-            //                ~(BGFX_DISCARD_BINDINGS | BGFX_DISCARD_INDEX_BUFFER | BGFX_DISCARD_VERTEX_STREAMS | BGFX_DISCARD_STATE);
-            //
-            // Submit draw call
-            bgfx::submit(viewIdx, mType->getShaderHandle(), 0, BGFX_DISCARD_ALL);
+    // Material properties are staged and uploaded once per frame, every view reads the same rows
+    for (const auto& kvp : frame.DrawCalls) {
+        if (!kvp.second.Transformations.empty() && kvp.second.Material != nullptr) {
+            m_materialBuffer.resolve(kvp.second.Material);
         }
+    }
+    m_materialBuffer.upload();
 
-        // 5. Copy result
-        bgfx::blit(viewIdx + 1, cd.Output, 0, 0, bgfx::getTexture(m_mainFbo));
+    m_graph.compile();
+    m_graph.execute();
 
-        viewIdx += 2;
+    if (m_overflowInstances > 0) {
+        LOG_WARN("[Rendering] Transient instance buffer full, {0} instances were drawn from overflow buffers", m_overflowInstances);
     }
 
     bgfx::discard(BGFX_DISCARD_ALL);
@@ -297,49 +277,558 @@ void Renderer::commit() {
     // const bgfx::Stats* stats = bgfx::getStats();
     // LOG_INFO("Commiting {0} draw calls", stats->numDraw);
 
-    // Copy this frame write data to read data
-    m_readData = m_writeData;
+    // Stats of the frame that was just submitted
+    if (m_profiling) {
+        m_graph.readTimings();
+    }
 
-    // Clear write data
-    m_writeData.Cameras.clear();
-    m_writeData.DrawCalls.clear();
+    // Upload instance sets that stopped changing
+    this->updatePersistentInstances();
+
+    // Publish this frame write data for reading, nothing is copied
+    m_frames.swap();
 }
 
 FrameData& Renderer::getWriteFrameData() {
-    return m_writeData;
+    return m_frames.getWrite();
 }
 
-bool Renderer::createTargets() {
-    // Create
-    m_mainFbo = createFramebuffer();
-    if (!bgfx::isValid(m_mainFbo)) {
-        LOG_WARN("[Rendering] Failed to create main framebuffer");
-        return false;
+void Renderer::setMultithreadedSubmission(bool enabled) {
+    m_multithreadedSubmission = enabled;
+}
+
+void Renderer::setOcclusionCulling(bool enabled) {
+    m_culler.setOcclusionCulling(enabled);
+}
+
+const CullingStats& Renderer::getCullingStats() const {
+    return m_cullingStats;
+}
+
+void Renderer::setProfiling(bool enabled) {
+    m_profiling = enabled;
+    bgfx::setDebug(enabled ? BGFX_DEBUG_PROFILER : BGFX_DEBUG_NONE);
+}
+
+const std::vector<RenderGraph::PassTiming>& Renderer::getPassTimings() const {
+    return m_graph.getTimings();
+}
+
+void Renderer::addCameraPasses(const FrameData& frame, const CameraData& cd) {
+    // Debug values
+    bgfx::setName(cd.Output, cd.Name.c_str());
+
+    const RenderGraph::Resource output = m_graph.import(cd.Name + " - Output", cd.Output);
+    const glm::mat4 viewProjection = cd.ProjectionMatrix * cd.ViewMatrix;
+
+    // The first pass of the camera culls, the following ones reuse the visible set
+    const auto cull = [this, &frame, &cd, viewProjection]() {
+        m_culler.cull(viewProjection, frame.DrawCalls, std::hash<std::string>()(cd.Name));
+        m_cullingStats += m_culler.getStats();
+    };
+
+    // Depth prepass, opaque geometry only writes depth so the object pass shades every pixel once
+    RenderGraph::Resource color = RenderGraph::c_InvalidResource;
+    RenderGraph::Resource depth = RenderGraph::c_InvalidResource;
+    if (cd.DepthPrepass) {
+        RenderGraph::PassBuilder prepass =
+            m_graph.addPass(cd.Name + " - Depth prepass", [this, &cd, cull, viewProjection](bgfx::ViewId view) {
+                bgfx::setViewTransform(view, glm::value_ptr(cd.ViewMatrix), glm::value_ptr(cd.ProjectionMatrix));
+                bgfx::discard(BGFX_DISCARD_ALL);
+                cull();
+                this->submitDrawCalls(view, viewProjection, SubmitMode::DEPTH);
+            });
+
+        color = prepass.create("Color", {bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_RT | c_TargetFlags});
+        depth = prepass.create("Depth", {m_depthFormat, BGFX_TEXTURE_RT_WRITE_ONLY | c_TargetFlags});
+        prepass.attach(color);
+        prepass.attach(depth);
+        prepass.setClear(BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, c_ClearColor, 1.0f, 0);
     }
 
-    // Set name
-    bgfx::setName(m_mainFbo, "Main pass framebuffer");
+    // Object rendering
+    RenderGraph::PassBuilder objects =
+        m_graph.addPass(cd.Name + " - Object rendering", [this, &cd, cull, viewProjection](bgfx::ViewId view) {
+            // Setup persistent matrices
+            bgfx::setViewTransform(view, glm::value_ptr(cd.ViewMatrix), glm::value_ptr(cd.ProjectionMatrix));
 
-    return true;
+            // Discard previous state
+            bgfx::discard(BGFX_DISCARD_ALL);
+
+            if (!cd.DepthPrepass) {
+                cull();
+            }
+
+            // Submit draw calls
+            this->submitDrawCalls(view, viewProjection, cd.DepthPrepass ? SubmitMode::COLOR_EQUAL : SubmitMode::COLOR);
+        });
+
+    if (cd.DepthPrepass) {
+        // Continues on the prepass targets
+        objects.read(color);
+        objects.read(depth);
+    } else {
+        color = objects.create("Color", {bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_RT | c_TargetFlags});
+        depth = objects.create("Depth", {m_depthFormat, BGFX_TEXTURE_RT_WRITE_ONLY | c_TargetFlags});
+        objects.setClear(BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, c_ClearColor, 1.0f, 0);
+    }
+
+    objects.attach(color);
+    objects.attach(depth);
+
+    // Copy result
+    RenderGraph::PassBuilder copy = m_graph.addPass(cd.Name + " - Output copy", [this, &cd, color](bgfx::ViewId view) {
+        bgfx::blit(view, cd.Output, 0, 0, m_graph.getTexture(color));
+    });
+
+    copy.read(color);
+    copy.write(output);
 }
 
-void Renderer::prepareTargets() {
-    // bgfx::
+/**
+ * @brief Returns what identifies the bindings of the material, materials in the material buffer that have no samplers only
+ * bind the buffer so all materials of their type share the same bindings and can be drawn together
+ */
+static const void* getBindings(const asset::MaterialAsset* material) {
+    const asset::MaterialTypeAsset* mType = material->getMaterialType();
+    if (MaterialBuffer::isStored(mType) && mType->getSamplerCount() == 0) {
+        return mType;
+    }
+
+    return material;
 }
 
-void Renderer::setupView(uint8_t idx, const std::string& name) {
-    ADERITE_DYNAMIC_ASSERT((((uint16_t)idx) + 1) <= 255, "To many cameras view index >255");
+void Renderer::submitDrawCalls(bgfx::ViewId viewIdx, const glm::mat4& viewProjection, SubmitMode mode) {
+    const std::vector<VisibleDrawCall>& visible = m_culler.getVisible();
+    const std::vector<glm::mat4>& transformations = m_culler.getTransformations();
+
+    // Order by state so that adjacent draws share as much as possible, depth is taken from the first instance
+    const glm::vec4 depthRow = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+    m_queue.clear();
+    for (size_t i = 0; i < visible.size(); i++) {
+        const VisibleDrawCall& dc = visible[i];
+        const asset::MaterialTypeAsset* mType = dc.Call->Material->getMaterialType();
+        const bool prepassed = bgfx::isValid(mType->getDepthShaderHandle());
+        if (mode == SubmitMode::DEPTH && !prepassed) {
+            // Transparent or compiled without a depth variant, only drawn in the object pass
+            continue;
+        }
 
-    // static const uint32_t ColorClearColor = 0x252525FF;
-    static const uint32_t ColorClearColor = 0x9ACBFFFF;
-    static const float DepthClearValue = 1.0f;
-    static const uint8_t StencilClearValue = 0;
+        const bgfx::ProgramHandle program = mode == SubmitMode::DEPTH ? mType->getDepthShaderHandle() : mType->getShaderHandle();
+        const float depth = glm::dot(depthRow, transformations[dc.First][3]);
+        const uint16_t mesh = static_cast<uint16_t>((dc.Call->Mesh->getVboHandle().idx << 2) | dc.Lod);
+        const uint16_t material = getBindings(dc.Call->Material) == mType ? 0 : static_cast<uint16_t>(dc.Call->Material->getHandle());
+        m_queue.push(RenderQueue::makeKey(viewIdx, mType->isTransparent(), program.idx, material, mesh, depth), static_cast<uint32_t>(i));
+    }
+    m_queue.sort();
+
+    const std::vector<RenderQueue::Item>& items = m_queue.getItems();
+
+    // Persistent buffers and material buffer rows are looked up here, the workers only read the result
+    m_instanceSources.resize(visible.size());
+    m_materialSlots.resize(visible.size());
+    for (size_t i = 0; i < visible.size(); i++) {
+        const DrawCall* call = visible[i].Call;
+        m_instanceSources[i] = BGFX_INVALID_HANDLE;
+        m_materialSlots[i] = m_materialBuffer.getSlot(call->Material);
+
+        // Only usable if every instance is visible, the buffer holds the whole set with the current material row
+        if (call->Static && visible[i].Count == call->Transformations.size()) {
+            auto it = m_persistentInstances.find(call->Signature);
+            if (it != m_persistentInstances.end() && it->second.Uploaded && it->second.Slot == m_materialSlots[i]) {
+                m_instanceSources[i] = it->second.Buffer;
+            }
+        }
+    }
+
+    // The main thread encoder is not available to workers
+    threading::JobSystem* jobSystem = ::aderite::Engine::getJobSystem();
+    size_t encoderCount = 1;
+    if (m_multithreadedSubmission) {
+        encoderCount = std::min({static_cast<size_t>(bgfx::getCaps()->limits.maxEncoders) - 1, jobSystem->getWorkerCount() + 1,
+                                 items.size() / c_MinDrawCallsPerEncoder});
+    }
+
+    if (encoderCount <= 1) {
+        SubmitRange range;
+        range.Last = items.size();
+        this->allocateInstances(range);
+        this->submitRange(bgfx::begin(), viewIdx, range, mode);
+        this->uploadOverflow(range);
+        return;
+    }
+
+    // Ranges are cut on material type boundaries unless that makes them twice as large as they should be
+    const size_t target = (items.size() + encoderCount - 1) / encoderCount;
+    m_submitRanges.clear();
+    for (size_t first = 0; first < items.size();) {
+        size_t last = std::min(first + target, items.size());
+        while (last < items.size() && last - first < target * 2 &&
+               visible[items[last].Index].Call->Material->getMaterialType() ==
+                   visible[items[last - 1].Index].Call->Material->getMaterialType()) {
+            last++;
+        }
 
-    // Object render
-    bgfx::setViewClear(idx, BGFX_CLEAR_COLOR | BGFX_CLEAR_DEPTH, ColorClearColor, DepthClearValue, StencilClearValue);
-    bgfx::setViewRect(idx, 0, 0, m_resolution.x, m_resolution.y);
-    bgfx::setViewName(idx, (name + " - Object rendering").c_str());
-    bgfx::setViewName(idx + 1, (name + " - Output copy").c_str());
+        SubmitRange& range = m_submitRanges.emplace_back();
+        range.First = first;
+        range.Last = last;
+        this->allocateInstances(range);
+        first = last;
+    }
+
+    m_submitJobs.clear();
+    for (const SubmitRange& range : m_submitRanges) {
+        m_submitJobs.push_back(jobSystem->schedule(
+            [this, viewIdx, mode, &range]() {
+                bgfx::Encoder* encoder = bgfx::begin(true);
+                if (encoder == nullptr) {
+                    LOG_ERROR("[Rendering] No bgfx encoder available for draw call submission");
+                    return;
+                }
+
+                this->submitRange(encoder, viewIdx, range, mode);
+                bgfx::end(encoder);
+            },
+            threading::Job::Priority::CRITICAL));
+    }
+
+    // Only help with frame critical work, a load picked up here would stall the frame
+    for (const threading::JobHandle& job : m_submitJobs) {
+        jobSystem->wait(job, threading::Job::Priority::CRITICAL);
+    }
+
+    for (SubmitRange& range : m_submitRanges) {
+        this->uploadOverflow(range);
+    }
+}
+
+/**
+ * @brief Render state of a material type in the submission mode
+ */
+static uint64_t getState(const asset::MaterialTypeAsset* mType, Renderer::SubmitMode mode) {
+    if (mode == Renderer::SubmitMode::DEPTH) {
+        return BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_LESS | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA;
+    }
+
+    if (mType->isTransparent()) {
+        return BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_DEPTH_TEST_LESS | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA |
+               BGFX_STATE_BLEND_ALPHA;
+    }
+
+    if (mode == Renderer::SubmitMode::COLOR_EQUAL && bgfx::isValid(mType->getDepthShaderHandle())) {
+        // Depth is already final, only the visible surface passes
+        return BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_DEPTH_TEST_EQUAL | BGFX_STATE_CULL_CCW | BGFX_STATE_MSAA;
+    }
+
+    return BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_LESS | BGFX_STATE_CULL_CCW |
+           BGFX_STATE_MSAA;
+}
+
+void Renderer::allocateInstances(SubmitRange& range) {
+    const std::vector<VisibleDrawCall>& visible = m_culler.getVisible();
+    const std::vector<RenderQueue::Item>& items = m_queue.getItems();
+
+    // Draw calls drawn from their persistent buffer don't need transient instance data
+    uint32_t total = 0;
+    for (size_t i = range.First; i < range.Last; i++) {
+        if (!bgfx::isValid(m_instanceSources[items[i].Index])) {
+            total += static_cast<uint32_t>(visible[items[i].Index].Count);
+        }
+    }
+
+    range.Instances = {};
+    range.Overflow = BGFX_INVALID_HANDLE;
+    range.OverflowData = nullptr;
+    if (total == 0) {
+        return;
+    }
+
+    const uint32_t available = bgfx::getAvailInstanceDataBuffer(total, c_InstanceStride);
+    if (available > 0) {
+        bgfx::allocInstanceDataBuffer(&range.Instances, available, c_InstanceStride);
+    }
+
+    if (available == total) {
+        return;
+    }
+
+    // Transient memory of the frame is used up, the rest is written into a buffer of the pool. Buffers are only grown
+    // when they are picked up again, by then the frame that used them was submitted.
+    const uint32_t overflow = total - available;
+    if (m_overflowBuffersUsed == m_overflowBuffers.size()) {
+        m_overflowBuffers.emplace_back();
+    }
+
+    OverflowBuffer& buffer = m_overflowBuffers[m_overflowBuffersUsed++];
+    if (buffer.Capacity < overflow) {
+        if (bgfx::isValid(buffer.Buffer)) {
+            bgfx::destroy(buffer.Buffer);
+        }
+
+        buffer.Buffer = bgfx::createDynamicVertexBuffer(overflow, instanceLayout());
+        buffer.Capacity = overflow;
+    }
+
+    range.Overflow = buffer.Buffer;
+    range.OverflowData = bgfx::alloc(overflow * c_InstanceStride);
+    m_overflowInstances += overflow;
+}
+
+void Renderer::uploadOverflow(SubmitRange& range) {
+    if (range.OverflowData == nullptr) {
+        return;
+    }
+
+    // Updates are applied before the draws of the frame are executed
+    bgfx::update(range.Overflow, 0, range.OverflowData);
+    range.OverflowData = nullptr;
+}
+
+void Renderer::submitRange(bgfx::Encoder* encoder, bgfx::ViewId viewIdx, const SubmitRange& range, SubmitMode mode) {
+    const std::vector<VisibleDrawCall>& visible = m_culler.getVisible();
+    const std::vector<glm::mat4>& transformations = m_culler.getTransformations();
+    const std::vector<RenderQueue::Item>& items = m_queue.getItems();
+    const size_t first = range.First;
+    const size_t last = range.Last;
+    const uint16_t instanceStride = c_InstanceStride;
+
+    // Draw calls of materials in the material buffer that share bindings, program, mesh and detail level are one draw
+    const auto mergeable = [&](const VisibleDrawCall& a, size_t index) {
+        const VisibleDrawCall& b = visible[items[index].Index];
+        return getBindings(a.Call->Material) == a.Call->Material->getMaterialType() &&
+               getBindings(a.Call->Material) == getBindings(b.Call->Material) && a.Call->Mesh == b.Call->Mesh && a.Lod == b.Lod &&
+               m_materialSlots[items[index].Index] != MaterialBuffer::c_InvalidSlot &&
+               !bgfx::isValid(m_instanceSources[items[index].Index]);
+    };
+
+    const bool depthOnly = mode == SubmitMode::DEPTH;
+    const VisibleDrawCall* previous = nullptr;
+    uint64_t previousState = 0;
+    uint32_t used = 0;
+    uint32_t overflowUsed = 0;
+    for (size_t index = first; index < last;) {
+        const VisibleDrawCall& dc = visible[items[index].Index];
+        const bgfx::DynamicVertexBufferHandle persistent = m_instanceSources[items[index].Index];
+
+        // Run of draw calls drawn together
+        size_t end = index + 1;
+        if (!bgfx::isValid(persistent) && m_materialSlots[items[index].Index] != MaterialBuffer::c_InvalidSlot) {
+            while (end < last && mergeable(dc, end)) {
+                end++;
+            }
+        }
+
+        const VisibleDrawCall* next = end < last ? &visible[items[end].Index] : nullptr;
+
+        // Extract assets
+        const asset::MaterialAsset* material = dc.Call->Material;
+        const asset::MeshAsset* mesh = dc.Call->Mesh;
+        const asset::MaterialTypeAsset* mType = material->getMaterialType();
+        const bgfx::ProgramHandle program = depthOnly ? mType->getDepthShaderHandle() : mType->getShaderHandle();
+        const uint64_t state = getState(mType, mode);
+        const bool stored = MaterialBuffer::isStored(mType);
+
+        // Material buffer ran out of rows, the draw would read the properties of another material
+        if (stored && m_materialSlots[items[index].Index] == MaterialBuffer::c_InvalidSlot) {
+            encoder->discard(BGFX_DISCARD_ALL);
+            previous = nullptr;
+            index = end;
+            continue;
+        }
+
+        // Samplers, kept from the previous draw if the bindings are the same, nothing is sampled when only depth is written
+        if (!depthOnly && (previous == nullptr || getBindings(previous->Call->Material) != getBindings(material))) {
+            for (size_t i = 0; i < material->getSamplerCount(); i++) {
+                encoder->setTexture(i, mType->getSampler(i), material->getSampler(i)->getTextureHandle());
+            }
+
+            if (stored) {
+                encoder->setTexture(MaterialBuffer::c_Stage, m_materialBuffer.getSampler(), m_materialBuffer.getTexture());
+            }
+        }
+
+        // Bind buffers, kept from the previous draw if the mesh is the same, detail levels are index ranges of the mesh
+        if (previous == nullptr || previous->Call->Mesh != mesh) {
+            encoder->setVertexBuffer(0, mesh->getVboHandle());
+        }
+
+        if (previous == nullptr || previous->Call->Mesh != mesh || previous->Lod != dc.Lod) {
+            if (mesh->getLodCount() > 0) {
+                const io::MeshCooker::Lod& lod = mesh->getLod(dc.Lod);
+                encoder->setIndexBuffer(mesh->getIboHandle(), lod.FirstIndex, lod.IndexCount);
+            } else {
+                encoder->setIndexBuffer(mesh->getIboHandle());
+            }
+        }
+
+        // Set render state
+        if (previous == nullptr || previousState != state) {
+            encoder->setState(state);
+        }
+
+        // Only discard what the next draw changes
+        uint8_t discard = BGFX_DISCARD_ALL;
+        if (next != nullptr) {
+            discard = BGFX_DISCARD_INSTANCE_DATA | BGFX_DISCARD_TRANSFORM;
+            if (getBindings(next->Call->Material) != getBindings(material)) {
+                discard |= BGFX_DISCARD_BINDINGS;
+            }
+
+            if (next->Call->Mesh != mesh) {
+                discard |= BGFX_DISCARD_VERTEX_STREAMS | BGFX_DISCARD_INDEX_BUFFER;
+            } else if (next->Lod != dc.Lod) {
+                discard |= BGFX_DISCARD_INDEX_BUFFER;
+            }
+
+            if (getState(next->Call->Material->getMaterialType(), mode) != state) {
+                discard |= BGFX_DISCARD_STATE;
+            }
+        }
+
+        previous = &dc;
+        previousState = state;
+
+        // Uniform, always set since bgfx reorders draws and a skipped update could pick up another material values, types in
+        // the material buffer read their properties from the row stored in the instance data instead
+        const bool uniform = !depthOnly && !stored;
+
+        // Static instances that were uploaded once are drawn straight from their persistent buffer
+        if (bgfx::isValid(persistent)) {
+            if (uniform) {
+                encoder->setUniform(mType->getUniformHandle(), material->getPropertyData(), UINT16_MAX);
+            }
+
+            encoder->setInstanceDataBuffer(persistent, 0, static_cast<uint32_t>(dc.Count));
+            encoder->submit(viewIdx, program, 0, discard);
+            index = end;
+            continue;
+        }
+
+        uint32_t total = 0;
+        for (size_t i = index; i < end; i++) {
+            total += static_cast<uint32_t>(visible[items[i].Index].Count);
+        }
+
+        // Visible transformations are packed so every draw call of the run is filled with a single copy
+        size_t part = index;
+        uint32_t offset = 0;
+        const auto pack = [&](uint8_t* destination, uint32_t instances) {
+            uint32_t filled = 0;
+            while (filled < instances) {
+                const VisibleDrawCall& source = visible[items[part].Index];
+                const uint16_t slot = m_materialSlots[items[part].Index];
+                const uint32_t count = std::min(instances - filled, static_cast<uint32_t>(source.Count) - offset);
+                uint8_t* target = destination + static_cast<size_t>(filled) * instanceStride;
+                std::memcpy(target, transformations.data() + source.First + offset, static_cast<size_t>(count) * instanceStride);
+
+                // Material buffer row goes into the unused projective part of the first column
+                if (slot != MaterialBuffer::c_InvalidSlot) {
+                    for (uint32_t i = 0; i < count; i++) {
+                        reinterpret_cast<float*>(target + static_cast<size_t>(i) * instanceStride)[3] = static_cast<float>(slot);
+                    }
+                }
+
+                filled += count;
+                offset += count;
+                if (offset == source.Count) {
+                    part++;
+                    offset = 0;
+                }
+            }
+        };
+
+        // Transient instance data first, whatever doesn't fit is drawn again from the overflow buffer of the range
+        const uint32_t batch = std::min(total, range.Instances.num - used);
+        const uint32_t overflow = total - batch;
+        if (batch > 0) {
+            pack(range.Instances.data + static_cast<size_t>(used) * instanceStride, batch);
+            if (uniform) {
+                encoder->setUniform(mType->getUniformHandle(), material->getPropertyData(), UINT16_MAX);
+            }
+
+            encoder->setInstanceDataBuffer(&range.Instances, used, batch);
+            used += batch;
+            encoder->submit(viewIdx, program, 0, overflow > 0 ? BGFX_DISCARD_INSTANCE_DATA : discard);
+        }
+
+        if (overflow > 0) {
+            pack(range.OverflowData->data + static_cast<size_t>(overflowUsed) * instanceStride, overflow);
+            if (uniform) {
+                encoder->setUniform(mType->getUniformHandle(), material->getPropertyData(), UINT16_MAX);
+            }
+
+            encoder->setInstanceDataBuffer(range.Overflow, overflowUsed, overflow);
+            overflowUsed += overflow;
+            encoder->submit(viewIdx, program, 0, discard);
+        }
+
+        index = end;
+    }
+}
+
+void Renderer::updatePersistentInstances() {
+    m_frameIndex++;
+
+    const FrameData& frame = m_frames.getWrite();
+    for (const auto& kvp : frame.DrawCalls) {
+        const DrawCall& dc = kvp.second;
+        if (dc.Transformations.empty()) {
+            continue;
+        }
+
+        PersistentInstances& persistent = m_persistentInstances[dc.Signature];
+        if (!dc.Static || persistent.LastFrame + 1 != m_frameIndex) {
+            // Changed or wasn't rendered last frame, has to stay unchanged for a while again
+            persistent.StableFrames = 0;
+            persistent.Uploaded = false;
+        }
+
+        // Material buffer row is baked into the instances, a new row only needs a new upload
+        const uint16_t slot = dc.Static && dc.Material != nullptr ? m_materialBuffer.resolve(dc.Material) : MaterialBuffer::c_InvalidSlot;
+        if (persistent.Uploaded && persistent.Slot != slot) {
+            persistent.Uploaded = false;
+        }
+
+        persistent.LastFrame = m_frameIndex;
+        persistent.StableFrames++;
+        if (persistent.Uploaded || persistent.StableFrames < c_StaticFrames) {
+            continue;
+        }
+
+        const uint32_t count = static_cast<uint32_t>(dc.Transformations.size());
+        if (persistent.Capacity < count) {
+            if (bgfx::isValid(persistent.Buffer)) {
+                bgfx::destroy(persistent.Buffer);
+            }
+
+            persistent.Buffer = bgfx::createDynamicVertexBuffer(count, instanceLayout());
+            persistent.Capacity = count;
+        }
+
+        const bgfx::Memory* memory = bgfx::copy(dc.Transformations.data(), count * sizeof(glm::mat4));
+        if (slot != MaterialBuffer::c_InvalidSlot) {
+            for (uint32_t i = 0; i < count; i++) {
+                reinterpret_cast<float*>(memory->data + static_cast<size_t>(i) * sizeof(glm::mat4))[3] = static_cast<float>(slot);
+            }
+        }
+
+        bgfx::update(persistent.Buffer, 0, memory);
+        persistent.Slot = slot;
+        persistent.Uploaded = true;
+    }
+
+    // Instance sets that weren't rendered for a while
+    for (auto it = m_persistentInstances.begin(); it != m_persistentInstances.end();) {
+        if (it->second.LastFrame + c_PersistentFrames < m_frameIndex) {
+            if (bgfx::isValid(it->second.Buffer)) {
+                bgfx::destroy(it->second.Buffer);
+            }
+
+            it = m_persistentInstances.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 } // namespace rendering
@@ -1,13 +1,21 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <bgfx/bgfx.h>
 #include <glm/glm.hpp>
 
+#include "aderite/rendering/Culler.hpp"
 #include "aderite/rendering/Forward.hpp"
 #include "aderite/rendering/FrameData.hpp"
+#include "aderite/rendering/MaterialBuffer.hpp"
+#include "aderite/rendering/RenderGraph.hpp"
+#include "aderite/rendering/RenderQueue.hpp"
 #include "aderite/scene/Forward.hpp"
+#include "aderite/threading/Forward.hpp"
 
 namespace aderite {
 class Engine;
@@ -18,13 +26,39 @@ namespace rendering {
  * @brief The Renderer of aderite powered by bgfx
  */
 class Renderer final {
+public:
+    /**
+     * @brief Draw calls are only spread across workers if every encoder gets at least this many
+     */
+    static constexpr size_t c_MinDrawCallsPerEncoder = 64;
+
+    /**
+     * @brief Frames an instance set has to stay unchanged before it is uploaded into a persistent buffer
+     */
+    static constexpr uint32_t c_StaticFrames = 3;
+
+    /**
+     * @brief Frames a persistent instance buffer is kept after its instance set was last rendered
+     */
+    static constexpr uint64_t c_PersistentFrames = 120;
+
+    /**
+     * @brief What a submission of the visible draw calls renders
+     */
+    enum class SubmitMode {
+        COLOR,       // Shaded with a less depth test
+        DEPTH,       // Depth only, opaque draw calls with a depth variant
+        COLOR_EQUAL, // Shaded, draw calls that were in the depth prepass only where their depth is equal
+    };
+
 public:
     virtual ~Renderer() {}
 
     /**
      * @brief Initializes the Renderer
+     * @param noop If true the bgfx Noop backend is used, only CPU work is done
      */
-    bool init();
+    bool init(bool noop = false);
 
     /**
      * @brief Shutdown Renderer
@@ -69,23 +103,91 @@ public:
      */
     FrameData& getWriteFrameData();
 
+    /**
+     * @brief Enables or disables software occlusion culling
+     */
+    void setOcclusionCulling(bool enabled);
+
+    /**
+     * @brief Enables or disables submitting draw calls from job workers through bgfx encoders
+     */
+    void setMultithreadedSubmission(bool enabled);
+
+    /**
+     * @brief Returns the culling counters of the last rendered frame summed over all cameras
+     */
+    const CullingStats& getCullingStats() const;
+
+    /**
+     * @brief Enables or disables collecting per pass timings, timings are collected by bgfx so this has a small cost
+     */
+    void setProfiling(bool enabled);
+
+    /**
+     * @brief Returns the timings of the passes of the last profiled frame
+     */
+    const std::vector<RenderGraph::PassTiming>& getPassTimings() const;
+
 private:
     /**
-     * @brief Creates render targets of the renderer
+     * @brief Adds the passes rendering the camera into the render graph
+     * @param frame Frame that is rendered
+     * @param cd Camera to render
+     */
+    void addCameraPasses(const FrameData& frame, const CameraData& cd);
+
+    /**
+     * @brief Sorts the visible draw calls of the last cull into the render queue and submits them, partitioned by
+     * material type across job workers
+     * @param viewIdx View to submit to
+     * @param viewProjection View projection matrix of the camera, used for depth sorting
+     * @param mode What is rendered
+     */
+    void submitDrawCalls(bgfx::ViewId viewIdx, const glm::mat4& viewProjection, SubmitMode mode);
+
+    /**
+     * @brief Range of the render queue submitted through one encoder
+     */
+    struct SubmitRange {
+        size_t First = 0;
+        size_t Last = 0;
+
+        // Transient instance data of the range, allocated before the range is submitted
+        bgfx::InstanceDataBuffer Instances {};
+
+        // Instances that didn't fit into the transient buffer, filled by the submission and uploaded once it's done
+        bgfx::DynamicVertexBufferHandle Overflow = BGFX_INVALID_HANDLE;
+        const bgfx::Memory* OverflowData = nullptr;
+    };
+
+    /**
+     * @brief Allocates the transient instance data of the range, has to be called from the main thread since checking the
+     * space left and allocating isn't atomic. Once the transient buffer of the frame is used up the rest of the range is
+     * drawn from an overflow buffer.
+     * @param range Range to allocate for
      */
-    bool createTargets();
+    void allocateInstances(SubmitRange& range);
 
     /**
-     * @brief Prepares targets for a render pass (clears information)
+     * @brief Uploads the overflow instances of a submitted range, has to be called from the main thread
+     * @param range Submitted range
      */
-    void prepareTargets();
+    void uploadOverflow(SubmitRange& range);
 
     /**
-     * @brief Sets up the view index
-     * @param idx View index
-     * @param name Name of the view
+     * @brief Submits a range of the render queue through the encoder, state shared with the neighbouring draws is only
+     * bound once
+     * @param encoder Encoder to submit with
+     * @param viewIdx View to submit to
+     * @param range Range of the render queue with its instance data allocated
+     * @param mode What is rendered
      */
-    void setupView(uint8_t idx, const std::string& name);
+    void submitRange(bgfx::Encoder* encoder, bgfx::ViewId viewIdx, const SubmitRange& range, SubmitMode mode);
+
+    /**
+     * @brief Tracks which instance sets of the write frame stopped changing and uploads them into persistent buffers
+     */
+    void updatePersistentInstances();
 
 private:
     Renderer() {}
@@ -95,18 +197,58 @@ private:
     bool m_isInitialized = false;
 
     // Frame data
-    FrameData m_readData;
-    FrameData m_writeData;
+    FrameDataRing m_frames;
 
-    // BGFX views
-    glm::uvec2 m_resolution = glm::uvec2(1280, 920);
+    // Culling
+    Culler m_culler;
+    CullingStats m_cullingStats;
 
-    // Targets
+    /**
+     * @brief Instance set uploaded once and drawn from GPU memory while it doesn't change
+     */
+    struct PersistentInstances {
+        bgfx::DynamicVertexBufferHandle Buffer = BGFX_INVALID_HANDLE;
+        uint32_t Capacity = 0;
+        uint32_t StableFrames = 0;
+        uint64_t LastFrame = 0;
+        uint16_t Slot = MaterialBuffer::c_InvalidSlot;
+        bool Uploaded = false;
+    };
+
+    // Persistent instances, keyed by draw call signature
+    uint64_t m_frameIndex = 0;
+    std::unordered_map<size_t, PersistentInstances> m_persistentInstances;
+    std::vector<bgfx::DynamicVertexBufferHandle> m_instanceSources;
+
+    // Material properties, rows of the visible draw calls are looked up before submission
+    MaterialBuffer m_materialBuffer;
+    std::vector<uint16_t> m_materialSlots;
 
     /**
-     * @brief This will be the target where the result will be stored
+     * @brief Instance buffer used when the transient instance buffer of the frame is full, reused between frames
      */
-    bgfx::FrameBufferHandle m_mainFbo = BGFX_INVALID_HANDLE;
+    struct OverflowBuffer {
+        bgfx::DynamicVertexBufferHandle Buffer = BGFX_INVALID_HANDLE;
+        uint32_t Capacity = 0;
+    };
+
+    std::vector<OverflowBuffer> m_overflowBuffers;
+    size_t m_overflowBuffersUsed = 0;
+    uint32_t m_overflowInstances = 0;
+
+    // Submission, reused between frames
+    bool m_multithreadedSubmission = true;
+    RenderQueue m_queue;
+    std::vector<SubmitRange> m_submitRanges;
+    std::vector<threading::JobHandle> m_submitJobs;
+
+    // BGFX views
+    glm::uvec2 m_resolution = glm::uvec2(1280, 920);
+
+    // Passes and transient targets of the frame, targets are pooled between frames and cameras
+    RenderGraph m_graph;
+    bool m_profiling = false;
+    bgfx::TextureFormat::Enum m_depthFormat = bgfx::TextureFormat::Count;
 };
 
 } // namespace rendering
@@ -0,0 +1,312 @@
+#include "StaticBatcher.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include "aderite/Aderite.hpp"
+#include "aderite/asset/MaterialAsset.hpp"
+#include "aderite/asset/MeshAsset.hpp"
+#include "aderite/io/Loader.hpp"
+#include "aderite/rendering/FrameData.hpp"
+#include "aderite/rendering/Renderable.hpp"
+#include "aderite/scene/ComponentRegistry.hpp"
+#include "aderite/scene/TransformProvider.hpp"
+#include "aderite/threading/JobSystem.hpp"
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+#include "aderite/utility/Utility.hpp"
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Seed of the static batch draw call keys
+ */
+static constexpr size_t c_BatchSeed = 0x5B47C4A1;
+
+StaticBatcher::~StaticBatcher() {
+    this->clear();
+
+    // Nothing renders the scene anymore once its batcher is gone
+    for (RetiredBatch& retired : m_retired) {
+        retired.Batch.Material->release();
+    }
+}
+
+void StaticBatcher::build(scene::ComponentRegistry& components) {
+    // Every material with static renderables is built once, after that only invalidated ones
+    if (!m_built) {
+        components.getRenderables().each([this](scene::Entity entity, Renderable& renderable) {
+            const RenderableData& data = renderable.getData();
+            if (data.isStatic() && data.getMaterial() != nullptr) {
+                m_builds[data.getMaterial()];
+            }
+        });
+
+        m_built = true;
+    }
+
+    for (auto it = m_builds.begin(); it != m_builds.end();) {
+        PendingBuild& build = it->second;
+        if (build.Job == nullptr) {
+            if (!this->schedule(components, it->first, build) || build.Job != nullptr) {
+                // Still loading or being merged
+                ++it;
+                continue;
+            }
+        } else if (!build.Job->isFinished()) {
+            ++it;
+            continue;
+        } else {
+            this->upload(components, it->first, *build.Data);
+        }
+
+        it = m_builds.erase(it);
+    }
+}
+
+void StaticBatcher::invalidate(scene::ComponentRegistry& components, asset::MaterialAsset* material) {
+    if (!m_built || material == nullptr) {
+        return;
+    }
+
+    for (auto it = m_batches.begin(); it != m_batches.end();) {
+        if (it->Material == material) {
+            this->retire(std::move(*it));
+            it = m_batches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    components.getRenderables().each([material](scene::Entity entity, Renderable& renderable) {
+        if (renderable.getBatch() == material) {
+            renderable.setBatch(nullptr);
+        }
+    });
+
+    // Built again by the next build, a job that is still merging the old set finishes into its own data
+    m_builds[material] = PendingBuild();
+}
+
+bool StaticBatcher::schedule(scene::ComponentRegistry& components, asset::MaterialAsset* material, PendingBuild& build) {
+    std::shared_ptr<Build> data = std::make_shared<Build>();
+    bool loading = false;
+    components.getRenderables().each([&](scene::Entity entity, Renderable& renderable) {
+        const RenderableData& renderableData = renderable.getData();
+        if (!renderableData.isStatic() || renderableData.getMaterial() != material || renderableData.getMesh() == nullptr) {
+            return;
+        }
+
+        // Wait until every static renderable of the material is resident
+        if (!renderableData.isValid()) {
+            loading = true;
+            return;
+        }
+
+        const scene::TransformProvider* transform = components.getTransforms().get(entity);
+        if (transform != nullptr) {
+            data->Sources.push_back({entity, renderableData.getMesh()->getHandle(), transform->getWorldMatrix()});
+        }
+    });
+
+    if (loading) {
+        return false;
+    }
+
+    if (data->Sources.empty()) {
+        // Nothing left to merge
+        return true;
+    }
+
+    // Cooked data is read again since meshes don't keep a CPU copy, each mesh is read once
+    build.Data = data;
+    build.Job = ::aderite::Engine::getJobSystem()->schedule(
+        [data, material]() {
+            io::Loader loader;
+            std::unordered_map<io::LoadableHandle, io::Loader::MeshLoadResult> meshes;
+            for (const Source& source : data->Sources) {
+                auto it = meshes.find(source.Mesh);
+                if (it == meshes.end()) {
+                    it = meshes.emplace(source.Mesh, loader.loadMesh(source.Mesh)).first;
+                }
+
+                if (!it->second.Error.empty()) {
+                    // Drawn as a regular renderable
+                    continue;
+                }
+
+                StaticBatcher::append(data->Batches, material, it->second.Mesh, source.World);
+                data->Merged.push_back(source.Entity);
+            }
+        },
+        threading::Job::Priority::LOW);
+
+    return true;
+}
+
+void StaticBatcher::upload(scene::ComponentRegistry& components, asset::MaterialAsset* material, Build& build) {
+    for (PendingBatch& pending : build.Batches) {
+        this->flush(pending);
+    }
+
+    size_t batched = 0;
+    for (const scene::Entity entity : build.Merged) {
+        Renderable* renderable = components.getRenderables().get(entity);
+        if (renderable != nullptr) {
+            renderable->setBatch(material);
+            batched++;
+        }
+    }
+
+    LOG_INFO("[Rendering] Merged {0} static renderables of {1}", batched, material->getName());
+}
+
+void StaticBatcher::add(asset::MaterialAsset* material, const io::MeshCooker::View& mesh, const glm::mat4& world) {
+    StaticBatcher::append(m_pending, material, mesh, world);
+}
+
+void StaticBatcher::append(std::vector<PendingBatch>& pending, asset::MaterialAsset* material, const io::MeshCooker::View& mesh,
+                           const glm::mat4& world) {
+    auto it = std::find_if(pending.rbegin(), pending.rend(), [material](const PendingBatch& batch) {
+        return batch.Material == material;
+    });
+
+    // Full batches are kept, the material continues in a new batch
+    if (it == pending.rend() ||
+        (!it->Vertices.empty() && it->Vertices.size() / 8 + mesh.VertexCount > c_MaxBatchVertices)) {
+        pending.emplace_back();
+        pending.back().Material = material;
+        it = pending.rbegin();
+    }
+
+    PendingBatch& batch = *it;
+    const uint32_t base = static_cast<uint32_t>(batch.Vertices.size() / 8);
+
+    // Vertices are moved to world space, normals with the inverse transpose so non uniform scale is handled
+    const glm::mat3 normalMatrix = glm::inverseTranspose(glm::mat3(world));
+    batch.Vertices.resize(batch.Vertices.size() + static_cast<size_t>(mesh.VertexCount) * 8);
+    float* output = batch.Vertices.data() + static_cast<size_t>(base) * 8;
+    for (uint32_t i = 0; i < mesh.VertexCount; i++) {
+        float vertex[8];
+        std::memcpy(vertex, mesh.Vertices + static_cast<size_t>(i) * io::MeshCooker::c_VertexStride, sizeof(vertex));
+
+        const glm::vec3 position = world * glm::vec4(vertex[0], vertex[1], vertex[2], 1.0f);
+        const glm::vec3 normal = normalMatrix * glm::vec3(vertex[3], vertex[4], vertex[5]);
+        const float length = glm::length(normal);
+        const glm::vec3 n = length > 0.0f ? normal / length : normal;
+
+        float* out = output + static_cast<size_t>(i) * 8;
+        out[0] = position.x;
+        out[1] = position.y;
+        out[2] = position.z;
+        out[3] = n.x;
+        out[4] = n.y;
+        out[5] = n.z;
+        out[6] = vertex[6];
+        out[7] = vertex[7];
+    }
+
+    const size_t firstIndex = batch.Indices.size();
+    batch.Indices.resize(firstIndex + mesh.IndexCount);
+    for (uint32_t i = 0; i < mesh.IndexCount; i++) {
+        uint32_t index;
+        if (mesh.Index32) {
+            std::memcpy(&index, mesh.Indices + i * sizeof(uint32_t), sizeof(uint32_t));
+        } else {
+            uint16_t index16;
+            std::memcpy(&index16, mesh.Indices + i * sizeof(uint16_t), sizeof(uint16_t));
+            index = index16;
+        }
+
+        batch.Indices[firstIndex + i] = base + index;
+    }
+
+    batch.Objects++;
+}
+
+void StaticBatcher::finish() {
+    for (PendingBatch& pending : m_pending) {
+        this->flush(pending);
+    }
+
+    m_pending.clear();
+}
+
+void StaticBatcher::clear() {
+    for (StaticBatch& batch : m_batches) {
+        this->retire(std::move(batch));
+    }
+
+    m_batches.clear();
+    m_pending.clear();
+    m_builds.clear();
+    m_built = false;
+}
+
+bool StaticBatcher::isBuilt() const {
+    return m_built;
+}
+
+void StaticBatcher::update(FrameData& fd) {
+    for (auto it = m_retired.begin(); it != m_retired.end();) {
+        if (--it->Frames == 0) {
+            it->Batch.Material->release();
+            it = m_retired.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const StaticBatch& batch : m_batches) {
+        // Vertices are already in world space, the batch never changes so its instance data stays persistent
+        DrawCall& dc = fd.DrawCalls[batch.Key];
+        dc.Mesh = batch.Mesh.get();
+        dc.Material = batch.Material;
+        dc.Transformations.push_back(glm::mat4(1.0f));
+        dc.Signature = batch.Signature;
+    }
+}
+
+const std::vector<StaticBatch>& StaticBatcher::getBatches() const {
+    return m_batches;
+}
+
+void StaticBatcher::retire(StaticBatch&& batch) {
+    // The frame being written and the one the renderer reads may both have a draw call of the batch, its mesh and
+    // material reference are kept until every frame of the ring has been written again
+    RetiredBatch& retired = m_retired.emplace_back();
+    retired.Batch = std::move(batch);
+    retired.Frames = FrameDataRing::c_FrameCount;
+}
+
+void StaticBatcher::flush(PendingBatch& pending) {
+    if (pending.Indices.empty()) {
+        return;
+    }
+
+    // Keyed by the material and the index of the batch within it, so batches don't collide with each other or with the
+    // draw calls of individual renderables
+    const size_t index = static_cast<size_t>(std::count_if(m_batches.begin(), m_batches.end(), [&pending](const StaticBatch& batch) {
+        return batch.Material == pending.Material;
+    }));
+
+    StaticBatch& batch = m_batches.emplace_back();
+    batch.Key = utility::combineHash(utility::combineHash(c_BatchSeed, pending.Material->getHandle()), index);
+    batch.Signature = utility::combineHash(batch.Key, m_buildCount++);
+    batch.Material = pending.Material;
+    batch.Material->acquire();
+    batch.Mesh = std::make_unique<asset::MeshAsset>();
+    batch.Mesh->create(pending.Vertices, pending.Indices);
+    batch.Objects = pending.Objects;
+
+    pending.Vertices.clear();
+    pending.Indices.clear();
+    pending.Objects = 0;
+}
+
+} // namespace rendering
+} // namespace aderite
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "aderite/Handles.hpp"
+#include "aderite/asset/Forward.hpp"
+#include "aderite/io/MeshCooker.hpp"
+#include "aderite/rendering/Forward.hpp"
+#include "aderite/scene/Forward.hpp"
+#include "aderite/threading/Forward.hpp"
+
+namespace aderite {
+namespace rendering {
+
+/**
+ * @brief Geometry of static renderables sharing a material, merged into a single mesh with world space vertices
+ */
+struct StaticBatch {
+    // Draw call key of the batch, unique for every batch of the material
+    size_t Key = 0;
+
+    // Changes every time the batch is built, keys the persistent instances of the batch
+    size_t Signature = 0;
+
+    asset::MaterialAsset* Material = nullptr;
+    std::unique_ptr<asset::MeshAsset> Mesh;
+
+    // Number of merged renderables
+    size_t Objects = 0;
+};
+
+/**
+ * @brief Merges the meshes of static renderables that share a material into pre-transformed combined vertex and index
+ * buffers, so that static scenery is drawn with a handful of draw calls that never go through per object transform code.
+ * Every batch is submitted with an identity transformation and culled with the bounds of its merged geometry.
+ *
+ * Batches are built per material, invalidating a material destroys its batches and they are built again by a job while
+ * its renderables are drawn individually. Destroyed batches stay alive until no frame data the renderer can still read
+ * references them.
+ */
+class StaticBatcher final {
+public:
+    /**
+     * @brief Batches are split once they reach this many vertices so a single batch doesn't cover the whole scene
+     */
+    static constexpr uint32_t c_MaxBatchVertices = 1 << 18;
+
+public:
+    StaticBatcher() = default;
+    StaticBatcher(const StaticBatcher& o) = delete;
+    ~StaticBatcher();
+
+    /**
+     * @brief Builds the batches of every material that was invalidated, all of them on the first call. Cooked geometry
+     * is read and merged by a job once every static renderable of the material is resident, a later call uploads the
+     * batches and marks the merged renderables as batched.
+     * @param components Registry of the scene
+     */
+    void build(scene::ComponentRegistry& components);
+
+    /**
+     * @brief Retires the batches of the material and unbatches their renderables, they are built again by the next
+     * build. A build of the material that is still running is discarded.
+     * @param components Registry of the scene
+     * @param material Material of the batches
+     */
+    void invalidate(scene::ComponentRegistry& components, asset::MaterialAsset* material);
+
+    /**
+     * @brief Adds a mesh to the batch of the material
+     * @param material Material of the mesh
+     * @param mesh Cooked mesh data
+     * @param world World matrix of the mesh
+     */
+    void add(asset::MaterialAsset* material, const io::MeshCooker::View& mesh, const glm::mat4& world);
+
+    /**
+     * @brief Uploads the batches that still have pending geometry
+     */
+    void finish();
+
+    /**
+     * @brief Retires all batches and drops pending builds, renderables have to be unbatched by the caller
+     */
+    void clear();
+
+    /**
+     * @brief Returns true if the batcher was started by a build
+     */
+    bool isBuilt() const;
+
+    /**
+     * @brief Adds a draw call for every batch into the frame data and destroys retired batches that no frame references
+     * anymore, called once per frame
+     * @param fd Frame data to write into
+     */
+    void update(FrameData& fd);
+
+    /**
+     * @brief Returns the built batches
+     */
+    const std::vector<StaticBatch>& getBatches() const;
+
+private:
+    /**
+     * @brief Geometry that is being merged into a batch
+     */
+    struct PendingBatch {
+        asset::MaterialAsset* Material = nullptr;
+        std::vector<float> Vertices;
+        std::vector<uint32_t> Indices;
+        size_t Objects = 0;
+    };
+
+    /**
+     * @brief Static renderable read by a build job
+     */
+    struct Source {
+        scene::Entity Entity;
+        io::LoadableHandle Mesh;
+        glm::mat4 World;
+    };
+
+    /**
+     * @brief Build of a single material, shared with its job so a discarded build can finish on its own
+     */
+    struct Build {
+        std::vector<Source> Sources;
+        std::vector<PendingBatch> Batches;
+
+        // Renderables that were merged, the rest failed to load and are drawn individually
+        std::vector<scene::Entity> Merged;
+    };
+
+    /**
+     * @brief Material that is waiting to be built
+     */
+    struct PendingBuild {
+        std::shared_ptr<Build> Data;
+        threading::JobHandle Job;
+    };
+
+    /**
+     * @brief Batch that was invalidated, frames that were written before still draw it
+     */
+    struct RetiredBatch {
+        StaticBatch Batch;
+
+        // Updates left until the last frame referencing the batch has been rendered
+        uint32_t Frames = 0;
+    };
+
+    /**
+     * @brief Moves the batch into the retired list
+     */
+    void retire(StaticBatch&& batch);
+
+    /**
+     * @brief Schedules the build job of the material
+     * @return False if a static renderable of the material is still loading
+     */
+    bool schedule(scene::ComponentRegistry& components, asset::MaterialAsset* material, PendingBuild& build);
+
+    /**
+     * @brief Uploads the batches of a finished build and marks its renderables as batched
+     */
+    void upload(scene::ComponentRegistry& components, asset::MaterialAsset* material, Build& build);
+
+    /**
+     * @brief Merges a mesh into the last pending batch of the material, a new one is started if it's full
+     */
+    static void append(std::vector<PendingBatch>& pending, asset::MaterialAsset* material, const io::MeshCooker::View& mesh,
+                       const glm::mat4& world);
+
+    /**
+     * @brief Uploads the pending batch
+     */
+    void flush(PendingBatch& pending);
+
+private:
+    bool m_built = false;
+    size_t m_buildCount = 0;
+    std::vector<StaticBatch> m_batches;
+    std::vector<RetiredBatch> m_retired;
+    std::vector<PendingBatch> m_pending;
+    std::unordered_map<asset::MaterialAsset*, PendingBuild> m_builds;
+};
+
+} // namespace rendering
+} // namespace aderite
@@ -55,7 +55,9 @@ rendering::CameraData Camera::computeRenderingData() const {
     cd.Name = m_gObject->getName();
     cd.Output = m_output;
     cd.ProjectionMatrix = glm::perspective(glm::radians(m_settings.getFoV()), 1.0f, 0.1f, 1000.0f);
-    cd.ViewMatrix = glm::inverse(glm::translate(glm::mat4(1.0f), transform->getPosition()) * glm::toMat4(transform->getRotation()));
+    cd.ViewMatrix =
+        glm::inverse(glm::translate(glm::mat4(1.0f), transform->getWorldPosition()) * glm::toMat4(transform->getWorldRotation()));
+    cd.DepthPrepass = m_settings.hasDepthPrepass();
 
     return cd;
 }
@@ -67,7 +69,7 @@ glm::vec3 Camera::getForwardDirection() const {
         return glm::vec3(0.0f, 0.0f, 0.0f);
     }
 
-    return glm::rotate(transform->getRotation(), glm::vec3(0.0f, 0.0f, -1.0f));
+    return glm::rotate(transform->getWorldRotation(), glm::vec3(0.0f, 0.0f, -1.0f));
 }
 
 } // namespace scene
@@ -29,9 +29,18 @@ void CameraSettings::setFarClip(float distance) {
     m_farClip = distance;
 }
 
+bool CameraSettings::hasDepthPrepass() const {
+    return m_depthPrepass;
+}
+
+void CameraSettings::setDepthPrepass(bool value) {
+    m_depthPrepass = value;
+}
+
 bool CameraSettings::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
     emitter << YAML::Key << "Camera" << YAML::BeginMap;
     emitter << YAML::Key << "FoV" << YAML::Value << m_fov;
+    emitter << YAML::Key << "DepthPrepass" << YAML::Value << m_depthPrepass;
     emitter << YAML::EndMap;
     return true;
 }
@@ -43,6 +52,9 @@ bool CameraSettings::deserialize(io::Serializer* serializer, const YAML::Node& d
     }
 
     m_fov = camera["FoV"].as<float>();
+    if (camera["DepthPrepass"]) {
+        m_depthPrepass = camera["DepthPrepass"].as<bool>();
+    }
     return true;
 }
 
@@ -50,6 +62,7 @@ CameraSettings& CameraSettings::operator=(const CameraSettings& other) {
     m_fov = other.m_fov;
     m_nearClip = other.m_nearClip;
     m_farClip = other.m_farClip;
+    m_depthPrepass = other.m_depthPrepass;
     return *this;
 }
 
@@ -45,6 +45,17 @@ public:
      */
     void setFarClip(float distance);
 
+    /**
+     * @brief Returns true if opaque geometry is drawn into a depth prepass before being shaded
+     */
+    bool hasDepthPrepass() const;
+
+    /**
+     * @brief Enables or disables the depth prepass of the camera
+     * @param value True to render a depth prepass
+     */
+    void setDepthPrepass(bool value);
+
     // Inherited via ISerializable
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
     bool deserialize(io::Serializer* serializer, const YAML::Node& data) override;
@@ -55,6 +66,7 @@ private:
     float m_fov = 90.0f;
     float m_nearClip = 0.1f;
     float m_farClip = 1000.0f;
+    bool m_depthPrepass = true;
 };
 
 } // namespace scene
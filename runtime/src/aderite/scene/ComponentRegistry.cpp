@@ -0,0 +1,86 @@
+#include "ComponentRegistry.hpp"
+
+#include "aderite/audio/AudioListener.hpp"
+#include "aderite/audio/AudioSource.hpp"
+#include "aderite/physics/PhysXActor.hpp"
+#include "aderite/rendering/Renderable.hpp"
+#include "aderite/scene/Camera.hpp"
+#include "aderite/scene/TransformProvider.hpp"
+
+namespace aderite {
+namespace scene {
+
+ComponentRegistry::ComponentRegistry() {}
+
+ComponentRegistry::~ComponentRegistry() {}
+
+Entity ComponentRegistry::createEntity() {
+    if (!m_freeEntities.empty()) {
+        const Entity entity = m_freeEntities.back();
+        m_freeEntities.pop_back();
+        return entity;
+    }
+
+    return m_nextEntity++;
+}
+
+void ComponentRegistry::destroyEntity(Entity entity) {
+    ADERITE_DYNAMIC_ASSERT(entity < m_nextEntity, "Tried to destroy an entity that doesn't belong to this registry");
+
+    if (m_transforms.has(entity)) {
+        m_transforms.remove(entity);
+    }
+
+    if (m_renderables.has(entity)) {
+        m_renderables.remove(entity);
+    }
+
+    if (m_actors.has(entity)) {
+        m_actors.remove(entity);
+    }
+
+    if (m_cameras.has(entity)) {
+        m_cameras.remove(entity);
+    }
+
+    if (m_audioSources.has(entity)) {
+        m_audioSources.remove(entity);
+    }
+
+    if (m_audioListeners.has(entity)) {
+        m_audioListeners.remove(entity);
+    }
+
+    m_freeEntities.push_back(entity);
+}
+
+size_t ComponentRegistry::getEntityCount() const {
+    return m_nextEntity - m_freeEntities.size();
+}
+
+ComponentStorage<TransformProvider>& ComponentRegistry::getTransforms() {
+    return m_transforms;
+}
+
+ComponentStorage<rendering::Renderable>& ComponentRegistry::getRenderables() {
+    return m_renderables;
+}
+
+ComponentStorage<physics::PhysXActor>& ComponentRegistry::getActors() {
+    return m_actors;
+}
+
+ComponentStorage<Camera>& ComponentRegistry::getCameras() {
+    return m_cameras;
+}
+
+ComponentStorage<audio::AudioSource>& ComponentRegistry::getAudioSources() {
+    return m_audioSources;
+}
+
+ComponentStorage<audio::AudioListener>& ComponentRegistry::getAudioListeners() {
+    return m_audioListeners;
+}
+
+} // namespace scene
+} // namespace aderite
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "aderite/audio/Forward.hpp"
+#include "aderite/physics/Forward.hpp"
+#include "aderite/rendering/Forward.hpp"
+#include "aderite/scene/ComponentStorage.hpp"
+#include "aderite/scene/Forward.hpp"
+
+namespace aderite {
+namespace scene {
+
+/**
+ * @brief Owns the entity ids and component storages of a scene, systems iterate the storages directly while game
+ * objects access their own components through them
+ */
+class ComponentRegistry final {
+public:
+    ComponentRegistry();
+    ComponentRegistry(const ComponentRegistry& o) = delete;
+    ~ComponentRegistry();
+
+    /**
+     * @brief Creates a new entity, ids of destroyed entities are reused
+     */
+    Entity createEntity();
+
+    /**
+     * @brief Destroys all components of the entity and frees its id
+     * @param entity Entity to destroy
+     */
+    void destroyEntity(Entity entity);
+
+    /**
+     * @brief Returns the number of alive entities
+     */
+    size_t getEntityCount() const;
+
+    /**
+     * @brief Returns the transform storage
+     */
+    ComponentStorage<TransformProvider>& getTransforms();
+
+    /**
+     * @brief Returns the renderable storage
+     */
+    ComponentStorage<rendering::Renderable>& getRenderables();
+
+    /**
+     * @brief Returns the actor storage
+     */
+    ComponentStorage<physics::PhysXActor>& getActors();
+
+    /**
+     * @brief Returns the camera storage
+     */
+    ComponentStorage<Camera>& getCameras();
+
+    /**
+     * @brief Returns the audio source storage
+     */
+    ComponentStorage<audio::AudioSource>& getAudioSources();
+
+    /**
+     * @brief Returns the audio listener storage
+     */
+    ComponentStorage<audio::AudioListener>& getAudioListeners();
+
+private:
+    Entity m_nextEntity = 0;
+    std::vector<Entity> m_freeEntities;
+
+    // Components
+    ComponentStorage<TransformProvider> m_transforms;
+    ComponentStorage<rendering::Renderable> m_renderables;
+    ComponentStorage<physics::PhysXActor> m_actors;
+    ComponentStorage<Camera> m_cameras;
+    ComponentStorage<audio::AudioSource> m_audioSources;
+    ComponentStorage<audio::AudioListener> m_audioListeners;
+};
+
+} // namespace scene
+} // namespace aderite
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aderite/scene/Forward.hpp"
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+
+namespace aderite {
+namespace scene {
+
+/**
+ * @brief Sparse set storage for a single component type. Components are stored densely in fixed size pages so that
+ * systems can iterate them without chasing pointers, the sparse array maps entity ids to dense slots.
+ *
+ * Components are constructed in place and never moved, a removed component leaves a hole that is reused by the next
+ * insertion. This keeps the pointers returned by GameObject getters and handed to scripts valid for the lifetime of
+ * the component.
+ * @tparam T Component type
+ */
+template<typename T>
+class ComponentStorage final {
+public:
+    static constexpr size_t c_PageSize = 256;
+    static constexpr uint32_t c_InvalidSlot = UINT32_MAX;
+
+public:
+    ComponentStorage() = default;
+    ComponentStorage(const ComponentStorage& o) = delete;
+
+    ~ComponentStorage() {
+        this->clear();
+    }
+
+    /**
+     * @brief Constructs a component for the entity
+     * @param entity Entity that doesn't have this component yet
+     * @param args Component constructor arguments
+     * @return Component instance
+     */
+    template<typename... Args>
+    T* emplace(Entity entity, Args&&... args) {
+        ADERITE_DYNAMIC_ASSERT(!this->has(entity), "Tried to add a component to an entity that already has one");
+
+        uint32_t slot = c_InvalidSlot;
+        if (!m_free.empty()) {
+            slot = m_free.back();
+            m_free.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_dense.size());
+            m_dense.push_back(c_InvalidEntity);
+            if (slot / c_PageSize >= m_pages.size()) {
+                m_pages.emplace_back(new Page());
+            }
+        }
+
+        T* component = new (this->at(slot)) T(std::forward<Args>(args)...);
+
+        if (entity >= m_sparse.size()) {
+            m_sparse.resize(static_cast<size_t>(entity) + 1, c_InvalidSlot);
+        }
+
+        m_sparse[entity] = slot;
+        m_dense[slot] = entity;
+        m_count++;
+        return component;
+    }
+
+    /**
+     * @brief Destroys the component of the entity
+     * @param entity Entity that has this component
+     */
+    void remove(Entity entity) {
+        ADERITE_DYNAMIC_ASSERT(this->has(entity), "Tried to remove a component from an entity that doesn't have one");
+
+        const uint32_t slot = m_sparse[entity];
+        this->at(slot)->~T();
+        m_sparse[entity] = c_InvalidSlot;
+        m_dense[slot] = c_InvalidEntity;
+        m_count--;
+
+        if (slot + 1 == m_dense.size()) {
+            // Trailing holes are dropped instead of reused so iteration stays short
+            m_dense.pop_back();
+            while (!m_dense.empty() && m_dense.back() == c_InvalidEntity) {
+                m_dense.pop_back();
+            }
+
+            m_free.erase(std::remove_if(m_free.begin(), m_free.end(),
+                                        [this](uint32_t hole) {
+                                            return hole >= m_dense.size();
+                                        }),
+                         m_free.end());
+        } else {
+            m_free.push_back(slot);
+        }
+    }
+
+    /**
+     * @brief Returns the component of the entity or nullptr if the entity doesn't have one
+     */
+    T* get(Entity entity) const {
+        if (!this->has(entity)) {
+            return nullptr;
+        }
+
+        return this->at(m_sparse[entity]);
+    }
+
+    /**
+     * @brief Returns true if the entity has this component
+     */
+    bool has(Entity entity) const {
+        return entity < m_sparse.size() && m_sparse[entity] != c_InvalidSlot;
+    }
+
+    /**
+     * @brief Returns the number of components in the storage
+     */
+    size_t size() const {
+        return m_count;
+    }
+
+    /**
+     * @brief Invokes fn(entity, component) for every component in dense order
+     * @param fn Function to invoke
+     */
+    template<typename Fn>
+    void each(Fn&& fn) {
+        for (size_t i = 0; i < m_dense.size(); i++) {
+            const Entity entity = m_dense[i];
+            if (entity != c_InvalidEntity) {
+                fn(entity, *this->at(static_cast<uint32_t>(i)));
+            }
+        }
+    }
+
+    /**
+     * @brief Destroys all components
+     */
+    void clear() {
+        for (size_t i = 0; i < m_dense.size(); i++) {
+            if (m_dense[i] != c_InvalidEntity) {
+                this->at(static_cast<uint32_t>(i))->~T();
+            }
+        }
+
+        m_sparse.clear();
+        m_dense.clear();
+        m_free.clear();
+        m_count = 0;
+    }
+
+private:
+    /**
+     * @brief Fixed size block of uninitialized components, pages are never reallocated
+     */
+    struct Page {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type Data[c_PageSize];
+    };
+
+    T* at(uint32_t slot) const {
+        return reinterpret_cast<T*>(&m_pages[slot / c_PageSize]->Data[slot % c_PageSize]);
+    }
+
+private:
+    std::vector<uint32_t> m_sparse;
+    std::vector<Entity> m_dense;
+    std::vector<uint32_t> m_free;
+    std::vector<std::unique_ptr<Page>> m_pages;
+    size_t m_count = 0;
+};
+
+} // namespace scene
+} // namespace aderite
@@ -4,15 +4,27 @@
  * @brief This file is used to define forward declarations for all Scene types
  */
 
+#include <cstdint>
+
 namespace aderite {
 namespace scene {
 
+/**
+ * @brief Id of a game object inside of its component registry
+ */
+using Entity = uint32_t;
+constexpr Entity c_InvalidEntity = UINT32_MAX;
+
 class SceneManager;
 class Scene;
 class TransformProvider;
 class GameObject;
 class Camera;
 class CameraSettings;
+class ComponentRegistry;
+
+template<typename T>
+class ComponentStorage;
 
 } // namespace scene
 } // namespace aderite
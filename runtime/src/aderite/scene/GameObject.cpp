@@ -6,10 +6,11 @@
 #include "aderite/physics/PhysXActor.hpp"
 #include "aderite/physics/PhysicsEventList.hpp"
 #include "aderite/physics/geometry/Geometry.hpp"
-#include "aderite/rendering/FrameData.hpp"
 #include "aderite/rendering/Renderable.hpp"
-#include "aderite/rendering/Renderer.hpp"
 #include "aderite/scene/Camera.hpp"
+#include "aderite/scene/ComponentRegistry.hpp"
+#include "aderite/scene/Scene.hpp"
+#include "aderite/scene/TransformProvider.hpp"
 #include "aderite/scripting/BehaviorBase.hpp"
 #include "aderite/scripting/ScriptManager.hpp"
 #include "aderite/scripting/ScriptedBehavior.hpp"
@@ -21,6 +22,15 @@ namespace scene {
 GameObject::GameObject(scene::Scene* scene, const std::string& name) : m_scene(scene) {
     this->setName(name);
     m_instance = ::aderite::Engine::getScriptManager()->createInstance(this);
+
+    if (scene != nullptr) {
+        m_registry = &scene->getComponents();
+    } else {
+        m_detachedRegistry = std::make_unique<ComponentRegistry>();
+        m_registry = m_detachedRegistry.get();
+    }
+
+    m_entity = m_registry->createEntity();
 }
 
 GameObject::~GameObject() {
@@ -28,67 +38,13 @@ GameObject::~GameObject() {
         delete behavior;
     }
 
-    if (m_transform != nullptr) {
-        delete m_transform;
-    }
-
-    if (m_renderable != nullptr) {
-        delete m_renderable;
-    }
-
-    if (m_actor != nullptr) {
-        delete m_actor;
-    }
-
-    if (m_camera != nullptr) {
-        delete m_camera;
-    }
-
-    if (m_audioSource != nullptr) {
-        delete m_audioSource;
-    }
-
-    if (m_audioListener != nullptr) {
-        delete m_audioListener;
-    }
+    m_registry->destroyEntity(m_entity);
 }
 
 void GameObject::update(float delta) {
-    rendering::FrameData& fd = ::aderite::Engine::getRenderer()->getWriteFrameData();
-
-    if (m_renderable != nullptr) {
-        m_renderable->update(delta);
-    }
-
-    const Engine::CurrentState engineState = ::aderite::Engine::get()->getState();
-
-    if (engineState == Engine::CurrentState::RENDER_ONLY || engineState == Engine::CurrentState::SYSTEM_UPDATE) {
-        return;
-    }
-
     for (scripting::ScriptedBehavior* behavior : m_behaviors) {
         behavior->update(delta);
     }
-
-    if (m_camera != nullptr) {
-        m_camera->update(delta);
-    }
-
-    if (m_actor != nullptr) {
-        m_actor->update(delta);
-    }
-
-    if (m_audioSource != nullptr) {
-        m_audioSource->update(delta);
-    }
-
-    if (m_audioListener != nullptr) {
-        m_audioListener->update(delta);
-    }
-
-    if (m_transform != nullptr) {
-        m_transform->resetModifiedFlag();
-    }
 }
 
 void GameObject::onTriggerEnter(const physics::TriggerEvent& te) {
@@ -143,132 +99,142 @@ MonoObject* GameObject::getScriptInstance() const {
     return m_instance;
 }
 
+Entity GameObject::getEntity() const {
+    return m_entity;
+}
+
 TransformProvider* GameObject::addTransform() {
-    ADERITE_DYNAMIC_ASSERT(m_transform == nullptr, "Tried to add a transform to an object that already has one");
-    m_transform = new TransformProvider();
-    return m_transform;
+    ADERITE_DYNAMIC_ASSERT(!m_registry->getTransforms().has(m_entity), "Tried to add a transform to an object that already has one");
+    return m_registry->getTransforms().emplace(m_entity);
 }
 
 void GameObject::removeTransform() {
-    ADERITE_DYNAMIC_ASSERT(m_transform != nullptr, "Tried to remove transform from object that doesn't have one");
-    delete m_transform;
-    m_transform = nullptr;
+    ADERITE_DYNAMIC_ASSERT(m_registry->getTransforms().has(m_entity), "Tried to remove transform from object that doesn't have one");
+    m_registry->getTransforms().remove(m_entity);
 }
 
 TransformProvider* GameObject::getTransform() const {
-    return m_transform;
+    return m_registry->getTransforms().get(m_entity);
 }
 
 rendering::Renderable* GameObject::addRenderable() {
-    ADERITE_DYNAMIC_ASSERT(m_renderable == nullptr, "Tried to add a renderable to an object that already has one");
-    if (m_transform == nullptr) {
+    ADERITE_DYNAMIC_ASSERT(!m_registry->getRenderables().has(m_entity), "Tried to add a renderable to an object that already has one");
+    if (this->getTransform() == nullptr) {
         this->addTransform();
     }
-    m_renderable = new rendering::Renderable(this);
-    return m_renderable;
+    return m_registry->getRenderables().emplace(m_entity, this);
 }
 
 void GameObject::removeRenderable() {
-    ADERITE_DYNAMIC_ASSERT(m_renderable != nullptr, "Tried to remove renderable from object that doesn't have one");
-    delete m_renderable;
-    m_renderable = nullptr;
+    ADERITE_DYNAMIC_ASSERT(m_registry->getRenderables().has(m_entity), "Tried to remove renderable from object that doesn't have one");
+    if (m_scene != nullptr) {
+        m_scene->invalidateStaticBatch(this->getRenderable());
+    }
+
+    m_registry->getRenderables().remove(m_entity);
 }
 
 rendering::Renderable* GameObject::getRenderable() const {
-    return m_renderable;
+    return m_registry->getRenderables().get(m_entity);
 }
 
 physics::PhysXActor* GameObject::addActor() {
-    ADERITE_DYNAMIC_ASSERT(m_actor == nullptr, "Tried to add a actor to an object that already has one");
-    if (m_transform == nullptr) {
+    ADERITE_DYNAMIC_ASSERT(!m_registry->getActors().has(m_entity), "Tried to add a actor to an object that already has one");
+    if (this->getTransform() == nullptr) {
         this->addTransform();
     }
-    m_actor = new physics::PhysXActor(this);
-    return m_actor;
+    return m_registry->getActors().emplace(m_entity, this);
 }
 
 void GameObject::removeActor() {
-    ADERITE_DYNAMIC_ASSERT(m_actor != nullptr, "Tried to remove actor from object that doesn't have one");
-    delete m_actor;
-    m_actor = nullptr;
+    ADERITE_DYNAMIC_ASSERT(m_registry->getActors().has(m_entity), "Tried to remove actor from object that doesn't have one");
+    m_registry->getActors().remove(m_entity);
 }
 
 physics::PhysXActor* GameObject::getActor() const {
-    return m_actor;
+    return m_registry->getActors().get(m_entity);
 }
 
 Camera* GameObject::addCamera() {
-    ADERITE_DYNAMIC_ASSERT(m_camera == nullptr, "Tried to add a camera to an object that already has one");
-    if (m_transform == nullptr) {
+    ADERITE_DYNAMIC_ASSERT(!m_registry->getCameras().has(m_entity), "Tried to add a camera to an object that already has one");
+    if (this->getTransform() == nullptr) {
         this->addTransform();
     }
 
-    m_camera = new Camera(this);
-    return m_camera;
+    return m_registry->getCameras().emplace(m_entity, this);
 }
 
 void GameObject::removeCamera() {
-    ADERITE_DYNAMIC_ASSERT(m_camera != nullptr, "Tried to remove camera from object that doesn't have one");
-    delete m_camera;
-    m_camera = nullptr;
+    ADERITE_DYNAMIC_ASSERT(m_registry->getCameras().has(m_entity), "Tried to remove camera from object that doesn't have one");
+    m_registry->getCameras().remove(m_entity);
 }
 
 Camera* GameObject::getCamera() const {
-    return m_camera;
+    return m_registry->getCameras().get(m_entity);
 }
 
 audio::AudioSource* GameObject::addAudioSource() {
-    ADERITE_DYNAMIC_ASSERT(m_audioSource == nullptr, "Tried to add a audio source to an object that already has one");
-    if (m_transform == nullptr) {
+    ADERITE_DYNAMIC_ASSERT(!m_registry->getAudioSources().has(m_entity),
+                           "Tried to add a audio source to an object that already has one");
+    if (this->getTransform() == nullptr) {
         this->addTransform();
     }
 
-    m_audioSource = new audio::AudioSource(this);
-    return m_audioSource;
+    return m_registry->getAudioSources().emplace(m_entity, this);
 }
 
 void GameObject::removeAudioSource() {
-    ADERITE_DYNAMIC_ASSERT(m_audioSource != nullptr, "Tried to remove audio source from object that doesn't have one");
-    delete m_audioSource;
-    m_audioSource = nullptr;
+    ADERITE_DYNAMIC_ASSERT(m_registry->getAudioSources().has(m_entity),
+                           "Tried to remove audio source from object that doesn't have one");
+    m_registry->getAudioSources().remove(m_entity);
 }
 
 audio::AudioSource* GameObject::getAudioSource() const {
-    return m_audioSource;
+    return m_registry->getAudioSources().get(m_entity);
 }
 
 audio::AudioListener* GameObject::addAudioListener() {
-    ADERITE_DYNAMIC_ASSERT(m_audioListener == nullptr, "Tried to add a audio listener to an object that already has one");
-    if (m_transform == nullptr) {
+    ADERITE_DYNAMIC_ASSERT(!m_registry->getAudioListeners().has(m_entity),
+                           "Tried to add a audio listener to an object that already has one");
+    if (this->getTransform() == nullptr) {
         this->addTransform();
     }
 
-    m_audioListener = new audio::AudioListener(this);
-    return m_audioListener;
+    return m_registry->getAudioListeners().emplace(m_entity, this);
 }
 
 void GameObject::removeAudioListener() {
-    ADERITE_DYNAMIC_ASSERT(m_audioListener != nullptr, "Tried to remove audio listener from object that doesn't have one");
-    delete m_audioListener;
-    m_audioListener = nullptr;
+    ADERITE_DYNAMIC_ASSERT(m_registry->getAudioListeners().has(m_entity),
+                           "Tried to remove audio listener from object that doesn't have one");
+    m_registry->getAudioListeners().remove(m_entity);
 }
 
 audio::AudioListener* GameObject::getAudioListener() const {
-    return m_audioListener;
+    return m_registry->getAudioListeners().get(m_entity);
 }
 
 void GameObject::addBehavior(scripting::ScriptedBehavior* behavior) {
     m_behaviors.push_back(behavior);
+    m_behaviorsChanged = true;
 }
 
 void GameObject::removeBehavior(scripting::ScriptedBehavior* behavior) {
     m_behaviors.erase(std::find(m_behaviors.begin(), m_behaviors.end(), behavior));
+    m_behaviorsChanged = true;
 }
 
 std::vector<scripting::ScriptedBehavior*> GameObject::getBehaviors() const {
     return m_behaviors;
 }
 
+bool GameObject::haveBehaviorsChanged() const {
+    return m_behaviorsChanged;
+}
+
+void GameObject::resetBehaviorsChangedFlag() {
+    m_behaviorsChanged = false;
+}
+
 bool GameObject::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
     emitter << YAML::Key << "GameObject" << YAML::BeginMap;
     emitter << YAML::Key << "Name" << YAML::Value << this->getName();
@@ -279,32 +245,32 @@ bool GameObject::serialize(const io::Serializer* serializer, YAML::Emitter& emit
         }
     }
 
-    if (m_renderable != nullptr) {
-        if (!m_renderable->getData().serialize(serializer, emitter)) {
+    if (this->getRenderable() != nullptr) {
+        if (!this->getRenderable()->getData().serialize(serializer, emitter)) {
             return false;
         }
     }
 
-    if (m_actor != nullptr) {
-        if (!m_actor->getData().serialize(serializer, emitter)) {
+    if (this->getActor() != nullptr) {
+        if (!this->getActor()->getData().serialize(serializer, emitter)) {
             return false;
         }
     }
 
-    if (m_camera != nullptr) {
-        if (!m_camera->getData().serialize(serializer, emitter)) {
+    if (this->getCamera() != nullptr) {
+        if (!this->getCamera()->getData().serialize(serializer, emitter)) {
             return false;
         }
     }
 
-    if (m_audioSource != nullptr) {
-        if (!m_audioSource->getData().serialize(serializer, emitter)) {
+    if (this->getAudioSource() != nullptr) {
+        if (!this->getAudioSource()->getData().serialize(serializer, emitter)) {
             return false;
         }
     }
 
-    if (m_audioListener != nullptr) {
-        if (!m_audioListener->getData().serialize(serializer, emitter)) {
+    if (this->getAudioListener() != nullptr) {
+        if (!this->getAudioListener()->getData().serialize(serializer, emitter)) {
             return false;
         }
     }
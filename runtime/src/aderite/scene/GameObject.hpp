@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,7 +17,8 @@ namespace aderite {
 namespace scene {
 
 /**
- * @brief The main class used to represent an object in a scene
+ * @brief The main class used to represent an object in a scene. Components are not owned by the object itself, they
+ * are stored in the component registry of the scene and looked up by the entity id of the object.
  */
 class GameObject final : public io::SerializableObject {
 public:
@@ -33,7 +35,7 @@ public:
     ~GameObject();
 
     /**
-     * @brief Update scene
+     * @brief Update the behaviors of the object, components are updated by the scene
      * @param delta Delta time between frames
      */
     void update(float delta);
@@ -94,6 +96,11 @@ public:
      */
     MonoObject* getScriptInstance() const;
 
+    /**
+     * @brief Returns the entity id of the object
+     */
+    Entity getEntity() const;
+
     /**
      * @brief Attach transform component to this GameObject
      */
@@ -201,6 +208,16 @@ public:
      */
     std::vector<scripting::ScriptedBehavior*> getBehaviors() const;
 
+    /**
+     * @brief Returns true if a behavior was added or removed since the flag was last reset
+     */
+    bool haveBehaviorsChanged() const;
+
+    /**
+     * @brief Resets the behaviors change flag
+     */
+    void resetBehaviorsChangedFlag();
+
     // Inherited via SerializableObject
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
     bool deserialize(io::Serializer* serializer, const YAML::Node& data) override;
@@ -212,13 +229,13 @@ private:
     bool m_markedForDeletion = false;
 
     // Components
-    TransformProvider* m_transform = nullptr;
-    rendering::Renderable* m_renderable = nullptr;
-    physics::PhysXActor* m_actor = nullptr;
-    Camera* m_camera = nullptr;
-    audio::AudioSource* m_audioSource = nullptr;
-    audio::AudioListener* m_audioListener = nullptr;
+    ComponentRegistry* m_registry = nullptr;
+    Entity m_entity = c_InvalidEntity;
     std::vector<scripting::ScriptedBehavior*> m_behaviors;
+    bool m_behaviorsChanged = true;
+
+    // Objects created without a scene keep their components here
+    std::unique_ptr<ComponentRegistry> m_detachedRegistry;
 
     // Scripting instance
     MonoObject* m_instance = nullptr;
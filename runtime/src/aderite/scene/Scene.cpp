@@ -1,12 +1,21 @@
 #include "Scene.hpp"
 
+#include <unordered_map>
+
 #include "aderite/Aderite.hpp"
+#include "aderite/asset/MaterialAsset.hpp"
+#include "aderite/asset/MeshAsset.hpp"
 #include "aderite/asset/PrefabAsset.hpp"
 #include "aderite/audio/AudioListener.hpp"
 #include "aderite/audio/AudioSource.hpp"
 #include "aderite/io/Serializer.hpp"
+#include "aderite/physics/PhysXActor.hpp"
+#include "aderite/physics/PhysicsController.hpp"
+#include "aderite/rendering/Renderable.hpp"
+#include "aderite/rendering/Renderer.hpp"
 #include "aderite/scene/Camera.hpp"
 #include "aderite/scene/GameObject.hpp"
+#include "aderite/scene/TransformProvider.hpp"
 #include "aderite/scripting/ScriptManager.hpp"
 #include "aderite/utility/Log.hpp"
 #include "aderite/utility/Random.hpp"
@@ -52,17 +61,88 @@ Scene::~Scene() {
 }
 
 void Scene::update(float delta) {
-    // Free marked objects
+    // Free marked objects, static batches they are part of are built again without them
+    for (const std::unique_ptr<GameObject>& object : m_gameObjects) {
+        if (object->isMarkedForDeletion() && object->getRenderable() != nullptr) {
+            this->invalidateStaticBatch(object->getRenderable());
+        }
+    }
+
     m_gameObjects.erase(std::remove_if(m_gameObjects.begin(), m_gameObjects.end(),
                                        [](const std::unique_ptr<GameObject>& gObject) {
                                            return gObject->isMarkedForDeletion();
                                        }),
                         m_gameObjects.end());
 
-    // Update all game objects
-    for (size_t i = 0; i < m_gameObjects.size(); i++) {
-        m_gameObjects[i]->update(delta);
+    const Engine::CurrentState engineState = ::aderite::Engine::get()->getState();
+    const bool paused = engineState == Engine::CurrentState::RENDER_ONLY || engineState == Engine::CurrentState::SYSTEM_UPDATE;
+    if (!paused) {
+        // Behaviors
+        for (size_t i = 0; i < m_gameObjects.size(); i++) {
+            m_gameObjects[i]->update(delta);
+        }
+
+        // The physics step started at the beginning of the tick ran alongside the behaviors, actors need its results.
+        // Interpolated poses are written into the transforms before world matrices are computed so that renderables
+        // submit them this frame.
+        ::aderite::Engine::getPhysicsController()->fetchResults();
+        m_components.getActors().each([delta](Entity entity, physics::PhysXActor& actor) {
+            actor.update(delta);
+        });
     }
+
+    // World matrices in a single pass over the packed transforms, clean transforms are skipped
+    m_components.getTransforms().each([](Entity entity, TransformProvider& transform) {
+        transform.updateWorldMatrix();
+    });
+
+    // Static geometry is merged per material once it is resident, only while the game is running so that static objects
+    // can still be moved while editing
+    if (paused) {
+        if (m_staticBatcher.isBuilt()) {
+            this->rebuildStaticBatches();
+        }
+    } else {
+        // Batches of renderables that changed or moved are built again
+        m_components.getRenderables().each([this](Entity entity, rendering::Renderable& renderable) {
+            const TransformProvider* transform = m_components.getTransforms().get(entity);
+            const bool moved = renderable.isBatched() && transform != nullptr && transform->wasWorldModified();
+            if (renderable.getData().hasChanged() || moved) {
+                this->invalidateStaticBatch(&renderable);
+                renderable.getData().resetChangedFlag();
+            }
+        });
+
+        m_staticBatcher.build(m_components);
+    }
+
+    // Batched renderables skip their update
+    m_staticBatcher.update(::aderite::Engine::getRenderer()->getWriteFrameData());
+
+    m_components.getRenderables().each([delta](Entity entity, rendering::Renderable& renderable) {
+        renderable.update(delta);
+    });
+
+    if (paused) {
+        return;
+    }
+
+    // Systems
+    m_components.getCameras().each([delta](Entity entity, Camera& camera) {
+        camera.update(delta);
+    });
+
+    m_components.getAudioSources().each([delta](Entity entity, audio::AudioSource& source) {
+        source.update(delta);
+    });
+
+    m_components.getAudioListeners().each([delta](Entity entity, audio::AudioListener& listener) {
+        listener.update(delta);
+    });
+
+    m_components.getTransforms().each([](Entity entity, TransformProvider& transform) {
+        transform.resetModifiedFlag();
+    });
 }
 
 GameObject* Scene::createGameObject() {
@@ -79,6 +159,10 @@ GameObject* Scene::createGameObject(asset::PrefabAsset* prefab) {
 }
 
 void Scene::destroyGameObject(GameObject* object) {
+    if (object->getRenderable() != nullptr) {
+        this->invalidateStaticBatch(object->getRenderable());
+    }
+
     removeObject(m_gameObjects, object);
 }
 
@@ -86,6 +170,50 @@ const std::vector<std::unique_ptr<GameObject>>& Scene::getGameObjects() const {
     return m_gameObjects;
 }
 
+ComponentRegistry& Scene::getComponents() {
+    return m_components;
+}
+
+const rendering::StaticBatcher& Scene::getStaticBatcher() const {
+    return m_staticBatcher;
+}
+
+void Scene::rebuildStaticBatches() {
+    m_components.getRenderables().each([](Entity entity, rendering::Renderable& renderable) {
+        renderable.setBatch(nullptr);
+    });
+
+    m_staticBatcher.clear();
+}
+
+void Scene::invalidateStaticBatch(rendering::Renderable* renderable) {
+    m_staticBatcher.invalidate(m_components, renderable->getBatch());
+    if (renderable->getData().isStatic()) {
+        m_staticBatcher.invalidate(m_components, renderable->getData().getMaterial());
+    }
+}
+
+void Scene::getDependencies(std::vector<io::SerializableHandle>& dependencies) const {
+    for (const std::unique_ptr<GameObject>& object : m_gameObjects) {
+        rendering::Renderable* renderable = object->getRenderable();
+        if (renderable == nullptr) {
+            continue;
+        }
+
+        if (renderable->getData().getMesh() != nullptr) {
+            dependencies.push_back(renderable->getData().getMesh()->getHandle());
+        }
+
+        if (renderable->getData().getMaterial() != nullptr) {
+            dependencies.push_back(renderable->getData().getMaterial()->getHandle());
+        }
+    }
+
+    // Objects commonly share assets
+    std::sort(dependencies.begin(), dependencies.end());
+    dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+}
+
 reflection::Type Scene::getType() const {
     return static_cast<reflection::Type>(reflection::RuntimeTypes::SCENE);
 }
@@ -96,10 +224,23 @@ bool Scene::serialize(const io::Serializer* serializer, YAML::Emitter& emitter)
     }
 
     // Objects
+    std::unordered_map<const TransformProvider*, const GameObject*> owners;
+    for (const auto& object : m_gameObjects) {
+        if (object->getTransform() != nullptr) {
+            owners[object->getTransform()] = object.get();
+        }
+    }
+
     emitter << YAML::Key << "GameObjects" << YAML::BeginSeq;
     for (const auto& object : m_gameObjects) {
         emitter << YAML::BeginMap;
         object->serialize(serializer, emitter);
+
+        // Hierarchy is stored by name since names are unique in a scene
+        const TransformProvider* transform = object->getTransform();
+        if (transform != nullptr && transform->getParent() != nullptr) {
+            emitter << YAML::Key << "Parent" << YAML::Value << owners[transform->getParent()]->getName();
+        }
         emitter << YAML::EndMap;
     }
     emitter << YAML::EndSeq;
@@ -113,9 +254,27 @@ bool Scene::deserialize(io::Serializer* serializer, const YAML::Node& data) {
     // Objects
     auto objects = data["GameObjects"];
     if (objects) {
+        std::unordered_map<std::string, GameObject*> byName;
+        std::vector<std::pair<GameObject*, std::string>> parents;
         for (auto object : objects) {
             scene::GameObject* gObject = this->createGameObject();
             gObject->deserialize(serializer, object);
+            byName[gObject->getName()] = gObject;
+
+            if (object["Parent"]) {
+                parents.emplace_back(gObject, object["Parent"].as<std::string>());
+            }
+        }
+
+        // Parents can come after their children
+        for (const auto& [child, parentName] : parents) {
+            auto it = byName.find(parentName);
+            if (it == byName.end() || it->second->getTransform() == nullptr || child->getTransform() == nullptr) {
+                LOG_WARN("[Scene] Parent {0} of {1} not found", parentName, child->getName());
+                continue;
+            }
+
+            child->getTransform()->setParent(it->second->getTransform());
         }
     }
 }
@@ -7,6 +7,8 @@
 #include "aderite/io/SerializableAsset.hpp"
 #include "aderite/physics/PhysicsScene.hpp"
 #include "aderite/rendering/Forward.hpp"
+#include "aderite/rendering/StaticBatcher.hpp"
+#include "aderite/scene/ComponentRegistry.hpp"
 #include "aderite/scene/Forward.hpp"
 #include "aderite/scripting/Forward.hpp"
 
@@ -25,7 +27,8 @@ public:
     virtual ~Scene();
 
     /**
-     * @brief Update scene
+     * @brief Update scene, behaviors are updated per object and then every component type is updated by iterating
+     * its storage
      * @param delta Delta time between frames
      */
     void update(float delta);
@@ -54,6 +57,31 @@ public:
      */
     const std::vector<std::unique_ptr<GameObject>>& getGameObjects() const;
 
+    /**
+     * @brief Returns the component registry of this scene
+     */
+    ComponentRegistry& getComponents();
+
+    /**
+     * @brief Returns the static batches of this scene
+     */
+    const rendering::StaticBatcher& getStaticBatcher() const;
+
+    /**
+     * @brief Destroys all static batches, they are built again by the next update while the scene runs
+     */
+    void rebuildStaticBatches();
+
+    /**
+     * @brief Destroys the static batches the renderable is or would be part of, they are built again without blocking
+     * while the scene runs. Called for renderables that changed, moved or are about to be removed.
+     * @param renderable Renderable that changed
+     */
+    void invalidateStaticBatch(rendering::Renderable* renderable);
+
+    // Inherited via SerializableAsset
+    void getDependencies(std::vector<io::SerializableHandle>& dependencies) const override;
+
     // Inherited via SerializableObject
     reflection::Type getType() const override;
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
@@ -64,7 +92,10 @@ private:
     friend class SceneSerializer;
 
 private:
+    // Declared before the objects so it outlives them
+    ComponentRegistry m_components;
     std::vector<std::unique_ptr<GameObject>> m_gameObjects;
+    rendering::StaticBatcher m_staticBatcher;
 };
 
 } // namespace scene
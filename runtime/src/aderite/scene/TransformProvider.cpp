@@ -1,16 +1,45 @@
 #include "TransformProvider.hpp"
 
+#include <algorithm>
+
+#include "aderite/utility/Macros.hpp"
 #include "aderite/utility/YAML.hpp"
 
 namespace aderite {
 namespace scene {
 
+/**
+ * @brief Builds translate * rotate * scale directly instead of multiplying three matrices
+ */
+static glm::mat4 composeMatrix(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+    const glm::mat3 r = glm::mat3_cast(rotation);
+    return glm::mat4(glm::vec4(r[0] * scale.x, 0.0f), glm::vec4(r[1] * scale.y, 0.0f), glm::vec4(r[2] * scale.z, 0.0f),
+                     glm::vec4(position, 1.0f));
+}
+
+TransformProvider::~TransformProvider() {
+    // Children keep their local values and become roots
+    for (TransformProvider* child : m_children) {
+        child->m_parent = nullptr;
+        child->markDirty();
+    }
+
+    if (m_parent != nullptr) {
+        m_parent->m_children.erase(std::find(m_parent->m_children.begin(), m_parent->m_children.end(), this));
+    }
+}
+
 bool TransformProvider::wasModified() const {
     return m_wasModified;
 }
 
+bool TransformProvider::wasWorldModified() const {
+    return m_worldModified;
+}
+
 void TransformProvider::resetModifiedFlag() {
     m_wasModified = false;
+    m_worldModified = false;
 }
 
 const glm::vec3& TransformProvider::getPosition() const {
@@ -28,16 +57,126 @@ const glm::vec3& TransformProvider::getScale() const {
 void TransformProvider::setPosition(const glm::vec3& position) {
     m_wasModified = true;
     m_position = position;
+    m_localDirty = true;
+    this->markDirty();
 }
 
 void TransformProvider::setRotation(const glm::quat& rotation) {
     m_wasModified = true;
     m_rotation = rotation;
+    m_localDirty = true;
+    this->markDirty();
 }
 
 void TransformProvider::setScale(const glm::vec3& scale) {
     m_wasModified = true;
     m_scale = scale;
+    m_localDirty = true;
+    this->markDirty();
+}
+
+glm::vec3 TransformProvider::getWorldPosition() const {
+    return glm::vec3(this->getWorldMatrix()[3]);
+}
+
+glm::quat TransformProvider::getWorldRotation() const {
+    if (m_parent == nullptr) {
+        return m_rotation;
+    }
+
+    return m_parent->getWorldRotation() * m_rotation;
+}
+
+glm::vec3 TransformProvider::getWorldScale() const {
+    const glm::mat4& world = this->getWorldMatrix();
+    return glm::vec3(glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2])));
+}
+
+void TransformProvider::setWorldPose(const glm::vec3& position, const glm::quat& rotation) {
+    if (m_parent == nullptr) {
+        this->setPosition(position);
+        this->setRotation(rotation);
+        return;
+    }
+
+    this->setPosition(glm::vec3(glm::inverse(m_parent->getWorldMatrix()) * glm::vec4(position, 1.0f)));
+    this->setRotation(glm::inverse(m_parent->getWorldRotation()) * rotation);
+}
+
+void TransformProvider::setParent(TransformProvider* parent) {
+    if (parent == m_parent) {
+        return;
+    }
+
+    for (TransformProvider* ancestor = parent; ancestor != nullptr; ancestor = ancestor->m_parent) {
+        ADERITE_DYNAMIC_ASSERT(ancestor != this, "Tried to parent a transform to one of its children");
+    }
+
+    if (m_parent != nullptr) {
+        m_parent->m_children.erase(std::find(m_parent->m_children.begin(), m_parent->m_children.end(), this));
+    }
+
+    m_parent = parent;
+    if (m_parent != nullptr) {
+        m_parent->m_children.push_back(this);
+    }
+
+    m_wasModified = true;
+    this->markDirty();
+}
+
+TransformProvider* TransformProvider::getParent() const {
+    return m_parent;
+}
+
+const std::vector<TransformProvider*>& TransformProvider::getChildren() const {
+    return m_children;
+}
+
+const glm::mat4& TransformProvider::getLocalMatrix() const {
+    if (m_localDirty) {
+        m_local = composeMatrix(m_position, m_rotation, m_scale);
+        m_localDirty = false;
+    }
+
+    return m_local;
+}
+
+const glm::mat4& TransformProvider::getWorldMatrix() const {
+    this->updateWorldMatrix();
+    return m_world;
+}
+
+bool TransformProvider::isDirty() const {
+    return m_worldDirty;
+}
+
+void TransformProvider::updateWorldMatrix() const {
+    if (!m_worldDirty) {
+        return;
+    }
+
+    if (m_parent != nullptr) {
+        // Parents are not guaranteed to come first in the storage, resolve them on demand
+        m_world = m_parent->getWorldMatrix() * this->getLocalMatrix();
+    } else {
+        m_world = this->getLocalMatrix();
+    }
+
+    m_worldDirty = false;
+    m_worldModified = true;
+}
+
+void TransformProvider::markDirty() {
+    if (m_worldDirty) {
+        // Children were already marked
+        return;
+    }
+
+    m_worldDirty = true;
+    for (TransformProvider* child : m_children) {
+        child->markDirty();
+    }
 }
 
 bool TransformProvider::serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const {
@@ -68,6 +207,8 @@ TransformProvider& TransformProvider::operator=(const TransformProvider& other)
     m_position = other.m_position;
     m_rotation = other.m_rotation;
     m_scale = other.m_scale;
+    m_localDirty = true;
+    this->markDirty();
     return *this;
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
@@ -10,11 +12,15 @@ namespace aderite {
 namespace scene {
 
 /**
- * @brief TransformProvider is an interface for objects that have transform information
+ * @brief TransformProvider is an interface for objects that have transform information. Position, rotation and scale
+ * are relative to the parent transform, local and world matrices are cached and only recomputed after a setter was
+ * called on the transform or one of its parents.
  */
 class TransformProvider final : public io::ISerializable {
 public:
-    virtual ~TransformProvider() = default;
+    TransformProvider() = default;
+    TransformProvider(const TransformProvider& o) = delete;
+    virtual ~TransformProvider();
 
     /**
      * @brief Returns true if the transform was modified, false otherwise
@@ -22,7 +28,13 @@ public:
     bool wasModified() const;
 
     /**
-     * @brief Resets the modified flag
+     * @brief Returns true if the world matrix changed since the modified flag was last reset, this includes changes
+     * caused by a parent
+     */
+    bool wasWorldModified() const;
+
+    /**
+     * @brief Resets the modified flags
      */
     void resetModifiedFlag();
 
@@ -59,17 +71,93 @@ public:
      */
     void setScale(const glm::vec3& scale);
 
+    /**
+     * @brief Returns the position in world space
+     */
+    glm::vec3 getWorldPosition() const;
+
+    /**
+     * @brief Returns the rotation in world space, the rotations of the parents applied to the local rotation
+     */
+    glm::quat getWorldRotation() const;
+
+    /**
+     * @brief Returns the scale in world space, the length of every world matrix axis
+     */
+    glm::vec3 getWorldScale() const;
+
+    /**
+     * @brief Sets the position and rotation from world space values, they are converted into the parent space
+     * @param position World space position
+     * @param rotation World space rotation
+     */
+    void setWorldPose(const glm::vec3& position, const glm::quat& rotation);
+
+    /**
+     * @brief Sets the parent of the transform, the local values are kept so the transform moves with the parent
+     * @param parent New parent or nullptr to detach
+     */
+    void setParent(TransformProvider* parent);
+
+    /**
+     * @brief Returns the parent transform or nullptr
+     */
+    TransformProvider* getParent() const;
+
+    /**
+     * @brief Returns the child transforms
+     */
+    const std::vector<TransformProvider*>& getChildren() const;
+
+    /**
+     * @brief Returns the transformation matrix relative to the parent
+     */
+    const glm::mat4& getLocalMatrix() const;
+
+    /**
+     * @brief Returns the world transformation matrix, recomputed only if the transform or its parents changed
+     */
+    const glm::mat4& getWorldMatrix() const;
+
+    /**
+     * @brief Returns true if the world matrix has to be recomputed
+     */
+    bool isDirty() const;
+
+    /**
+     * @brief Recomputes the cached matrices if needed, called by the scene for every transform once per frame so that
+     * the matrices are computed in one pass over the transform storage
+     */
+    void updateWorldMatrix() const;
+
     // Inherited via ISerializable
     bool serialize(const io::Serializer* serializer, YAML::Emitter& emitter) const override;
     bool deserialize(io::Serializer* serializer, const YAML::Node& data) override;
 
     TransformProvider& operator=(const TransformProvider& other);
 
+private:
+    /**
+     * @brief Marks the world matrix of this transform and its children as dirty, the children local matrices stay valid
+     */
+    void markDirty();
+
 private:
     bool m_wasModified = false;
     glm::vec3 m_position = {0.0f, 0.0f, 0.0f};
     glm::quat m_rotation = glm::quat({1.0f, 0.0f, 0.0f, 0.0f});
     glm::vec3 m_scale = {1.0f, 1.0f, 1.0f};
+
+    // Hierarchy
+    TransformProvider* m_parent = nullptr;
+    std::vector<TransformProvider*> m_children;
+
+    // Cache
+    mutable glm::mat4 m_local = glm::mat4(1.0f);
+    mutable glm::mat4 m_world = glm::mat4(1.0f);
+    mutable bool m_localDirty = false;
+    mutable bool m_worldDirty = false;
+    mutable bool m_worldModified = false;
 };
 
 } // namespace scene
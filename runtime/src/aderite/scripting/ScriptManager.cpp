@@ -63,7 +63,7 @@ void ScriptManager::loadAssemblies() {
     m_assembliesValid = false;
     io::DataChunk assemblyChunk = ::aderite::Engine::getFileHandler()->openReservedLoadable(io::FileHandler::Reserved::GameCode);
 
-    if (assemblyChunk.Data.size() == 0) {
+    if (assemblyChunk.size() == 0) {
         // Empty nothing to load
         LOG_WARN("[Scripting] No game code found");
         return;
@@ -243,8 +243,9 @@ bool ScriptManager::setupEngineAssemblies() {
     // Create image
     LOG_TRACE("[Scripting] Loading engine image");
     MonoImageOpenStatus status;
-    m_scriptlibImage = mono_image_open_from_data_with_name(reinterpret_cast<char*>(assemblyChunk.Data.data()), assemblyChunk.Data.size(), 1,
-                                                           &status, 0, "ScriptLibImage");
+    // Mono copies the image (need_copy = 1) so the chunk memory is never written to
+    char* imageData = reinterpret_cast<char*>(const_cast<unsigned char*>(assemblyChunk.data()));
+    m_scriptlibImage = mono_image_open_from_data_with_name(imageData, assemblyChunk.size(), 1, &status, 0, "ScriptLibImage");
 
     if (status != MONO_IMAGE_OK || m_scriptlibImage == nullptr) {
         LOG_WARN("[Scripting] Image could not be created");
@@ -281,8 +282,9 @@ bool ScriptManager::setupCodeAssemblies() {
     // Create image
     LOG_TRACE("[Scripting] Loading code image");
     MonoImageOpenStatus status;
-    m_codeImage = mono_image_open_from_data_with_name(reinterpret_cast<char*>(assemblyChunk.Data.data()), assemblyChunk.Data.size(), 1,
-                                                      &status, 0, "CodeImage");
+    // Mono copies the image (need_copy = 1) so the chunk memory is never written to
+    char* imageData = reinterpret_cast<char*>(const_cast<unsigned char*>(assemblyChunk.data()));
+    m_codeImage = mono_image_open_from_data_with_name(imageData, assemblyChunk.size(), 1, &status, 0, "CodeImage");
 
     if (status != MONO_IMAGE_OK || m_codeImage == nullptr) {
         LOG_WARN("[Scripting] Image could not be created");
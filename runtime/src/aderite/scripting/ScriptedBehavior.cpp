@@ -97,6 +97,15 @@ void ScriptedBehavior::onCollisionLeave(const physics::CollisionEvent& ce) {
     }
 }
 
+bool ScriptedBehavior::listensToCollisions() const {
+    return m_behaviorBase->m_collisionStart || m_behaviorBase->m_collisionEnd;
+}
+
+bool ScriptedBehavior::listensToTriggers() const {
+    return m_behaviorBase->m_triggerEnter || m_behaviorBase->m_triggerLeave || m_behaviorBase->m_triggerWasEntered ||
+           m_behaviorBase->m_triggerWasLeft;
+}
+
 BehaviorBase* ScriptedBehavior::getBase() const {
     return m_behaviorBase;
 }
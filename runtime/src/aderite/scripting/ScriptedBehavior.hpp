@@ -69,6 +69,16 @@ public:
      */
     void onCollisionLeave(const physics::CollisionEvent& ce);
 
+    /**
+     * @brief Returns true if the behavior handles collision events
+     */
+    bool listensToCollisions() const;
+
+    /**
+     * @brief Returns true if the behavior handles trigger events
+     */
+    bool listensToTriggers() const;
+
     /**
      * @brief Returns the behavior base
      */
@@ -6,11 +6,15 @@
 #error "Multiple PhysicsInternal.hpp include"
 #endif
 
+#include <vector>
+
 #include <mono/jit/jit.h>
+#include <mono/metadata/object.h>
 
 #include "aderite/Aderite.hpp"
 #include "aderite/scene/Scene.hpp"
 #include "aderite/scene/SceneManager.hpp"
+#include "aderite/scripting/ScriptManager.hpp"
 #include "aderite/utility/Log.hpp"
 
 namespace internal_ {
@@ -34,9 +38,98 @@ MonoObject* RaycastSingle(glm::vec3 from, glm::vec3 direction, float distance) {
     return nullptr;
 }
 
+/**
+ * @brief Casts the rays of a script batch, returns nullptr if there is no scene or the arrays don't match
+ */
+const aderite::physics::QueryResults* castRays(const char* method, MonoArray* from, MonoArray* directions, MonoArray* distances,
+                                               MonoArray* layerMasks) {
+    aderite::scene::Scene* scene = ::aderite::Engine::getSceneManager()->getCurrentScene();
+    if (scene == nullptr) {
+        LOG_ERROR("[Scripting] Tried to call Aderite.Physics::{0} when no active scene exists", method);
+        return nullptr;
+    }
+
+    const size_t count = mono_array_length(from);
+    if (mono_array_length(directions) != count || mono_array_length(distances) != count ||
+        (layerMasks != nullptr && mono_array_length(layerMasks) != count)) {
+        LOG_ERROR("[Scripting] Aderite.Physics::{0} called with arrays of different lengths", method);
+        return nullptr;
+    }
+
+    // Reused between calls, internal calls only come from the main thread
+    static std::vector<aderite::physics::RaycastQuery> queries;
+    static aderite::physics::QueryResults results;
+    queries.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        queries[i].From = mono_array_get(from, glm::vec3, i);
+        queries[i].Direction = mono_array_get(directions, glm::vec3, i);
+        queries[i].MaxDistance = mono_array_get(distances, float, i);
+        queries[i].LayerMask = layerMasks != nullptr ? mono_array_get(layerMasks, uint32_t, i) : 0;
+    }
+
+    scene->raycastBatch(queries, results);
+    return &results;
+}
+
+MonoArray* RaycastBatch(MonoArray* from, MonoArray* directions, MonoArray* distances, MonoArray* layerMasks) {
+    const aderite::physics::QueryResults* results = castRays("__RaycastBatch", from, directions, distances, layerMasks);
+    if (results == nullptr) {
+        return nullptr;
+    }
+
+    // Closest hit of every ray, null if the ray missed
+    const size_t count = results->Ranges.size();
+    const aderite::scripting::LibClassLocator& locator = ::aderite::Engine::getScriptManager()->getLocator();
+    MonoArray* hits = mono_array_new(::aderite::Engine::getScriptManager()->getDomain(), locator.RaycastResult.Klass, count);
+    for (size_t i = 0; i < count; i++) {
+        const aderite::physics::QueryResults::Range& range = results->Ranges[i];
+        if (range.Count > 0 && results->Hits[range.First].Actor != nullptr) {
+            mono_array_setref(hits, i, locator.create(results->Hits[range.First]));
+        }
+    }
+
+    return hits;
+}
+
+MonoArray* RaycastBatchAll(MonoArray* from, MonoArray* directions, MonoArray* distances, MonoArray* layerMasks) {
+    const aderite::physics::QueryResults* results = castRays("__RaycastBatchAll", from, directions, distances, layerMasks);
+    if (results == nullptr) {
+        return nullptr;
+    }
+
+    // Every hit of every ray sorted by distance, empty if the ray missed
+    const size_t count = results->Ranges.size();
+    MonoDomain* domain = ::aderite::Engine::getScriptManager()->getDomain();
+    const aderite::scripting::LibClassLocator& locator = ::aderite::Engine::getScriptManager()->getLocator();
+    MonoArray* all = mono_array_new(domain, mono_array_class_get(locator.RaycastResult.Klass, 1), count);
+    for (size_t i = 0; i < count; i++) {
+        const aderite::physics::QueryResults::Range& range = results->Ranges[i];
+        size_t found = 0;
+        for (size_t j = range.First; j < range.First + range.Count; j++) {
+            found += results->Hits[j].Actor != nullptr ? 1 : 0;
+        }
+
+        MonoArray* hits = mono_array_new(domain, locator.RaycastResult.Klass, found);
+        size_t hit = 0;
+        for (size_t j = range.First; j < range.First + range.Count; j++) {
+            if (results->Hits[j].Actor != nullptr) {
+                mono_array_setref(hits, hit++, locator.create(results->Hits[j]));
+            }
+        }
+
+        mono_array_setref(all, i, hits);
+    }
+
+    return all;
+}
+
 void linkPhysics() {
     mono_add_internal_call("Aderite.Physics::__RaycastSingle(Aderite.Vector3,Aderite.Vector3,single)",
                            reinterpret_cast<void*>(RaycastSingle));
+    mono_add_internal_call("Aderite.Physics::__RaycastBatch(Aderite.Vector3[],Aderite.Vector3[],single[],uint[])",
+                           reinterpret_cast<void*>(RaycastBatch));
+    mono_add_internal_call("Aderite.Physics::__RaycastBatchAll(Aderite.Vector3[],Aderite.Vector3[],single[],uint[])",
+                           reinterpret_cast<void*>(RaycastBatchAll));
 }
 } // namespace physics
 
@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * @brief This file is used to define forward declarations for all threading types
+ */
+
+#include <memory>
+
+namespace aderite {
+namespace threading {
+
+class Job;
+class JobSystem;
+
+template<typename T>
+class WorkStealingQueue;
+
+using JobHandle = std::shared_ptr<Job>;
+
+} // namespace threading
+} // namespace aderite
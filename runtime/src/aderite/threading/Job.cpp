@@ -0,0 +1,21 @@
+#include "Job.hpp"
+
+namespace aderite {
+namespace threading {
+
+Job::Job(Function function, Priority priority) : m_function(std::move(function)), m_priority(priority) {}
+
+Job::Priority Job::getPriority() const {
+    return m_priority;
+}
+
+bool Job::isSubmitted() const {
+    return m_submitted.load(std::memory_order_acquire);
+}
+
+bool Job::isFinished() const {
+    return m_finished.load(std::memory_order_acquire);
+}
+
+} // namespace threading
+} // namespace aderite
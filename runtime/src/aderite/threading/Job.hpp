@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "aderite/threading/Forward.hpp"
+
+namespace aderite {
+namespace threading {
+
+/**
+ * @brief A single unit of work that is executed by the JobSystem
+ */
+class Job final {
+public:
+    /**
+     * @brief Priority of the job, jobs with higher priority are always picked up first. CRITICAL is reserved for work
+     * that the current frame is waiting on
+     */
+    enum class Priority {
+        LOW = 0,
+        NORMAL = 1,
+        HIGH = 2,
+        CRITICAL = 3,
+    };
+
+    /**
+     * @brief Number of priorities
+     */
+    static constexpr size_t c_PriorityCount = 4;
+
+    using Function = std::function<void()>;
+
+public:
+    Job(Function function, Priority priority);
+    Job(const Job& o) = delete;
+
+    /**
+     * @brief Returns the priority of the job
+     */
+    Priority getPriority() const;
+
+    /**
+     * @brief Returns true if the job was submitted to the JobSystem
+     */
+    bool isSubmitted() const;
+
+    /**
+     * @brief Returns true if the job has finished executing
+     */
+    bool isFinished() const;
+
+private:
+    friend class JobSystem;
+
+private:
+    Function m_function;
+    Priority m_priority = Priority::NORMAL;
+
+    // Number of jobs that need to finish before this one can start, +1 until the job is submitted
+    std::atomic<size_t> m_pendingDependencies {1};
+    std::atomic<bool> m_submitted {false};
+    std::atomic<bool> m_finished {false};
+
+    // Jobs that depend on this one
+    std::mutex m_continuationLock;
+    std::vector<JobHandle> m_continuations;
+
+    // Keeps the job alive while it is queued inside the JobSystem
+    JobHandle m_self;
+};
+
+} // namespace threading
+} // namespace aderite
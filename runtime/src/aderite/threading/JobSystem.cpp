@@ -0,0 +1,270 @@
+#include "JobSystem.hpp"
+
+#include <chrono>
+
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/LogExtensions.hpp"
+#include "aderite/utility/Macros.hpp"
+
+namespace aderite {
+namespace threading {
+
+// Number of empty findJob attempts before a worker goes to sleep
+static constexpr size_t c_SpinCount = 64;
+
+// Worker identity of the calling thread
+static thread_local size_t t_workerIndex = JobSystem::c_NotAWorker;
+static thread_local const JobSystem* t_workerSystem = nullptr;
+
+JobSystem::JobSystem() :
+    JobSystem(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1) {}
+
+JobSystem::JobSystem(size_t workerCount) : m_ownerThread(std::this_thread::get_id()) {
+    ADERITE_LOG_BLOCK;
+    ADERITE_DYNAMIC_ASSERT(workerCount > 0, "JobSystem with 0 workers is prohibited");
+    LOG_DEBUG("[Threading] Job system is created with {0} workers", workerCount);
+
+    // One queue set for each worker and one for the creating thread
+    for (size_t i = 0; i < workerCount + 1; i++) {
+        m_queues.push_back(std::make_unique<QueueSet>());
+    }
+
+    for (size_t i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+
+    LOG_INFO("[Threading] Job system created and initialized");
+}
+
+JobSystem::~JobSystem() {
+    ADERITE_LOG_BLOCK;
+    LOG_TRACE("[Threading] Job system is shutting down");
+
+    {
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_terminated = true;
+    }
+    m_cvWork.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+
+    // Release jobs that were never started, nothing is running at this point so the owner queues can be drained
+    size_t dropped = 0;
+    for (std::unique_ptr<QueueSet>& set : m_queues) {
+        for (WorkStealingQueue<Job>& queue : set->Queues) {
+            while (Job* job = queue.steal()) {
+                job->m_self.reset();
+                dropped++;
+            }
+        }
+    }
+
+    for (std::deque<Job*>& queue : m_injected) {
+        for (Job* job : queue) {
+            job->m_self.reset();
+            dropped++;
+        }
+        queue.clear();
+    }
+
+    if (dropped > 0) {
+        LOG_WARN("[Threading] {0} jobs were dropped during shutdown", dropped);
+    }
+
+    LOG_INFO("[Threading] Job system shutdown");
+}
+
+JobHandle JobSystem::create(Job::Function function, Job::Priority priority) const {
+    return std::make_shared<Job>(std::move(function), priority);
+}
+
+void JobSystem::addDependency(const JobHandle& job, const JobHandle& dependency) const {
+    ADERITE_DYNAMIC_ASSERT(job != nullptr && dependency != nullptr, "Nullptr job passed to addDependency");
+    ADERITE_DYNAMIC_ASSERT(!job->isSubmitted(), "Dependencies can only be added before the job is submitted");
+
+    std::unique_lock<std::mutex> lock(dependency->m_continuationLock);
+    if (dependency->isFinished()) {
+        // Nothing to wait for
+        return;
+    }
+
+    job->m_pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+    dependency->m_continuations.push_back(job);
+}
+
+void JobSystem::submit(const JobHandle& job) {
+    ADERITE_DYNAMIC_ASSERT(job != nullptr, "Nullptr job submitted");
+    ADERITE_DYNAMIC_ASSERT(!job->isSubmitted(), "Job submitted twice");
+
+    job->m_self = job;
+    job->m_submitted.store(true, std::memory_order_release);
+
+    // Release the submit token, if there are no outstanding dependencies the job can be queued right away
+    if (job->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        this->enqueue(job.get());
+    }
+}
+
+JobHandle JobSystem::schedule(Job::Function function, Job::Priority priority) {
+    JobHandle job = this->create(std::move(function), priority);
+    this->submit(job);
+    return job;
+}
+
+void JobSystem::wait(const JobHandle& job, Job::Priority minPriority) {
+    ADERITE_DYNAMIC_ASSERT(job->isSubmitted(), "Waiting on a job that was never submitted");
+
+    QueueSet* owned = this->ownedQueues();
+    const size_t start = t_workerSystem == this ? t_workerIndex + 1 : 0;
+    while (!job->isFinished()) {
+        // Help out instead of blocking
+        Job* other = this->findJob(owned, start, minPriority);
+        if (other != nullptr) {
+            this->execute(other);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t JobSystem::getWorkerCount() const {
+    return m_workers.size();
+}
+
+size_t JobSystem::getCurrentWorkerIndex() {
+    return t_workerIndex;
+}
+
+void JobSystem::workerLoop(size_t index) {
+    t_workerIndex = index;
+    t_workerSystem = this;
+
+    QueueSet* owned = m_queues[index].get();
+    size_t idle = 0;
+    while (!m_terminated.load(std::memory_order_acquire)) {
+        Job* job = this->findJob(owned, index + 1);
+        if (job != nullptr) {
+            this->execute(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < c_SpinCount) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing to do, sleep until notified, the timeout guards against a missed notification
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_sleeping.fetch_add(1, std::memory_order_acq_rel);
+        m_cvWork.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return m_terminated.load(std::memory_order_acquire) || m_queuedCount.load(std::memory_order_acquire) > 0;
+        });
+        m_sleeping.fetch_sub(1, std::memory_order_acq_rel);
+        idle = 0;
+    }
+
+    t_workerSystem = nullptr;
+    t_workerIndex = c_NotAWorker;
+}
+
+void JobSystem::enqueue(Job* job) {
+    const size_t lane = static_cast<size_t>(job->getPriority());
+    m_queuedCount.fetch_add(1, std::memory_order_acq_rel);
+
+    QueueSet* owned = this->ownedQueues();
+    if (owned == nullptr || !owned->Queues[lane].push(job)) {
+        // Foreign thread or full queue
+        std::unique_lock<std::mutex> lock(m_injectionLock);
+        m_injected[lane].push_back(job);
+        m_injectedCount.fetch_add(1, std::memory_order_release);
+    }
+
+    if (m_sleeping.load(std::memory_order_acquire) > 0) {
+        m_cvWork.notify_one();
+    }
+}
+
+Job* JobSystem::findJob(QueueSet* owned, size_t start, Job::Priority minPriority) {
+    if (m_queuedCount.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    const size_t setCount = m_queues.size();
+
+    // Highest priority lane first across all sources, so a HIGH job is never starved by local NORMAL work
+    for (int lane = static_cast<int>(Job::c_PriorityCount) - 1; lane >= static_cast<int>(minPriority); lane--) {
+        Job* job = nullptr;
+
+        // Own queue
+        if (owned != nullptr) {
+            job = owned->Queues[lane].pop();
+        }
+
+        // Injection queue
+        if (job == nullptr && m_injectedCount.load(std::memory_order_acquire) > 0) {
+            std::unique_lock<std::mutex> lock(m_injectionLock);
+            if (!m_injected[lane].empty()) {
+                job = m_injected[lane].front();
+                m_injected[lane].pop_front();
+                m_injectedCount.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        // Steal
+        for (size_t i = 0; job == nullptr && i < setCount; i++) {
+            QueueSet* victim = m_queues[(start + i) % setCount].get();
+            if (victim != owned && !victim->Queues[lane].empty()) {
+                job = victim->Queues[lane].steal();
+            }
+        }
+
+        if (job != nullptr) {
+            m_queuedCount.fetch_sub(1, std::memory_order_acq_rel);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job) {
+    if (job->m_function) {
+        job->m_function();
+    }
+
+    // Mark as finished and take the continuations, after this point no new continuations can be added
+    std::vector<JobHandle> continuations;
+    {
+        std::unique_lock<std::mutex> lock(job->m_continuationLock);
+        job->m_finished.store(true, std::memory_order_release);
+        continuations.swap(job->m_continuations);
+    }
+
+    for (const JobHandle& continuation : continuations) {
+        if (continuation->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->enqueue(continuation.get());
+        }
+    }
+
+    // Might be the last reference
+    JobHandle self = std::move(job->m_self);
+}
+
+JobSystem::QueueSet* JobSystem::ownedQueues() {
+    if (t_workerSystem == this) {
+        return m_queues[t_workerIndex].get();
+    }
+
+    if (std::this_thread::get_id() == m_ownerThread) {
+        return m_queues.back().get();
+    }
+
+    return nullptr;
+}
+
+} // namespace threading
+} // namespace aderite
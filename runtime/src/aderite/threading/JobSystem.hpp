@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "aderite/threading/Forward.hpp"
+#include "aderite/threading/Job.hpp"
+#include "aderite/threading/WorkStealingQueue.hpp"
+
+namespace aderite {
+namespace threading {
+
+/**
+ * @brief Engine wide job system. Every worker owns a lock-free deque per priority and steals from other
+ * workers when it runs out of work. The thread that created the system also owns a set of deques so it can
+ * submit without locking, any other thread submits through a shared injection queue.
+ */
+class JobSystem final {
+public:
+    /**
+     * @brief Value returned by getCurrentWorkerIndex when called from a thread that is not a worker
+     */
+    static constexpr size_t c_NotAWorker = 0xffffffffffffffff;
+
+    /**
+     * @brief Capacity of a single worker queue, overflow goes to the injection queue
+     */
+    static constexpr size_t c_QueueCapacity = 4096;
+
+public:
+    /**
+     * Creates a JobSystem with a worker for every hardware thread except the calling one
+     */
+    JobSystem();
+
+    /**
+     * Creates a JobSystem with specified worker count
+     * @param workerCount The amount of worker threads
+     */
+    JobSystem(size_t workerCount);
+
+    /**
+     * Stops all workers, jobs that were not started are dropped
+     */
+    ~JobSystem();
+
+    /**
+     * @brief Creates a job without submitting it, use this when the job has dependencies
+     * @param function Function to execute
+     * @param priority Priority of the job
+     * @return Job handle
+     */
+    JobHandle create(Job::Function function, Job::Priority priority = Job::Priority::NORMAL) const;
+
+    /**
+     * @brief Makes job wait for dependency to finish before starting, must be called before the job is submitted
+     * @param job Job that depends on dependency
+     * @param dependency Job that needs to finish first
+     */
+    void addDependency(const JobHandle& job, const JobHandle& dependency) const;
+
+    /**
+     * @brief Submits the job for execution, the job starts as soon as all of its dependencies are finished
+     * @param job Job to submit
+     */
+    void submit(const JobHandle& job);
+
+    /**
+     * @brief Utility method for creating and submitting a job without dependencies
+     * @param function Function to execute
+     * @param priority Priority of the job
+     * @return Job handle
+     */
+    JobHandle schedule(Job::Function function, Job::Priority priority = Job::Priority::NORMAL);
+
+    /**
+     * @brief Blocks until the job is finished, the calling thread executes other jobs while waiting
+     * @param job Job to wait for
+     * @param minPriority Only jobs with at least this priority are executed while waiting, frame critical code waits
+     * with CRITICAL so that it doesn't pick up long running loads
+     */
+    void wait(const JobHandle& job, Job::Priority minPriority = Job::Priority::LOW);
+
+    /**
+     * @brief Returns the number of worker threads
+     */
+    size_t getWorkerCount() const;
+
+    /**
+     * @brief Returns the index of the worker that is executing the calling thread, c_NotAWorker if the
+     * calling thread is not a worker of any JobSystem
+     */
+    static size_t getCurrentWorkerIndex();
+
+private:
+    /**
+     * @brief Lock-free queues owned by a single thread
+     */
+    struct QueueSet {
+        QueueSet() : Queues {c_QueueCapacity, c_QueueCapacity, c_QueueCapacity, c_QueueCapacity} {}
+        WorkStealingQueue<Job> Queues[Job::c_PriorityCount];
+    };
+
+    /**
+     * @brief Worker thread loop
+     * @param index Index of the worker
+     */
+    void workerLoop(size_t index);
+
+    /**
+     * @brief Pushes a job whose dependencies are resolved into a queue
+     * @param job Job to push
+     */
+    void enqueue(Job* job);
+
+    /**
+     * @brief Returns the next job that the calling thread should execute
+     * @param owned Queue set owned by the calling thread, nullptr if none
+     * @param start Index to start stealing from
+     * @param minPriority Lowest priority of the returned job
+     * @return Job instance or nullptr if there is no work
+     */
+    Job* findJob(QueueSet* owned, size_t start, Job::Priority minPriority = Job::Priority::LOW);
+
+    /**
+     * @brief Executes the job and releases its continuations
+     * @param job Job to execute
+     */
+    void execute(Job* job);
+
+    /**
+     * @brief Returns the queue set owned by the calling thread, nullptr if the calling thread doesn't own one
+     */
+    QueueSet* ownedQueues();
+
+private:
+    std::vector<std::thread> m_workers;
+
+    // One set per worker, the last one is owned by the creating thread
+    std::vector<std::unique_ptr<QueueSet>> m_queues;
+    std::thread::id m_ownerThread;
+
+    // Injection queue for threads that don't own a queue set and for overflow
+    std::mutex m_injectionLock;
+    std::deque<Job*> m_injected[Job::c_PriorityCount];
+    std::atomic<size_t> m_injectedCount {0};
+
+    // Sleeping
+    std::mutex m_sleepLock;
+    std::condition_variable m_cvWork;
+    std::atomic<size_t> m_queuedCount {0};
+    std::atomic<size_t> m_sleeping {0};
+    std::atomic<bool> m_terminated {false};
+};
+
+} // namespace threading
+} // namespace aderite
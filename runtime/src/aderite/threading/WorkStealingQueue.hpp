@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "aderite/threading/Forward.hpp"
+#include "aderite/utility/Log.hpp"
+#include "aderite/utility/Macros.hpp"
+
+namespace aderite {
+namespace threading {
+
+/**
+ * @brief Fixed capacity lock-free Chase-Lev deque. The owning thread pushes and pops from the bottom,
+ * any other thread can steal from the top.
+ * @tparam T Type of the stored items, the queue only stores pointers to T
+ */
+template<typename T>
+class WorkStealingQueue final {
+public:
+    /**
+     * @brief Creates a queue with the specified capacity
+     * @param capacity Maximum amount of items in the queue, must be a power of two
+     */
+    WorkStealingQueue(size_t capacity) : m_mask(capacity - 1), m_buffer(new std::atomic<T*>[capacity]) {
+        ADERITE_DYNAMIC_ASSERT(capacity > 0 && (capacity & m_mask) == 0, "WorkStealingQueue capacity must be a power of two");
+    }
+
+    WorkStealingQueue(const WorkStealingQueue& o) = delete;
+
+    /**
+     * @brief Pushes an item to the bottom of the queue, can only be called by the owning thread
+     * @param item Item to push
+     * @return True if pushed, false if the queue is full
+     */
+    bool push(T* item) {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+
+        if (bottom - top > static_cast<int64_t>(m_mask)) {
+            // Full
+            return false;
+        }
+
+        m_buffer[bottom & m_mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Pops an item from the bottom of the queue, can only be called by the owning thread
+     * @return Item or nullptr if the queue is empty
+     */
+    T* pop() {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // Empty, restore
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last item, race against thieves
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    /**
+     * @brief Steals an item from the top of the queue, can be called from any thread
+     * @return Item or nullptr if the queue is empty or the steal was lost to another thread
+     */
+    T* steal() {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        T* item = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+
+        return item;
+    }
+
+    /**
+     * @brief Returns true if the queue appears empty, the value might be stale by the time it is used
+     */
+    bool empty() const {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+private:
+    const int64_t m_mask;
+    std::unique_ptr<std::atomic<T*>[]> m_buffer;
+    std::atomic<int64_t> m_top {0};
+    std::atomic<int64_t> m_bottom {0};
+};
+
+} // namespace threading
+} // namespace aderite
@@ -26,6 +26,15 @@
 #error "Unsupported platform"
 #endif
 
+// ---------------------------------
+// SIMD
+// ---------------------------------
+
+#if defined(_M_X64) || defined(__SSE2__)
+// SSE2 is part of x64, used by hot loops that have a scalar fallback
+#define ADERITE_SIMD_SSE
+#endif
+
 // ---------------------------------
 // HELPERS
 // ---------------------------------
@@ -42,7 +51,12 @@
 #else
 #define ADERITE_DEBUG_SECTION(code)
 #define ADERITE_STATIC_ASSERT(check, message)
-#define ADERITE_DYNAMIC_ASSERT(check, message) LOG_ERROR("Failed check {0}, in {1} at line {2}, {3}", #check, __FILE__, __LINE__, message)
+#define ADERITE_DYNAMIC_ASSERT(check, message)                                                            \
+    do {                                                                                                  \
+        if (!(check)) {                                                                                   \
+            LOG_ERROR("Failed check {0}, in {1} at line {2}, {3}", #check, __FILE__, __LINE__, message);  \
+        }                                                                                                 \
+    } while (false)
 #define ADERITE_ABORT(message)
 #endif
 
@@ -20,7 +20,54 @@ namespace Aderite
             return __RaycastSingle(from, direction, MaxDistance);
         }
 
+        /// <summary>
+        /// Does a single hit raycast for every ray in one call, the rays are cast in parallel. Prefer this over many
+        /// RaycastFirstHit calls, e.g. for line of sight checks of many agents.
+        /// </summary>
+        /// <param name="from">From points</param>
+        /// <param name="directions">Directions to cast to</param>
+        /// <param name="maxDistances">Max distances of the rays</param>
+        /// <returns>Closest hit of every ray, null for rays that didn't hit anything</returns>
+        public static RaycastResult[] RaycastFirstHits(Vector3[] from, Vector3[] directions, float[] maxDistances)
+        {
+            return __RaycastBatch(from, directions, maxDistances, null);
+        }
+
+        /// <summary>
+        /// Does a single hit raycast for every ray in one call, every ray only hits the layers in its mask
+        /// </summary>
+        /// <param name="from">From points</param>
+        /// <param name="directions">Directions to cast to</param>
+        /// <param name="maxDistances">Max distances of the rays</param>
+        /// <param name="layerMasks">Bit n of a mask hits colliders on layer n, 0 hits every layer</param>
+        /// <returns>Closest hit of every ray, null for rays that didn't hit anything</returns>
+        public static RaycastResult[] RaycastFirstHits(Vector3[] from, Vector3[] directions, float[] maxDistances, uint[] layerMasks)
+        {
+            return __RaycastBatch(from, directions, maxDistances, layerMasks);
+        }
+
+        /// <summary>
+        /// Raycasts every ray in one call and returns all of its hits. Rays with a zero direction or a negative
+        /// distance have no hits.
+        /// </summary>
+        /// <param name="from">From points</param>
+        /// <param name="directions">Directions to cast to</param>
+        /// <param name="maxDistances">Max distances of the rays</param>
+        /// <param name="layerMasks">Bit n of a mask hits colliders on layer n, 0 hits every layer, null hits every layer for
+        /// every ray</param>
+        /// <returns>Hits of every ray sorted by distance, empty for rays that didn't hit anything</returns>
+        public static RaycastResult[][] RaycastAllHits(Vector3[] from, Vector3[] directions, float[] maxDistances, uint[] layerMasks = null)
+        {
+            return __RaycastBatchAll(from, directions, maxDistances, layerMasks);
+        }
+
         [MethodImpl(MethodImplOptions.InternalCall)]
         private extern static RaycastResult __RaycastSingle(Vector3 from, Vector3 direction, float distance);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private extern static RaycastResult[] __RaycastBatch(Vector3[] from, Vector3[] directions, float[] distances, uint[] layerMasks);
+
+        [MethodImpl(MethodImplOptions.InternalCall)]
+        private extern static RaycastResult[][] __RaycastBatchAll(Vector3[] from, Vector3[] directions, float[] distances, uint[] layerMasks);
     }
 }
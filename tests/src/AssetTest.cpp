@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
 #include <aderite/Aderite.hpp>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -12,7 +18,13 @@
 #include <aderite/asset/MeshAsset.hpp>
 #include <aderite/asset/PrefabAsset.hpp>
 #include <aderite/asset/TextureAsset.hpp>
+#include <aderite/io/FileHandler.hpp>
+#include <aderite/io/LoaderPool.hpp>
+#include <aderite/rendering/Renderable.hpp>
+#include <aderite/scene/GameObject.hpp>
+#include <aderite/scene/Scene.hpp>
 #include <aderite/reflection/RuntimeTypes.hpp>
+#include <aderite/utility/Log.hpp>
 
 #define private private
 #define protected protected
@@ -52,7 +64,10 @@ TEST_F(AssetTest, AssetManager_track) {
 
     EXPECT_EQ(testMesh->m_handle, 0);
     EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry.size(), 1);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->getTrackedCount(), 1);
     EXPECT_EQ(::aderite::Engine::getAssetManager()->m_nextFreeHandle, 1);
+
+    aderite::Engine::getAssetManager()->untrack(testMesh);
 }
 
 /**
@@ -61,14 +76,18 @@ TEST_F(AssetTest, AssetManager_track) {
 TEST_F(AssetTest, AssetManager_untrack) {
     aderite::Engine::getAssetManager()->track(testMesh);
 
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry.size(), 1);
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_nextFreeHandle, 1);
+    EXPECT_EQ(testMesh->m_handle, 1);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->getTrackedCount(), 1);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_nextFreeHandle, 2);
 
     aderite::Engine::getAssetManager()->untrack(testMesh);
 
-    EXPECT_EQ(testMesh->m_handle, 0);
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry.size(), 0);
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_nextFreeHandle, 1);
+    // Handles are not reused, the slot stays behind empty
+    EXPECT_EQ(testMesh->m_handle, 1);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->getTrackedCount(), 0);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry.size(), 2);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_nextFreeHandle, 2);
+    EXPECT_FALSE(::aderite::Engine::getAssetManager()->has(1));
 }
 
 /**
@@ -76,7 +95,9 @@ TEST_F(AssetTest, AssetManager_untrack) {
  */
 TEST_F(AssetTest, AssetManager_has) {
     aderite::Engine::getAssetManager()->track(testMesh);
-    EXPECT_TRUE(::aderite::Engine::getAssetManager()->get(testMesh->m_handle));
+    EXPECT_TRUE(::aderite::Engine::getAssetManager()->has(testMesh->m_handle));
+    EXPECT_FALSE(::aderite::Engine::getAssetManager()->has(testMesh->m_handle + 1));
+    aderite::Engine::getAssetManager()->untrack(testMesh);
 }
 
 /**
@@ -86,33 +107,183 @@ TEST_F(AssetTest, AssetManager_get) {
     aderite::Engine::getAssetManager()->track(testMesh);
     aderite::io::SerializableAsset* asset = ::aderite::Engine::getAssetManager()->get(testMesh->m_handle);
     EXPECT_EQ(testMesh, asset);
+    aderite::Engine::getAssetManager()->untrack(testMesh);
+}
+
+/**
+ * @brief Verify the asset manager stale instance detection
+ */
+TEST_F(AssetTest, AssetManager_isStale) {
+    aderite::Engine::getAssetManager()->track(testMesh);
+    const aderite::asset::AssetManager::WeakHandle weak = ::aderite::Engine::getAssetManager()->getWeakHandle(testMesh);
+    EXPECT_FALSE(::aderite::Engine::getAssetManager()->isStale(weak));
+
+    aderite::Engine::getAssetManager()->untrack(testMesh);
+
+    EXPECT_TRUE(::aderite::Engine::getAssetManager()->isStale(weak));
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry[weak.Handle].Generation, weak.Generation + 1);
 }
 
 /**
  * @brief Verify the asset manager update method
  */
 TEST_F(AssetTest, AssetManager_update) {
+    // Free immediately instead of keeping the mesh resident
+    const aderite::reflection::Type meshType = static_cast<aderite::reflection::Type>(aderite::reflection::RuntimeTypes::MESH);
+    const size_t budget = ::aderite::Engine::getAssetManager()->getResidencyBudget(meshType);
+    ::aderite::Engine::getAssetManager()->setResidencyBudget(meshType, 0);
+
     aderite::Engine::getAssetManager()->track(testMesh);
+    const aderite::io::SerializableHandle handle = testMesh->m_handle;
 
     // Make needsLoading return false
     testMesh->m_vbh = {1};
     testMesh->m_ibh = {1};
+    testMesh->m_loaded = true;
 
     // When a ref count is positive the mesh should remain
-    testMesh->m_refCount = 1;
+    testMesh->acquire();
+    EXPECT_TRUE(::aderite::Engine::getAssetManager()->m_registry[handle].Dirty);
     ::aderite::Engine::getAssetManager()->update();
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry.size(), 1);
-    EXPECT_NE(::aderite::Engine::getAssetManager()->m_registry[0].Asset, nullptr);
+    EXPECT_FALSE(::aderite::Engine::getAssetManager()->m_registry[handle].Dirty);
+    EXPECT_NE(::aderite::Engine::getAssetManager()->m_registry[handle].Asset, nullptr);
 
     // Ignore unload call
     testMesh->m_vbh = BGFX_INVALID_HANDLE;
     testMesh->m_ibh = BGFX_INVALID_HANDLE;
+    testMesh->m_loaded = false;
 
     // When ref count 0 should free asset
-    testMesh->m_refCount = 0;
+    testMesh->release();
     ::aderite::Engine::getAssetManager()->update();
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry.size(), 1);
-    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry[0].Asset, nullptr);
+    EXPECT_TRUE(::aderite::Engine::getAssetManager()->has(handle));
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry[handle].Asset, nullptr);
+    EXPECT_EQ(::aderite::Engine::getAssetManager()->m_registry[handle].Generation, 1);
+
+    ::aderite::Engine::getAssetManager()->setResidencyBudget(meshType, budget);
+}
+
+/**
+ * @brief Verify that zero reference assets stay resident within the budget and are evicted least recently used first
+ */
+TEST_F(AssetTest, AssetManager_residency) {
+    aderite::asset::AssetManager* manager = ::aderite::Engine::getAssetManager();
+    const aderite::reflection::Type meshType = static_cast<aderite::reflection::Type>(aderite::reflection::RuntimeTypes::MESH);
+    const size_t budget = manager->getResidencyBudget(meshType);
+    const aderite::asset::AssetManager::ResidencyStatistics before = manager->getResidencyStatistics();
+    const size_t unit = aderite::asset::AssetManager::c_MinResidentSize;
+    manager->setResidencyBudget(meshType, 10 * unit);
+
+    // Meshes without data fail to load, but the load jobs must finish before the meshes are evicted
+    auto update = [manager]() {
+        manager->update();
+        while (::aderite::Engine::getLoaderPool()->m_inFlight.load() > 0) {
+            std::this_thread::yield();
+        }
+    };
+
+    aderite::asset::MeshAsset* first = new aderite::asset::MeshAsset();
+    manager->track(first);
+    first->m_residentSize = 6 * unit;
+
+    // Released assets stay resident
+    first->acquire();
+    update();
+    first->release();
+    update();
+    EXPECT_EQ(manager->m_registry[first->m_handle].Asset, first);
+    EXPECT_EQ(manager->getResidentSize(meshType), 6 * unit);
+
+    // Acquiring again is a hit
+    EXPECT_EQ(manager->get(first->m_handle), first);
+    first->acquire();
+    update();
+    EXPECT_EQ(manager->getResidencyStatistics().Hits, before.Hits + 1);
+    EXPECT_EQ(manager->getResidentSize(meshType), 0);
+
+    // Exceeding the budget evicts the least recently released asset
+    aderite::asset::MeshAsset* second = new aderite::asset::MeshAsset();
+    manager->track(second);
+    second->m_residentSize = 6 * unit;
+    second->acquire();
+
+    const aderite::io::SerializableHandle firstHandle = first->m_handle;
+    first->release();
+    update();
+    second->release();
+    update();
+    EXPECT_EQ(manager->m_registry[firstHandle].Asset, nullptr);
+    EXPECT_EQ(manager->m_registry[second->m_handle].Asset, second);
+    EXPECT_EQ(manager->getResidentSize(meshType), 6 * unit);
+    EXPECT_EQ(manager->getResidencyStatistics().Evictions, before.Evictions + 1);
+
+    // Assets that report no size still count towards the budget
+    aderite::asset::MeshAsset* third = new aderite::asset::MeshAsset();
+    manager->track(third);
+    third->acquire();
+    update();
+    third->release();
+    update();
+    EXPECT_EQ(manager->getResidentSize(meshType), 7 * unit);
+
+    // Disabling the budget evicts the rest
+    const aderite::io::SerializableHandle secondHandle = second->m_handle;
+    const aderite::io::SerializableHandle thirdHandle = third->m_handle;
+    manager->setResidencyBudget(meshType, 0);
+    EXPECT_EQ(manager->m_registry[secondHandle].Asset, nullptr);
+    EXPECT_EQ(manager->m_registry[thirdHandle].Asset, nullptr);
+    EXPECT_EQ(manager->getResidentSize(meshType), 0);
+
+    manager->setResidencyBudget(meshType, budget);
+}
+
+/**
+ * @brief Measures asset manager get and update with 1k, 10k and 100k registry entries
+ */
+TEST_F(AssetTest, AssetManager_benchmark) {
+    for (size_t count : {1000, 10000, 100000}) {
+        aderite::asset::AssetManager manager;
+        std::vector<aderite::asset::AudioAsset> assets(count);
+
+        manager.m_registry.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            assets[i].m_handle = i;
+            assets[i].m_refCount = 1;
+            manager.m_registry[i].Asset = &assets[i];
+            manager.m_registry[i].Handle = i;
+            manager.m_registry[i].Tracked = true;
+        }
+        manager.m_nextFreeHandle = count;
+        manager.m_trackedCount = count;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t found = 0;
+        for (size_t i = 0; i < count; i++) {
+            found += manager.get(i) == &assets[i];
+        }
+        const double getNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / count;
+        EXPECT_EQ(found, count);
+
+        // Typical frame, a handful of reference count changes
+        for (size_t i = 0; i < count; i += 100) {
+            manager.markDirty(i);
+        }
+
+        start = std::chrono::high_resolution_clock::now();
+        manager.update();
+        const double dirtyUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        manager.update();
+        const double idleUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LOG_INFO("[Test] {0} entries: get {1} ns/op, update {2} us with {3} dirty, {4} us idle", count, getNs, dirtyUs, count / 100,
+                 idleUs);
+
+        for (aderite::asset::AudioAsset& asset : assets) {
+            asset.m_refCount = 0;
+        }
+    }
 }
 
 /**
@@ -152,12 +323,17 @@ TEST_F(AssetTest, MeshAsset_isValid) {
     ma.m_vbh = {1};
     ma.m_ibh = {1};
 
+    // Handles alone don't publish the mesh
+    EXPECT_FALSE(ma.isValid());
+    ma.m_loaded = true;
+
     // Should be true now
     EXPECT_TRUE(ma.isValid());
 
     // Reset to not crash bgfx
     ma.m_vbh = BGFX_INVALID_HANDLE;
     ma.m_ibh = BGFX_INVALID_HANDLE;
+    ma.m_loaded = false;
 }
 
 ///**
@@ -195,3 +371,85 @@ TEST_F(AssetTest, ReflectionTypes) {
     EXPECT_EQ(static_cast<aderite::reflection::RuntimeTypes>(pa.getType()), aderite::reflection::RuntimeTypes::PREFAB);
     EXPECT_EQ(static_cast<aderite::reflection::RuntimeTypes>(ta.getType()), aderite::reflection::RuntimeTypes::TEXTURE);
 }
+
+/**
+ * @brief Compares time to first frame of a 500 material scene between synchronous get and getAsync
+ */
+TEST_F(AssetTest, AssetManager_timeToFirstFrame) {
+    constexpr size_t materialCount = 500;
+    aderite::asset::AssetManager* manager = aderite::Engine::getAssetManager();
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "aderite_asset_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "Asset");
+    std::filesystem::create_directories(root / "Data");
+    aderite::Engine::getFileHandler()->setRoot(root);
+
+    // Build and save the scene, every game object has its own material of a shared type
+    aderite::asset::MaterialTypeAsset* type = new aderite::asset::MaterialTypeAsset();
+    manager->track(type);
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    manager->track(scene);
+
+    std::vector<aderite::asset::MaterialAsset*> materials;
+    for (size_t i = 0; i < materialCount; i++) {
+        aderite::asset::MaterialAsset* material = new aderite::asset::MaterialAsset();
+        manager->track(material);
+        material->setMaterialType(type);
+        manager->save(material);
+        scene->createGameObject()->addRenderable()->getData().setMaterial(material);
+    }
+
+    manager->save(type);
+    manager->save(scene);
+    const aderite::io::SerializableHandle sceneHandle = scene->getHandle();
+
+    // Free everything, scene then materials then the type
+    auto freeAll = [manager]() {
+        for (size_t i = 0; i < 4; i++) {
+            manager->update();
+        }
+    };
+
+    freeAll();
+    ASSERT_EQ(manager->m_registry[sceneHandle].Asset, nullptr);
+
+    // Synchronous, everything is read and parsed on the calling thread
+    auto start = std::chrono::high_resolution_clock::now();
+    scene = static_cast<aderite::scene::Scene*>(manager->get(sceneHandle));
+    scene->acquire();
+    manager->update();
+    const double syncMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    EXPECT_EQ(scene->getGameObjects().size(), materialCount);
+
+    scene->release();
+    freeAll();
+    ASSERT_EQ(manager->m_registry[sceneHandle].Asset, nullptr);
+
+    // Asynchronous, documents are parsed on job workers in one wave
+    start = std::chrono::high_resolution_clock::now();
+    aderite::asset::AssetFuture future = manager->getAsync(sceneHandle);
+    size_t frames = 0;
+    double longestFrameMs = 0.0;
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        const auto frameStart = std::chrono::high_resolution_clock::now();
+        manager->update();
+        frames++;
+        longestFrameMs = std::max(
+            longestFrameMs, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count());
+    }
+    const double asyncMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    scene = static_cast<aderite::scene::Scene*>(future.get());
+    EXPECT_EQ(scene->getGameObjects().size(), materialCount);
+    EXPECT_EQ(scene->m_refCount, 1);
+    for (const auto& object : scene->getGameObjects()) {
+        EXPECT_NE(object->getRenderable()->getData().getMaterial(), nullptr);
+    }
+
+    LOG_INFO("[Test] {0} materials: sync first frame {1} ms, async first frame {2} ms over {3} updates, longest update {4} ms",
+             materialCount, syncMs, asyncMs, frames, longestFrameMs);
+
+    scene->release();
+    freeAll();
+}
@@ -1,11 +1,29 @@
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+
 #include <aderite/Aderite.hpp>
+#include <bgfx/bgfx.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #define private public
 #define protected public
 
+#include <aderite/asset/MeshAsset.hpp>
 #include <aderite/input/InputManager.hpp>
+#include <aderite/io/BinaryArchive.hpp>
+#include <aderite/io/FileHandler.hpp>
+#include <aderite/io/Loader.hpp>
+#include <aderite/io/MeshCooker.hpp>
+#include <aderite/io/PackedArchive.hpp>
+#include <aderite/io/Serializer.hpp>
+#include <aderite/io/TextureCooker.hpp>
+#include <aderite/scene/GameObject.hpp>
+#include <aderite/scene/Scene.hpp>
+#include <aderite/scene/TransformProvider.hpp>
+#include <aderite/utility/Log.hpp>
 
 #define private private
 #define protected protected
@@ -19,6 +37,63 @@ public:
     static void TearDownTestSuite() {
         aderite::Engine::get()->shutdown();
     }
+
+    /**
+     * @brief Emits a scene like document with the specified number of game objects
+     */
+    static std::string emitScene(size_t objectCount) {
+        YAML::Emitter out;
+        out << YAML::BeginMap;
+        out << YAML::Key << "Type" << YAML::Value << 3;
+        out << YAML::Key << "Name" << YAML::Value << "Scene";
+        out << YAML::Key << "Data" << YAML::BeginMap;
+        out << YAML::Key << "GameObjects" << YAML::BeginSeq;
+        for (size_t i = 0; i < objectCount; i++) {
+            out << YAML::BeginMap;
+            out << YAML::Key << "Name" << YAML::Value << "GameObject " + std::to_string(i);
+            out << YAML::Key << "Transform" << YAML::BeginMap;
+            out << YAML::Key << "Position" << YAML::Flow << YAML::BeginSeq << i * 0.5f << 1.0f << -2.0f << YAML::EndSeq;
+            out << YAML::Key << "Rotation" << YAML::Flow << YAML::BeginSeq << 1.0f << 0.0f << 0.0f << 0.0f << YAML::EndSeq;
+            out << YAML::Key << "Scale" << YAML::Flow << YAML::BeginSeq << 1.0f << 1.0f << 1.0f << YAML::EndSeq;
+            out << YAML::EndMap;
+            out << YAML::Key << "Renderable" << YAML::BeginMap;
+            out << YAML::Key << "Mesh" << YAML::Value << i % 16;
+            out << YAML::Key << "Material" << YAML::Value << i % 8;
+            out << YAML::EndMap;
+            out << YAML::EndMap;
+        }
+        out << YAML::EndSeq;
+        out << YAML::EndMap;
+        out << YAML::EndMap;
+        return out.c_str();
+    }
+
+    /**
+     * @brief Emits an OBJ grid with the specified number of quads per side, 2 triangles per quad
+     */
+    static std::string emitGrid(size_t quads) {
+        std::string obj;
+        for (size_t z = 0; z <= quads; z++) {
+            for (size_t x = 0; x <= quads; x++) {
+                obj += "v " + std::to_string(x) + " 0 " + std::to_string(z) + "\n";
+            }
+        }
+
+        obj += "vn 0 1 0\n";
+        for (size_t z = 0; z < quads; z++) {
+            for (size_t x = 0; x < quads; x++) {
+                const size_t i = z * (quads + 1) + x + 1;
+                const std::string a = std::to_string(i) + "//1 ";
+                const std::string b = std::to_string(i + 1) + "//1 ";
+                const std::string c = std::to_string(i + quads + 1) + "//1 ";
+                const std::string d = std::to_string(i + quads + 2) + "//1 ";
+                obj += "f " + a + c + b + "\n";
+                obj += "f " + b + c + d + "\n";
+            }
+        }
+
+        return obj;
+    }
 };
 
 /**
@@ -128,3 +203,385 @@ TEST_F(IoTest, InputManager_getScrollDelta) {
     aderite::Engine::getInputManager()->m_currentFrameState.MouseScroll = 10;
     EXPECT_EQ(aderite::Engine::getInputManager()->getScrollDelta(), 10);
 }
+
+/**
+ * @brief Verifies that files packed into an archive are read back from the mapping unchanged
+ */
+TEST_F(IoTest, PackedArchive_roundTrip) {
+    using aderite::io::PackedArchive;
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "aderite_pack_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "Asset");
+    std::filesystem::create_directories(root / "Data");
+
+    auto write = [&root](const std::string& name, const std::string& contents) {
+        std::ofstream(root / name, std::ios::binary) << contents;
+    };
+
+    const std::string scene = emitScene(4);
+    write("Asset/7.asset", scene);
+    write("Data/3.data", "loadable");
+    write("Data/_4.data", "registry");
+    write("Data/notes.data", "not a handle");
+
+    ASSERT_TRUE(PackedArchive::pack(root, root / PackedArchive::c_DefaultName));
+
+    {
+        PackedArchive archive;
+        ASSERT_TRUE(archive.open(root / PackedArchive::c_DefaultName));
+
+        size_t size = 0;
+        const unsigned char* data = archive.find(PackedArchive::EntryKind::SERIALIZABLE, 7, size);
+        ASSERT_NE(data, nullptr);
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), size), scene);
+        EXPECT_EQ(data[size], '\0');
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % PackedArchive::c_Alignment, 0);
+
+        data = archive.find(PackedArchive::EntryKind::RESERVED, 4, size);
+        ASSERT_NE(data, nullptr);
+        EXPECT_EQ(std::string(reinterpret_cast<const char*>(data), size), "registry");
+
+        // Same handle but another kind
+        EXPECT_EQ(archive.find(PackedArchive::EntryKind::LOADABLE, 4, size), nullptr);
+        EXPECT_EQ(archive.m_entryCount, 3);
+    }
+
+    // Loose files are preferred over the archive so writes made after packing are read back
+    aderite::io::FileHandler handler;
+    handler.setRoot(root);
+    const aderite::io::DataChunk loose = handler.openLoadable(3);
+    EXPECT_FALSE(loose.isView());
+
+    // Files missing from disk are read through the mapping and have the same size as their loose version
+    std::filesystem::remove(root / "Data/3.data");
+    aderite::io::DataChunk chunk = handler.openLoadable(3);
+    ASSERT_TRUE(chunk.isView());
+    EXPECT_EQ(chunk.size(), loose.size());
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(chunk.data()), chunk.size()), "loadable");
+
+    // Committing an untouched view writes its contents
+    handler.commit(chunk);
+    std::ifstream in(root / "Data/3.data", std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()), "loadable");
+    in.close();
+
+    // Written chunks commit their own data
+    chunk.Data.assign({'n', 'e', 'w'});
+    EXPECT_FALSE(chunk.isView());
+    handler.commit(chunk);
+    in.open(root / "Data/3.data", std::ios::binary);
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()), "new");
+    in.close();
+
+    handler.m_archive->close();
+    std::filesystem::remove_all(root);
+}
+
+/**
+ * @brief Verifies that entries pointing past the end of the archive are rejected
+ */
+TEST_F(IoTest, PackedArchive_corruptEntry) {
+    using aderite::io::PackedArchive;
+
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "aderite_pack_corrupt_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "Data");
+    std::ofstream(root / "Data/3.data", std::ios::binary) << "loadable";
+
+    const std::filesystem::path path = root / PackedArchive::c_DefaultName;
+    ASSERT_TRUE(PackedArchive::pack(root, path));
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+    // Point the only entry past the end of the file
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        PackedArchive::Header header = {};
+        file.read(reinterpret_cast<char*>(&header), sizeof(PackedArchive::Header));
+        PackedArchive::TocEntry entry = {};
+        file.seekg(header.TocOffset);
+        file.read(reinterpret_cast<char*>(&entry), sizeof(PackedArchive::TocEntry));
+        entry.Size = std::filesystem::file_size(path);
+        file.seekp(header.TocOffset);
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(PackedArchive::TocEntry));
+    }
+
+    {
+        PackedArchive archive;
+        ASSERT_TRUE(archive.open(path));
+        size_t size = 0;
+        EXPECT_EQ(archive.find(PackedArchive::EntryKind::LOADABLE, 3, size), nullptr);
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+/**
+ * @brief Verifies that binary archives decode to the same document they were written from
+ */
+TEST_F(IoTest, BinaryArchive_roundTrip) {
+    const std::string text = emitScene(16);
+    const YAML::Node original = YAML::Load(text);
+    const std::vector<unsigned char> archive = aderite::io::BinaryArchive::write(original);
+
+    // Converting text encodes parser events directly and must match encoding the loaded tree
+    EXPECT_EQ(aderite::io::BinaryArchive::convert(text), archive);
+
+    ASSERT_TRUE(aderite::io::BinaryArchive::isBinary(archive.data(), archive.size()));
+    EXPECT_FALSE(aderite::io::BinaryArchive::isBinary(reinterpret_cast<const unsigned char*>(text.data()), text.size()));
+    EXPECT_EQ(aderite::io::BinaryArchive::readType(archive.data(), archive.size()), 3);
+    EXPECT_LT(archive.size(), text.size());
+
+    // Flow style is not stored so compare the encoded trees instead of the dumped text
+    const YAML::Node decoded = aderite::io::BinaryArchive::read(archive.data(), archive.size());
+    EXPECT_EQ(aderite::io::BinaryArchive::write(decoded), archive);
+    EXPECT_EQ(decoded["Data"]["GameObjects"][5]["Name"].as<std::string>(), "GameObject 5");
+    EXPECT_EQ(decoded["Data"]["GameObjects"][5]["Renderable"]["Mesh"].as<int>(), 5);
+}
+
+/**
+ * @brief Verifies that truncated binary archives are rejected
+ */
+TEST_F(IoTest, BinaryArchive_truncated) {
+    const std::vector<unsigned char> archive = aderite::io::BinaryArchive::convert(emitScene(4));
+    const YAML::Node decoded = aderite::io::BinaryArchive::read(archive.data(), archive.size() / 2);
+    EXPECT_FALSE(decoded.IsDefined() && decoded.IsMap());
+}
+
+/**
+ * @brief Compares the time to parse a 10k game object scene from YAML text and from a binary archive
+ */
+TEST_F(IoTest, BinaryArchive_loadTime) {
+    aderite::io::Serializer* serializer = aderite::Engine::getSerializer();
+
+    aderite::scene::Scene* source = new aderite::scene::Scene();
+    for (size_t i = 0; i < 10000; i++) {
+        source->createGameObject()->addTransform()->setPosition({i * 0.5f, 1.0f, -2.0f});
+    }
+
+    YAML::Emitter out;
+    serializer->writeObject(out, source);
+    delete source;
+
+    const std::string text = out.c_str();
+    std::vector<unsigned char> textData(text.c_str(), text.c_str() + text.size());
+    const aderite::io::DataChunk textChunk(0, text.size(), "Scene", std::move(textData));
+    const aderite::io::DataChunk binaryChunk(0, 0, "Scene", aderite::io::BinaryArchive::convert(text));
+
+    auto parse = [serializer](const aderite::io::DataChunk& chunk, double& ms) {
+        auto start = std::chrono::high_resolution_clock::now();
+        aderite::scene::Scene* scene = static_cast<aderite::scene::Scene*>(serializer->parseObject(serializer->readDocument(chunk)));
+        ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        return scene;
+    };
+
+    double textMs = 0.0;
+    double binaryMs = 0.0;
+    aderite::scene::Scene* fromText = parse(textChunk, textMs);
+    aderite::scene::Scene* fromBinary = parse(binaryChunk, binaryMs);
+
+    LOG_INFO("[Test] 10k game objects: YAML {0} bytes {1} ms, binary {2} bytes {3} ms", text.size(), textMs, binaryChunk.size(),
+             binaryMs);
+    ASSERT_EQ(fromText->getGameObjects().size(), 10000);
+    ASSERT_EQ(fromBinary->getGameObjects().size(), 10000);
+    EXPECT_EQ(fromBinary->getGameObjects()[5]->getTransform()->getPosition(),
+              fromText->getGameObjects()[5]->getTransform()->getPosition());
+
+    delete fromText;
+    delete fromBinary;
+}
+
+/**
+ * @brief Verifies that cooked meshes pick the smallest index size and read back correctly
+ */
+TEST_F(IoTest, MeshCooker_indexSize) {
+    const std::vector<uint32_t> indices = {0, 1, 2};
+    std::vector<unsigned char> cooked;
+    aderite::io::MeshCooker::View view;
+
+    // 3 vertices, 16 bit indices
+    aderite::io::MeshCooker::cook(std::vector<float>(3 * 8, 1.0f), indices, cooked);
+    ASSERT_TRUE(aderite::io::MeshCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_FALSE(view.Index32);
+    EXPECT_EQ(view.VertexCount, 3);
+    EXPECT_EQ(view.IndexSize, 3 * sizeof(uint16_t));
+    EXPECT_EQ(reinterpret_cast<const uint16_t*>(view.Indices)[2], 2);
+    EXPECT_EQ(static_cast<size_t>(view.Indices - cooked.data()) % aderite::io::MeshCooker::c_Alignment, 0);
+
+    // Too many vertices for 16 bit indices
+    aderite::io::MeshCooker::cook(std::vector<float>(70000 * 8, 1.0f), indices, cooked);
+    ASSERT_TRUE(aderite::io::MeshCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_TRUE(view.Index32);
+    EXPECT_EQ(view.IndexSize, 3 * sizeof(uint32_t));
+
+    // Truncated data is rejected
+    EXPECT_FALSE(aderite::io::MeshCooker::read(cooked.data(), cooked.size() / 2, view));
+}
+
+/**
+ * @brief Compares loading 1k, 10k and 100k triangle grids from disk into a built MeshAsset, once from the OBJ source
+ * which is imported and cooked on load and once from the cooked data
+ */
+TEST_F(IoTest, MeshCooker_loadTime) {
+    const std::filesystem::path root = std::filesystem::temp_directory_path() / "aderite_mesh_load_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "Asset");
+    std::filesystem::create_directories(root / "Data");
+    aderite::Engine::getFileHandler()->setRoot(root);
+
+    aderite::io::MeshCooker cooker;
+    aderite::io::Loader loader;
+    for (size_t quads : {23, 71, 224}) {
+        const std::string obj = emitGrid(quads);
+        const size_t triangles = quads * quads * 2;
+
+        std::vector<unsigned char> cooked;
+        std::string error;
+        ASSERT_TRUE(cooker.cook(reinterpret_cast<const unsigned char*>(obj.data()), obj.size(), "obj", cooked, error)) << error;
+
+        // Handle 0 holds the source, handle 1 the cooked mesh
+        std::ofstream(root / "Data/0.data", std::ios::binary) << obj;
+        std::ofstream(root / "Data/1.data", std::ios::binary).write(reinterpret_cast<const char*>(cooked.data()), cooked.size());
+
+        auto load = [&loader](aderite::io::SerializableHandle handle, double& ms) {
+            aderite::asset::MeshAsset mesh;
+            mesh.m_handle = handle;
+            auto start = std::chrono::high_resolution_clock::now();
+            loader.load(&mesh);
+            ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            return mesh.isValid() ? mesh.m_lods[0].IndexCount : 0;
+        };
+
+        double sourceMs = 0.0;
+        double cookedMs = 0.0;
+        EXPECT_EQ(load(0, sourceMs), triangles * 3);
+        EXPECT_EQ(load(1, cookedMs), triangles * 3);
+
+        LOG_INFO("[Test] {0} triangles: source {1} ms, cooked {2} bytes {3} ms, {4}x faster", triangles, sourceMs, cooked.size(),
+                 cookedMs, sourceMs / cookedMs);
+    }
+
+    std::filesystem::remove_all(root);
+}
+
+/**
+ * @brief Verifies that cooking generates progressively simpler detail levels that index the shared vertices
+ */
+TEST_F(IoTest, MeshCooker_lods) {
+    // Curved 64x64 quad grid
+    const uint32_t quads = 64;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y <= quads; y++) {
+        for (uint32_t x = 0; x <= quads; x++) {
+            const float height = std::sin(x * 0.3f) * std::cos(y * 0.2f);
+            vertices.insert(vertices.end(), {float(x), height, float(y), 0.0f, 1.0f, 0.0f, float(x) / quads, float(y) / quads});
+        }
+    }
+
+    for (uint32_t y = 0; y < quads; y++) {
+        for (uint32_t x = 0; x < quads; x++) {
+            const uint32_t a = y * (quads + 1) + x;
+            const uint32_t c = a + quads + 1;
+            indices.insert(indices.end(), {a, c, a + 1, a + 1, c, c + 1});
+        }
+    }
+
+    std::vector<unsigned char> cooked;
+    aderite::io::MeshCooker::cook(vertices, indices, cooked);
+
+    aderite::io::MeshCooker::View view;
+    ASSERT_TRUE(aderite::io::MeshCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_EQ(view.LodCount, aderite::io::MeshCooker::c_MaxLods);
+    EXPECT_EQ(view.IndexCount, indices.size());
+    EXPECT_EQ(view.Lods[0].IndexCount, indices.size());
+
+    const uint16_t* data = reinterpret_cast<const uint16_t*>(view.Indices);
+    for (uint32_t lod = 1; lod < view.LodCount; lod++) {
+        EXPECT_LT(view.Lods[lod].IndexCount, view.Lods[lod - 1].IndexCount * 4 / 5);
+        EXPECT_EQ(view.Lods[lod].IndexCount % 3, 0);
+
+        for (uint32_t i = 0; i < view.Lods[lod].IndexCount; i += 3) {
+            const uint16_t* triangle = data + view.Lods[lod].FirstIndex + i;
+            EXPECT_LT(triangle[0], view.VertexCount);
+            EXPECT_TRUE(triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2]);
+        }
+    }
+
+    // Small meshes keep a single level
+    aderite::io::MeshCooker::cook(std::vector<float>(3 * 8, 1.0f), {0, 1, 2}, cooked);
+    ASSERT_TRUE(aderite::io::MeshCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_EQ(view.LodCount, 1);
+}
+
+/**
+ * @brief Verifies cooked texture format selection, mip chain and streaming base
+ */
+TEST_F(IoTest, TextureCooker_levels) {
+    std::vector<unsigned char> pixels(256 * 128 * 4, 255);
+    std::vector<unsigned char> cooked;
+    aderite::io::TextureCooker::View view;
+
+    // Opaque power of two, full chain down to 1x1
+    aderite::io::TextureCooker::cook(pixels.data(), 256, 128, 4, true, cooked);
+    ASSERT_TRUE(aderite::io::TextureCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_EQ(view.Format, bgfx::TextureFormat::BC1);
+    ASSERT_EQ(view.Levels.size(), 9);
+    EXPECT_EQ(view.Levels[1].Width, 128);
+    EXPECT_EQ(view.Levels[1].Height, 64);
+    EXPECT_EQ(view.Levels[0].Size, 64 * 32 * 8);
+    EXPECT_EQ(view.Levels[8].Size, 8);
+    EXPECT_EQ(view.Levels[0].Data + view.Levels[0].Size, view.Levels[1].Data);
+    EXPECT_EQ(aderite::io::TextureCooker::getStreamingBase(view, 64), 2);
+
+    // Compressed top levels have to stay a multiple of the block size
+    EXPECT_EQ(aderite::io::TextureCooker::getStreamingBase(view, 2), 5);
+
+    // Alpha
+    pixels[3] = 0;
+    aderite::io::TextureCooker::cook(pixels.data(), 256, 128, 4, true, cooked);
+    ASSERT_TRUE(aderite::io::TextureCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_EQ(view.Format, bgfx::TextureFormat::BC3);
+
+    // Two channels, non power of two is stored uncompressed
+    aderite::io::TextureCooker::cook(pixels.data(), 100, 60, 2, true, cooked);
+    ASSERT_TRUE(aderite::io::TextureCooker::read(cooked.data(), cooked.size(), view));
+    EXPECT_EQ(view.Format, bgfx::TextureFormat::RG8);
+    EXPECT_FALSE(view.Compressed);
+    EXPECT_EQ(view.Levels.back().Width, 1);
+    EXPECT_EQ(view.Levels.back().Height, 1);
+
+    // Truncated data is rejected
+    EXPECT_FALSE(aderite::io::TextureCooker::read(cooked.data(), cooked.size() - 1, view));
+}
+
+/**
+ * @brief Compares the size of a cooked 2048x2048 texture against the uncompressed level that used to be uploaded
+ */
+TEST_F(IoTest, TextureCooker_cookTime) {
+    const uint32_t size = 2048;
+    std::vector<unsigned char> pixels(size * size * 4);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            unsigned char* pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+            pixel[0] = static_cast<unsigned char>(x);
+            pixel[1] = static_cast<unsigned char>(y);
+            pixel[2] = static_cast<unsigned char>(x ^ y);
+            pixel[3] = 255;
+        }
+    }
+
+    std::vector<unsigned char> cooked;
+    auto start = std::chrono::high_resolution_clock::now();
+    aderite::io::TextureCooker::cook(pixels.data(), size, size, 4, true, cooked);
+    const double cookMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    aderite::io::TextureCooker::View view;
+    start = std::chrono::high_resolution_clock::now();
+    ASSERT_TRUE(aderite::io::TextureCooker::read(cooked.data(), cooked.size(), view));
+    const double readMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    LOG_INFO("[Test] 2048x2048 texture: raw {0} bytes, cooked {1} bytes with {2} levels, cook {3} ms, read {4} ms", pixels.size(),
+             cooked.size(), view.Levels.size(), cookMs, readMs);
+    EXPECT_LT(cooked.size(), pixels.size());
+}
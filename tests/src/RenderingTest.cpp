@@ -0,0 +1,824 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <aderite/Aderite.hpp>
+#include <bgfx/bgfx.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#define private public
+#define protected public
+
+#include <aderite/asset/MaterialAsset.hpp>
+#include <aderite/asset/MaterialTypeAsset.hpp>
+#include <aderite/asset/MeshAsset.hpp>
+#include <aderite/io/MeshCooker.hpp>
+#include <aderite/rendering/Bounds.hpp>
+#include <aderite/rendering/Culler.hpp>
+#include <aderite/rendering/DrawCall.hpp>
+#include <aderite/rendering/FrameData.hpp>
+#include <aderite/rendering/MaterialBuffer.hpp>
+#include <aderite/rendering/OcclusionBuffer.hpp>
+#include <aderite/rendering/RenderGraph.hpp>
+#include <aderite/rendering/RenderQueue.hpp>
+#include <aderite/rendering/Renderer.hpp>
+#include <aderite/rendering/StaticBatcher.hpp>
+#include <aderite/scene/ComponentRegistry.hpp>
+#include <aderite/utility/Log.hpp>
+
+#define private private
+#define protected protected
+
+/**
+ * @brief Number of heap allocations done by the test process
+ */
+static std::atomic<size_t> g_allocations {0};
+
+void* operator new(size_t size) {
+    g_allocations++;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+class RenderingTest : public ::testing::Test {
+public:
+    static void SetUpTestSuite() {
+        // Only CPU work is measured
+        aderite::Engine::InitOptions options;
+        options.NoopRenderer = true;
+        aderite::Engine::get()->init(options);
+    }
+
+    static void TearDownTestSuite() {
+        aderite::Engine::get()->shutdown();
+    }
+
+    /**
+     * @brief Camera at the origin looking down +z
+     */
+    static glm::mat4 viewProjection() {
+        const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return projection * view;
+    }
+
+    /**
+     * @brief Unit cube bounds
+     */
+    static aderite::rendering::Bounds cube() {
+        aderite::rendering::Bounds bounds;
+        bounds.Extents = glm::vec3(1.0f);
+        bounds.Radius = glm::length(bounds.Extents);
+        return bounds;
+    }
+};
+
+/**
+ * @brief Verifies bounds computation and transformation
+ */
+TEST_F(RenderingTest, Bounds_transform) {
+    const float points[] = {-1.0f, 0.0f, 2.0f, 3.0f, 4.0f, 6.0f};
+    const aderite::rendering::Bounds bounds = aderite::rendering::Bounds::fromPoints(points, 2, sizeof(glm::vec3));
+    EXPECT_EQ(bounds.Center, glm::vec3(1.0f, 2.0f, 4.0f));
+    EXPECT_EQ(bounds.Extents, glm::vec3(2.0f, 2.0f, 2.0f));
+
+    const glm::mat4 matrix = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(10.0f, 0.0f, 0.0f)), glm::vec3(2.0f));
+    const aderite::rendering::Bounds world = bounds.transform(matrix);
+    EXPECT_EQ(world.Center, glm::vec3(12.0f, 4.0f, 8.0f));
+    EXPECT_EQ(world.Extents, glm::vec3(4.0f, 4.0f, 4.0f));
+    EXPECT_FLOAT_EQ(world.Radius, bounds.Radius * 2.0f);
+}
+
+/**
+ * @brief Verifies sphere and box tests against the frustum planes
+ */
+TEST_F(RenderingTest, Frustum_test) {
+    const aderite::rendering::Frustum frustum(viewProjection());
+
+    EXPECT_TRUE(frustum.testSphere(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f));
+    EXPECT_TRUE(frustum.testBox(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(1.0f)));
+
+    // Behind, beyond the far plane and to the side
+    EXPECT_FALSE(frustum.testSphere(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f));
+    EXPECT_FALSE(frustum.testSphere(glm::vec3(0.0f, 0.0f, 2000.0f), 1.0f));
+    EXPECT_FALSE(frustum.testBox(glm::vec3(100.0f, 0.0f, 10.0f), glm::vec3(1.0f)));
+
+    // Intersecting the left plane
+    EXPECT_TRUE(frustum.testBox(glm::vec3(-18.0f, 0.0f, 10.0f), glm::vec3(10.0f)));
+}
+
+/**
+ * @brief Verifies that objects behind a rasterized occluder are hidden and objects in front of it are not
+ */
+TEST_F(RenderingTest, OcclusionBuffer_occlude) {
+    aderite::rendering::OccluderMesh wall;
+    wall.Vertices = {{-10.0f, -10.0f, 0.0f}, {10.0f, -10.0f, 0.0f}, {10.0f, 10.0f, 0.0f}, {-10.0f, 10.0f, 0.0f}};
+    wall.Indices = {0, 1, 2, 0, 2, 3};
+
+    const glm::mat4 vp = viewProjection();
+    const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 5.0f));
+
+    aderite::rendering::OcclusionBuffer buffer;
+    EXPECT_TRUE(buffer.isVisible(glm::vec2(-0.1f), glm::vec2(0.1f), 0.99f));
+
+    buffer.rasterize(vp * model, wall);
+
+    const glm::vec4 behind = vp * glm::vec4(0.0f, 0.0f, 20.0f, 1.0f);
+    const glm::vec4 inFront = vp * glm::vec4(0.0f, 0.0f, 2.0f, 1.0f);
+    EXPECT_FALSE(buffer.isVisible(glm::vec2(-0.1f), glm::vec2(0.1f), behind.z / behind.w));
+    EXPECT_TRUE(buffer.isVisible(glm::vec2(-0.1f), glm::vec2(0.1f), inFront.z / inFront.w));
+}
+
+/**
+ * @brief Verifies culler counters and packing of visible instances
+ */
+TEST_F(RenderingTest, Culler_cull) {
+    aderite::asset::MeshAsset wallMesh;
+    wallMesh.m_bounds.Extents = glm::vec3(10.0f, 10.0f, 0.0f);
+    wallMesh.m_bounds.Radius = glm::length(wallMesh.m_bounds.Extents);
+    wallMesh.m_occluder = std::make_unique<aderite::rendering::OccluderMesh>();
+    wallMesh.m_occluder->Vertices = {{-10.0f, -10.0f, 0.0f}, {10.0f, -10.0f, 0.0f}, {10.0f, 10.0f, 0.0f}, {-10.0f, 10.0f, 0.0f}};
+    wallMesh.m_occluder->Indices = {0, 1, 2, 0, 2, 3};
+
+    aderite::asset::MeshAsset cubeMesh;
+    cubeMesh.m_bounds = cube();
+
+    std::unordered_map<size_t, aderite::rendering::DrawCall> drawCalls;
+    drawCalls[0].Mesh = &wallMesh;
+    drawCalls[0].Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 5.0f)));
+    drawCalls[1].Mesh = &cubeMesh;
+    drawCalls[1].Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 20.0f)));  // Hidden by the wall
+    drawCalls[1].Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -20.0f))); // Behind the camera
+    drawCalls[1].Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 3.0f)));   // In front of the wall
+
+    aderite::rendering::Culler culler;
+    culler.cull(viewProjection(), drawCalls);
+    EXPECT_EQ(culler.getStats().Tested, 4);
+    EXPECT_EQ(culler.getStats().FrustumCulled, 1);
+    EXPECT_EQ(culler.getStats().OcclusionCulled, 0);
+    EXPECT_EQ(culler.getStats().Visible, 3);
+    EXPECT_EQ(culler.getVisible().size(), 2);
+
+    culler.setOcclusionCulling(true);
+    culler.cull(viewProjection(), drawCalls);
+    EXPECT_EQ(culler.getStats().OcclusionCulled, 1);
+    EXPECT_EQ(culler.getStats().Visible, 2);
+    EXPECT_EQ(culler.getTransformations().size(), 2);
+
+    size_t packed = 0;
+    for (const aderite::rendering::VisibleDrawCall& visible : culler.getVisible()) {
+        EXPECT_EQ(visible.First, packed);
+        packed += visible.Count;
+    }
+    EXPECT_EQ(packed, culler.getTransformations().size());
+}
+
+/**
+ * @brief Verifies detail level selection by screen size and that levels only change once a threshold is passed by the
+ * hysteresis margin
+ */
+TEST_F(RenderingTest, Culler_lodSelection) {
+    aderite::asset::MeshAsset cubeMesh;
+    cubeMesh.m_bounds = cube();
+    cubeMesh.m_lodCount = 4;
+    for (uint32_t lod = 0; lod < 4; lod++) {
+        cubeMesh.m_lods[lod] = {0, 3000u >> lod};
+    }
+
+    std::unordered_map<size_t, aderite::rendering::DrawCall> drawCalls;
+    drawCalls[0].Mesh = &cubeMesh;
+    drawCalls[0].Transformations.push_back(glm::mat4(1.0f));
+
+    // The cube covers 3 / distance of the screen height
+    aderite::rendering::Culler culler;
+    auto lodAt = [&culler, &drawCalls](float distance) {
+        drawCalls[0].Transformations[0] = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, distance));
+        culler.cull(viewProjection(), drawCalls);
+        EXPECT_EQ(culler.getVisible().size(), 1);
+        return culler.getVisible()[0].Lod;
+    };
+
+    EXPECT_EQ(lodAt(10.0f), 0);
+    EXPECT_EQ(lodAt(20.0f), 1);
+    EXPECT_EQ(lodAt(40.0f), 2);
+    EXPECT_EQ(lodAt(100.0f), 3);
+    EXPECT_EQ(culler.getStats().Triangles, 125);
+    EXPECT_EQ(culler.getStats().Lods[3], 1);
+
+    // Just past the threshold, inside the margin
+    EXPECT_EQ(lodAt(20.0f), 1);
+    EXPECT_EQ(lodAt(11.5f), 1);
+    EXPECT_EQ(lodAt(10.0f), 0);
+    EXPECT_EQ(lodAt(12.5f), 0);
+    EXPECT_EQ(lodAt(14.0f), 1);
+}
+
+/**
+ * @brief Measures culling of 1k, 10k and 100k instances scattered around the camera, only CPU work is measured so the
+ * result doesn't depend on the bgfx backend
+ */
+TEST_F(RenderingTest, Culler_benchmark) {
+    aderite::asset::MeshAsset cubeMesh;
+    cubeMesh.m_bounds = cube();
+    cubeMesh.m_occluder = std::make_unique<aderite::rendering::OccluderMesh>();
+    cubeMesh.m_occluder->Vertices = {{-1.0f, -1.0f, -1.0f}, {1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, -1.0f}, {-1.0f, 1.0f, -1.0f}};
+    cubeMesh.m_occluder->Indices = {0, 1, 2, 0, 2, 3};
+
+    for (size_t count : {1000, 10000, 100000}) {
+        std::unordered_map<size_t, aderite::rendering::DrawCall> drawCalls;
+        drawCalls[0].Mesh = &cubeMesh;
+
+        // Grid around the camera, most of it is outside of the frustum
+        const size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(count)));
+        for (size_t i = 0; i < count; i++) {
+            const float x = (static_cast<float>(i % side) - side * 0.5f) * 4.0f;
+            const float z = (static_cast<float>(i / side) - side * 0.5f) * 4.0f;
+            drawCalls[0].Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.0f, z)));
+        }
+
+        for (bool occlusion : {false, true}) {
+            aderite::rendering::Culler culler;
+            culler.setOcclusionCulling(occlusion);
+
+            const size_t frames = 10;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < frames; i++) {
+                culler.cull(viewProjection(), drawCalls);
+            }
+            const double cullMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+            const aderite::rendering::CullingStats& stats = culler.getStats();
+            LOG_INFO("[Test] Culling {0} instances (occlusion {1}): {2} ms, frustum culled {3}, occlusion culled {4}, visible {5}",
+                     count, occlusion, cullMs / frames, stats.FrustumCulled, stats.OcclusionCulled, stats.Visible);
+            EXPECT_EQ(stats.Tested, count);
+            EXPECT_EQ(stats.FrustumCulled + stats.OcclusionCulled + stats.Visible, count);
+        }
+    }
+
+}
+
+/**
+ * @brief Verifies that the frame data ring swaps without copying and that steady state frames do no heap allocations
+ */
+TEST_F(RenderingTest, FrameDataRing_steadyState) {
+    aderite::asset::MeshAsset cubeMesh;
+    cubeMesh.m_bounds = cube();
+
+    aderite::rendering::FrameDataRing ring;
+    aderite::rendering::Culler culler;
+
+    auto frame = [&ring, &culler, &cubeMesh]() {
+        aderite::rendering::FrameData& fd = ring.getWrite();
+        for (size_t call = 0; call < 3; call++) {
+            aderite::rendering::DrawCall& dc = fd.DrawCalls[call];
+            dc.Mesh = &cubeMesh;
+            for (size_t i = 0; i < 1000; i++) {
+                dc.Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 10.0f + i)));
+            }
+        }
+
+        aderite::rendering::CameraData cd;
+        cd.Name = "Main";
+        cd.ViewMatrix = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        cd.ProjectionMatrix = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+        fd.Cameras.push_back(cd);
+
+        ring.swap();
+
+        const aderite::rendering::FrameData& read = ring.getRead();
+        for (const aderite::rendering::CameraData& camera : read.Cameras) {
+            culler.cull(camera.ProjectionMatrix * camera.ViewMatrix, read.DrawCalls);
+        }
+    };
+
+    // Warm up every frame of the ring
+    for (size_t i = 0; i < aderite::rendering::FrameDataRing::c_FrameCount * 2; i++) {
+        frame();
+    }
+
+    const aderite::rendering::FrameData* previous = &ring.getRead();
+    const size_t before = g_allocations;
+    const size_t frames = 100;
+    for (size_t i = 0; i < frames; i++) {
+        frame();
+        EXPECT_NE(&ring.getRead(), previous);
+        previous = &ring.getRead();
+    }
+    const size_t allocations = g_allocations - before;
+
+    LOG_INFO("[Test] {0} heap allocations over {1} steady state frames", allocations, frames);
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(ring.getRead().DrawCalls.size(), 3);
+    EXPECT_EQ(ring.getRead().DrawCalls.at(0).Transformations.size(), 1000);
+}
+
+/**
+ * @brief Measures draw call submission of 1k and 4k unique mesh/material pairs spread over 16 material types, on the
+ * main thread and across the job workers
+ */
+TEST_F(RenderingTest, Renderer_submissionBenchmark) {
+    aderite::rendering::Renderer* renderer = aderite::Engine::getRenderer();
+
+    // Every mesh shares the same triangle
+    const float vertices[] = {
+        -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f,
+        0.0f,  1.0f,  0.0f, 0.0f, 0.0f, -1.0f, 0.5f, 1.0f,
+    };
+    const uint16_t indices[] = {0, 1, 2};
+
+    bgfx::VertexLayout layout;
+    layout.begin();
+    layout.add(bgfx::Attrib::Position, 3, bgfx::AttribType::Float);
+    layout.add(bgfx::Attrib::Normal, 3, bgfx::AttribType::Float);
+    layout.add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float);
+    layout.end();
+
+    const bgfx::VertexBufferHandle vbh = bgfx::createVertexBuffer(bgfx::copy(vertices, sizeof(vertices)), layout);
+    const bgfx::IndexBufferHandle ibh = bgfx::createIndexBuffer(bgfx::copy(indices, sizeof(indices)));
+
+    const size_t typeCount = 16;
+    std::vector<std::unique_ptr<aderite::asset::MaterialTypeAsset>> types;
+    for (size_t i = 0; i < typeCount; i++) {
+        types.emplace_back(new aderite::asset::MaterialTypeAsset());
+        types.back()->m_uniformHandle = bgfx::createUniform(("u_benchmark" + std::to_string(i)).c_str(), bgfx::UniformType::Vec4);
+    }
+
+    for (size_t count : {1000, 4000}) {
+        std::vector<std::unique_ptr<aderite::asset::MeshAsset>> meshes;
+        std::vector<std::unique_ptr<aderite::asset::MaterialAsset>> materials;
+        std::unordered_map<size_t, aderite::rendering::DrawCall> drawCalls;
+        for (size_t i = 0; i < count; i++) {
+            meshes.emplace_back(new aderite::asset::MeshAsset());
+            meshes.back()->m_vbh = vbh;
+            meshes.back()->m_ibh = ibh;
+            meshes.back()->m_bounds = cube();
+            meshes.back()->m_loaded = true;
+
+            materials.emplace_back(new aderite::asset::MaterialAsset());
+            materials.back()->m_type = types[i % typeCount].get();
+            materials.back()->m_udata.assign(4, 0.0f);
+
+            aderite::rendering::DrawCall& dc = drawCalls[i];
+            dc.Mesh = meshes.back().get();
+            dc.Material = materials.back().get();
+            dc.Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 10.0f)));
+        }
+
+        renderer->m_culler.cull(viewProjection(), drawCalls);
+        ASSERT_EQ(renderer->m_culler.getVisible().size(), count);
+
+        for (bool multithreaded : {false, true}) {
+            renderer->setMultithreadedSubmission(multithreaded);
+
+            const size_t frames = 10;
+            double submitMs = 0.0;
+            for (size_t i = 0; i < frames; i++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                renderer->submitDrawCalls(0, viewProjection());
+                submitMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+                bgfx::frame();
+            }
+
+            LOG_INFO("[Test] Submitting {0} draw calls (multithreaded {1}): {2} ms", count, multithreaded, submitMs / frames);
+        }
+
+        // Handles and the type are owned by the test
+        for (size_t i = 0; i < count; i++) {
+            meshes[i]->m_vbh = BGFX_INVALID_HANDLE;
+            meshes[i]->m_ibh = BGFX_INVALID_HANDLE;
+            materials[i]->m_type = nullptr;
+        }
+    }
+
+    renderer->setMultithreadedSubmission(true);
+    bgfx::destroy(vbh);
+    bgfx::destroy(ibh);
+}
+
+/**
+ * @brief Verifies that instance sets are uploaded into persistent buffers only after staying unchanged for a few frames
+ */
+TEST_F(RenderingTest, Renderer_persistentInstances) {
+    aderite::rendering::Renderer* renderer = aderite::Engine::getRenderer();
+    aderite::rendering::FrameData& fd = renderer->m_frames.getWrite();
+
+    aderite::rendering::DrawCall& dc = fd.DrawCalls[0];
+    dc.Signature = 42;
+    for (size_t i = 0; i < 1000; i++) {
+        dc.Transformations.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 10.0f + i)));
+    }
+
+    for (uint32_t i = 0; i < aderite::rendering::Renderer::c_StaticFrames; i++) {
+        EXPECT_FALSE(renderer->m_persistentInstances[42].Uploaded);
+        renderer->updatePersistentInstances();
+    }
+
+    const auto& persistent = renderer->m_persistentInstances.at(42);
+    EXPECT_TRUE(persistent.Uploaded);
+    EXPECT_TRUE(bgfx::isValid(persistent.Buffer));
+    EXPECT_EQ(persistent.Capacity, 1000);
+
+    // A moved instance invalidates the upload
+    dc.Static = false;
+    renderer->updatePersistentInstances();
+    EXPECT_FALSE(renderer->m_persistentInstances.at(42).Uploaded);
+
+    fd.DrawCalls.clear();
+}
+
+/**
+ * @brief Verifies that static meshes are merged per material into world space batches
+ */
+TEST_F(RenderingTest, StaticBatcher_merge) {
+    // Single triangle with a +z normal
+    const std::vector<float> vertices = {
+        -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+        0.0f,  1.0f,  0.0f, 0.0f, 0.0f, 1.0f, 0.5f, 1.0f,
+    };
+    std::vector<unsigned char> cooked;
+    aderite::io::MeshCooker::cook(vertices, {0, 1, 2}, cooked);
+    aderite::io::MeshCooker::View view;
+    ASSERT_TRUE(aderite::io::MeshCooker::read(cooked.data(), cooked.size(), view));
+
+    aderite::asset::MaterialAsset first;
+    first.m_handle = 1;
+    aderite::asset::MaterialAsset second;
+    second.m_handle = 2;
+
+    aderite::rendering::StaticBatcher batcher;
+    for (size_t i = 0; i < 3; i++) {
+        batcher.add(&first, view, glm::translate(glm::mat4(1.0f), glm::vec3(10.0f * i, 0.0f, 0.0f)));
+    }
+    batcher.add(&second, view, glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)));
+    batcher.finish();
+
+    const std::vector<aderite::rendering::StaticBatch>& batches = batcher.getBatches();
+    ASSERT_EQ(batches.size(), 2);
+    EXPECT_EQ(batches[0].Material, &first);
+    EXPECT_EQ(batches[0].Objects, 3);
+    EXPECT_EQ(batches[1].Objects, 1);
+    EXPECT_NE(batches[0].Key, batches[1].Key);
+    EXPECT_NE(batches[0].Signature, batches[1].Signature);
+
+    // Bounds cover the merged geometry in world space
+    const aderite::rendering::Bounds& bounds = batches[0].Mesh->getBounds();
+    EXPECT_FLOAT_EQ(bounds.Center.x - bounds.Extents.x, -1.0f);
+    EXPECT_FLOAT_EQ(bounds.Center.x + bounds.Extents.x, 21.0f);
+    EXPECT_FLOAT_EQ(batches[1].Mesh->getBounds().Extents.y, 2.0f);
+
+    // Every batch is a single draw call with an identity transformation
+    aderite::rendering::FrameData fd;
+    batcher.update(fd);
+    ASSERT_EQ(fd.DrawCalls.size(), 2);
+    for (const auto& kvp : fd.DrawCalls) {
+        ASSERT_EQ(kvp.second.Transformations.size(), 1);
+        EXPECT_EQ(kvp.second.Transformations[0], glm::mat4(1.0f));
+        EXPECT_TRUE(kvp.second.Static);
+    }
+
+    batcher.clear();
+    EXPECT_FALSE(batcher.isBuilt());
+}
+
+/**
+ * @brief Verifies that an invalidated batch stays alive while frames that are still rendered reference it
+ */
+TEST_F(RenderingTest, StaticBatcher_invalidate) {
+    const std::vector<float> vertices = {
+        -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+        0.0f,  1.0f,  0.0f, 0.0f, 0.0f, 1.0f, 0.5f, 1.0f,
+    };
+    std::vector<unsigned char> cooked;
+    aderite::io::MeshCooker::cook(vertices, {0, 1, 2}, cooked);
+    aderite::io::MeshCooker::View view;
+    ASSERT_TRUE(aderite::io::MeshCooker::read(cooked.data(), cooked.size(), view));
+
+    aderite::asset::MaterialAsset first;
+    first.m_handle = 1;
+    aderite::asset::MaterialAsset second;
+    second.m_handle = 2;
+
+    aderite::rendering::StaticBatcher batcher;
+    batcher.add(&first, view, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 10.0f)));
+    batcher.add(&second, view, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 20.0f)));
+    batcher.finish();
+    batcher.m_built = true;
+    const aderite::asset::MeshAsset* mesh = batcher.getBatches()[0].Mesh.get();
+
+    // One frame is published and the next one is being written when the material changes
+    aderite::rendering::Culler& culler = aderite::Engine::getRenderer()->m_culler;
+    aderite::rendering::FrameDataRing ring;
+    batcher.update(ring.getWrite());
+    ring.swap();
+    batcher.update(ring.getWrite());
+
+    aderite::scene::ComponentRegistry components;
+    batcher.invalidate(components, &first);
+    ASSERT_EQ(batcher.getBatches().size(), 1);
+    ASSERT_EQ(batcher.m_retired.size(), 1);
+    EXPECT_EQ(batcher.m_retired[0].Batch.Mesh.get(), mesh);
+    EXPECT_EQ(first.m_refCount, 1);
+
+    auto referenced = [&ring, mesh]() {
+        for (const aderite::rendering::FrameData& frame : ring.m_frames) {
+            for (const auto& kvp : frame.DrawCalls) {
+                if (kvp.second.Mesh == mesh && !kvp.second.Transformations.empty()) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    };
+
+    // Every frame the renderer reads is culled, the retired mesh is only destroyed once none of them draws it
+    for (uint32_t i = 0; i < aderite::rendering::FrameDataRing::c_FrameCount; i++) {
+        ring.swap();
+        batcher.update(ring.getWrite());
+        EXPECT_TRUE(!referenced() || !batcher.m_retired.empty());
+        culler.cull(viewProjection(), ring.getRead().DrawCalls);
+    }
+
+    EXPECT_TRUE(batcher.m_retired.empty());
+    EXPECT_FALSE(referenced());
+    EXPECT_EQ(first.m_refCount, 0);
+    EXPECT_EQ(culler.getVisible().size(), 1);
+
+    batcher.clear();
+}
+
+/**
+ * @brief Verifies render queue key ordering and that the radix sort matches a comparison sort
+ */
+TEST_F(RenderingTest, RenderQueue_sort) {
+    using aderite::rendering::RenderQueue;
+
+    // Opaque front to back within the same state, state before depth, opaque before transparent
+    EXPECT_LT(RenderQueue::makeKey(0, false, 1, 1, 1, 1.0f), RenderQueue::makeKey(0, false, 1, 1, 1, 2.0f));
+    EXPECT_LT(RenderQueue::makeKey(0, false, 1, 1, 1, 100.0f), RenderQueue::makeKey(0, false, 2, 1, 1, 1.0f));
+    EXPECT_LT(RenderQueue::makeKey(0, false, 100, 1, 1, 1.0f), RenderQueue::makeKey(0, true, 1, 1, 1, 1.0f));
+
+    // Transparent back to front regardless of state
+    EXPECT_LT(RenderQueue::makeKey(0, true, 2, 1, 1, 2.0f), RenderQueue::makeKey(0, true, 1, 1, 1, 1.0f));
+
+    RenderQueue queue;
+    std::vector<uint64_t> keys;
+    for (uint32_t i = 0; i < 10000; i++) {
+        const float depth = static_cast<float>((i * 7919) % 1000);
+        const uint64_t key = RenderQueue::makeKey(0, i % 7 == 0, (i * 31) % 40, (i * 17) % 300, (i * 13) % 1000, depth);
+        keys.push_back(key);
+        queue.push(key, i);
+    }
+
+    queue.sort();
+    std::sort(keys.begin(), keys.end());
+    ASSERT_EQ(queue.getItems().size(), keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        EXPECT_EQ(queue.getItems()[i].Key, keys[i]);
+    }
+}
+
+/**
+ * @brief Verifies render graph pass culling, view assignment and that cameras share pooled targets
+ */
+TEST_F(RenderingTest, RenderGraph_compile) {
+    using aderite::rendering::RenderGraph;
+
+    const RenderGraph::TextureDesc colorDesc = {bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_RT};
+    const RenderGraph::TextureDesc depthDesc = {bgfx::TextureFormat::D24S8, BGFX_TEXTURE_RT_WRITE_ONLY};
+    const bgfx::TextureHandle outputs[2] = {{1}, {2}};
+
+    RenderGraph graph;
+    std::vector<bgfx::ViewId> executed;
+    for (size_t frame = 0; frame < 3; frame++) {
+        graph.reset();
+        executed.clear();
+        for (size_t camera = 0; camera < 2; camera++) {
+            const std::string name = "Camera" + std::to_string(camera);
+            const RenderGraph::Resource output = graph.import(name + " output", outputs[camera]);
+
+            RenderGraph::PassBuilder objects = graph.addPass(name + " objects", [&executed](bgfx::ViewId view) {
+                executed.push_back(view);
+            });
+            const RenderGraph::Resource color = objects.create("Color", colorDesc);
+            objects.attach(color);
+            objects.attach(objects.create("Depth", depthDesc));
+
+            // Nothing reads the debug target
+            RenderGraph::PassBuilder debug = graph.addPass(name + " debug", [&executed](bgfx::ViewId view) {
+                executed.push_back(view);
+            });
+            debug.read(color);
+            debug.attach(debug.create("Debug", colorDesc));
+
+            RenderGraph::PassBuilder copy = graph.addPass(name + " copy", [&executed](bgfx::ViewId view) {
+                executed.push_back(view);
+            });
+            copy.read(color);
+            copy.write(output);
+        }
+
+        graph.compile();
+        graph.execute();
+        bgfx::frame();
+
+        EXPECT_EQ(graph.getStats().Passes, 6);
+        EXPECT_EQ(graph.getStats().CulledPasses, 2);
+        EXPECT_EQ(graph.getStats().Transients, 4);
+        EXPECT_TRUE(graph.isCulled("Camera0 debug"));
+        EXPECT_FALSE(graph.isCulled("Camera1 copy"));
+
+        // Views are sequential over the kept passes
+        EXPECT_EQ(executed, std::vector<bgfx::ViewId>({0, 1, 2, 3}));
+
+        // The second camera aliases the targets of the first one, frames reuse the pool
+        EXPECT_EQ(graph.getStats().PooledTargets, 2);
+        EXPECT_EQ(graph.getTexture(1).idx, graph.getTexture(5).idx);
+        EXPECT_EQ(graph.getTexture(2).idx, graph.getTexture(6).idx);
+        EXPECT_FALSE(bgfx::isValid(graph.getTexture(3)));
+    }
+
+    graph.shutdown();
+    EXPECT_TRUE(graph.m_pool.empty());
+    EXPECT_TRUE(graph.m_framebuffers.empty());
+}
+
+/**
+ * @brief Verifies that a camera with a depth prepass renders both passes into the same targets
+ */
+TEST_F(RenderingTest, Renderer_depthPrepass) {
+    aderite::rendering::Renderer* renderer = aderite::Engine::getRenderer();
+    aderite::rendering::FrameData frame;
+    const bgfx::TextureHandle output =
+        bgfx::createTexture2D(bgfx::BackbufferRatio::Equal, false, 1, bgfx::TextureFormat::BGRA8, BGFX_TEXTURE_BLIT_DST);
+
+    aderite::rendering::CameraData& prepassed = frame.Cameras.emplace_back();
+    prepassed.Name = "Prepassed";
+    prepassed.Output = output;
+    prepassed.DepthPrepass = true;
+
+    aderite::rendering::CameraData& plain = frame.Cameras.emplace_back();
+    plain.Name = "Plain";
+    plain.Output = output;
+
+    renderer->m_graph.reset();
+    for (const aderite::rendering::CameraData& cd : frame.Cameras) {
+        renderer->addCameraPasses(frame, cd);
+    }
+    renderer->m_graph.compile();
+
+    const auto& passes = renderer->m_graph.m_passes;
+    ASSERT_EQ(passes.size(), 5);
+    EXPECT_EQ(renderer->m_graph.getStats().CulledPasses, 0);
+    EXPECT_EQ(renderer->m_graph.getStats().Transients, 4);
+
+    // Prepass clears, the object pass continues on the same framebuffer
+    EXPECT_EQ(passes[0].Name, "Prepassed - Depth prepass");
+    EXPECT_EQ(passes[0].Framebuffer.idx, passes[1].Framebuffer.idx);
+    EXPECT_NE(passes[0].ClearFlags, BGFX_CLEAR_NONE);
+    EXPECT_EQ(passes[1].ClearFlags, BGFX_CLEAR_NONE);
+    EXPECT_NE(passes[3].ClearFlags, BGFX_CLEAR_NONE);
+
+    // The second camera reuses the targets of the first one
+    EXPECT_EQ(passes[3].Framebuffer.idx, passes[0].Framebuffer.idx);
+
+    renderer->m_graph.reset();
+    bgfx::destroy(output);
+}
+
+/**
+ * @brief Verifies that material buffer rows are kept per material and only staged when the properties change
+ */
+TEST_F(RenderingTest, MaterialBuffer_resolve) {
+    using aderite::rendering::MaterialBuffer;
+
+    MaterialBuffer buffer;
+    buffer.init();
+
+    aderite::asset::MaterialTypeAsset type;
+    type.setSize(2);
+    type.setMaterialBuffer(true);
+
+    aderite::asset::MaterialAsset first;
+    first.m_handle = 1;
+    first.m_type = &type;
+    first.m_udata.assign(8, 1.0f);
+
+    aderite::asset::MaterialAsset second;
+    second.m_handle = 2;
+    second.m_type = &type;
+    second.m_udata.assign(8, 2.0f);
+
+    // New materials get the lowest free rows and are always staged
+    EXPECT_EQ(buffer.resolve(&first), 0);
+    EXPECT_EQ(buffer.resolve(&second), 1);
+    EXPECT_EQ(buffer.m_dirtyFirst, 0);
+    EXPECT_EQ(buffer.m_dirtyLast, 1);
+    EXPECT_EQ(buffer.m_staging[MaterialBuffer::c_SlotWidth], glm::vec4(2.0f));
+    buffer.upload();
+
+    // Unchanged properties are not staged again
+    EXPECT_EQ(buffer.resolve(&first), 0);
+    EXPECT_GT(buffer.m_dirtyFirst, buffer.m_dirtyLast);
+
+    second.m_udata[4] = 3.0f;
+    EXPECT_EQ(buffer.resolve(&second), 1);
+    EXPECT_EQ(buffer.m_dirtyFirst, 1);
+    EXPECT_EQ(buffer.m_dirtyLast, 1);
+    EXPECT_EQ(buffer.getSlot(&second), 1);
+
+    // Types without the buffer keep using uniforms
+    type.setMaterialBuffer(false);
+    EXPECT_EQ(buffer.resolve(&first), MaterialBuffer::c_InvalidSlot);
+    type.setMaterialBuffer(true);
+
+    // Rows of materials that aren't drawn anymore are freed
+    for (uint64_t i = 0; i <= MaterialBuffer::c_SlotFrames; i++) {
+        buffer.resolve(&first);
+        buffer.upload();
+    }
+    EXPECT_EQ(buffer.getSlot(&first), 0);
+    EXPECT_EQ(buffer.getSlot(&second), MaterialBuffer::c_InvalidSlot);
+
+    // Owned by the test
+    first.m_type = nullptr;
+    second.m_type = nullptr;
+    buffer.shutdown();
+}
+
+/**
+ * @brief Verifies that a full material buffer reuses the least recently used row and only grows if every row is drawn
+ */
+TEST_F(RenderingTest, MaterialBuffer_full) {
+    using aderite::rendering::MaterialBuffer;
+
+    MaterialBuffer buffer;
+    buffer.init();
+
+    aderite::asset::MaterialTypeAsset type;
+    type.setSize(1);
+    type.setMaterialBuffer(true);
+
+    std::vector<std::unique_ptr<aderite::asset::MaterialAsset>> materials;
+    for (size_t i = 0; i < MaterialBuffer::c_InitialMaterials + 2; i++) {
+        aderite::asset::MaterialAsset* material = materials.emplace_back(new aderite::asset::MaterialAsset()).get();
+        material->m_handle = i;
+        material->m_type = &type;
+        material->m_udata.assign(4, static_cast<float>(i));
+    }
+
+    for (size_t i = 0; i < MaterialBuffer::c_InitialMaterials; i++) {
+        EXPECT_EQ(buffer.resolve(materials[i].get()), i);
+    }
+    buffer.upload();
+
+    // Every material but the fifth is drawn again, the next one takes its row
+    for (size_t i = 0; i < MaterialBuffer::c_InitialMaterials; i++) {
+        if (i != 5) {
+            buffer.resolve(materials[i].get());
+        }
+    }
+    buffer.upload();
+
+    const size_t next = MaterialBuffer::c_InitialMaterials;
+    EXPECT_EQ(buffer.resolve(materials[next].get()), 5);
+    EXPECT_EQ(buffer.getSlot(materials[5].get()), MaterialBuffer::c_InvalidSlot);
+    EXPECT_EQ(buffer.m_staging[5 * MaterialBuffer::c_SlotWidth], glm::vec4(static_cast<float>(next)));
+
+    // Every row is drawn this frame, the buffer grows and keeps the rows
+    for (size_t i = 0; i < MaterialBuffer::c_InitialMaterials; i++) {
+        if (i != 5) {
+            buffer.resolve(materials[i].get());
+        }
+    }
+
+    EXPECT_EQ(buffer.resolve(materials[next + 1].get()), MaterialBuffer::c_InitialMaterials);
+    EXPECT_EQ(buffer.m_rows, MaterialBuffer::c_InitialMaterials * 2);
+    EXPECT_EQ(buffer.m_dirtyFirst, 0);
+    EXPECT_EQ(buffer.getSlot(materials[next].get()), 5);
+    EXPECT_EQ(buffer.m_staging[MaterialBuffer::c_SlotWidth], glm::vec4(1.0f));
+    buffer.upload();
+
+    // Owned by the test
+    for (const auto& material : materials) {
+        material->m_type = nullptr;
+    }
+    buffer.shutdown();
+}
@@ -1,15 +1,29 @@
+#include <chrono>
+#include <cmath>
+#include <vector>
+
 #include <aderite/Aderite.hpp>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <PxPhysicsAPI.h>
+#include <physx/PxRigidDynamic.h>
+#include <physx/PxScene.h>
 
 #define private public
 #define protected public
 
+#include <aderite/physics/JobDispatcher.hpp>
+#include <aderite/physics/PhysXActor.hpp>
+#include <aderite/physics/PhysicsController.hpp>
+#include <aderite/physics/geometry/BoxGeometry.hpp>
 #include <aderite/scene/CameraSettings.hpp>
+#include <aderite/scene/ComponentStorage.hpp>
 #include <aderite/scene/GameObject.hpp>
 #include <aderite/scene/Scene.hpp>
 #include <aderite/scene/SceneManager.hpp>
 #include <aderite/scene/TransformProvider.hpp>
+#include <aderite/threading/JobSystem.hpp>
+#include <aderite/utility/Log.hpp>
 
 #define private private
 #define protected protected
@@ -270,3 +284,582 @@ TEST_F(SceneTest, TransformProvider_modify) {
     transform.resetModifiedFlag();
     EXPECT_FALSE(transform.wasModified());
 }
+
+/**
+ * @brief Verifies that world space poses are read and written through the parent transform
+ */
+TEST_F(SceneTest, TransformProvider_worldPose) {
+    aderite::scene::TransformProvider parent;
+    aderite::scene::TransformProvider child;
+    child.setParent(&parent);
+
+    parent.setPosition(glm::vec3(10.0f, 0.0f, 0.0f));
+    parent.setRotation(glm::angleAxis(glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f)));
+    child.setPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+
+    // Local +X of the parent is world -Z
+    const glm::vec3 position = child.getWorldPosition();
+    EXPECT_NEAR(position.x, 10.0f, 1e-5f);
+    EXPECT_NEAR(position.z, -1.0f, 1e-5f);
+
+    // Writing a world pose back stores it relative to the parent
+    const glm::quat rotation = glm::angleAxis(glm::radians(45.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    child.setWorldPose(glm::vec3(10.0f, 5.0f, 0.0f), rotation);
+    EXPECT_NEAR(child.getPosition().x, 0.0f, 1e-5f);
+    EXPECT_NEAR(child.getPosition().y, 5.0f, 1e-5f);
+    EXPECT_NEAR(glm::length(child.getWorldPosition() - glm::vec3(10.0f, 5.0f, 0.0f)), 0.0f, 1e-5f);
+    EXPECT_NEAR(std::abs(glm::dot(child.getWorldRotation(), rotation)), 1.0f, 1e-5f);
+}
+
+/**
+ * @brief Verifies that the world matrix of a child is the parent world matrix times the child local matrix
+ */
+TEST_F(SceneTest, TransformProvider_hierarchy) {
+    aderite::scene::TransformProvider parent;
+    aderite::scene::TransformProvider child;
+    child.setParent(&parent);
+    EXPECT_EQ(child.getParent(), &parent);
+    EXPECT_EQ(parent.getChildren().size(), 1);
+
+    parent.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    parent.setScale(glm::vec3(2.0f));
+    child.setPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+
+    const glm::vec4 origin = child.getWorldMatrix() * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(origin.x, 3.0f);
+    EXPECT_FLOAT_EQ(origin.y, 2.0f);
+    EXPECT_FLOAT_EQ(origin.z, 3.0f);
+
+    const glm::mat4 expected = parent.getWorldMatrix() * child.getLocalMatrix();
+    const glm::mat4 world = child.getWorldMatrix();
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            EXPECT_FLOAT_EQ(world[i][j], expected[i][j]);
+        }
+    }
+
+    child.setParent(nullptr);
+    EXPECT_EQ(parent.getChildren().size(), 0);
+    EXPECT_FLOAT_EQ(child.getWorldMatrix()[3][0], 1.0f);
+}
+
+/**
+ * @brief Verifies that modifying a parent marks the whole subtree dirty and that unmodified transforms stay clean
+ */
+TEST_F(SceneTest, TransformProvider_dirtyPropagation) {
+    aderite::scene::TransformProvider root;
+    aderite::scene::TransformProvider child;
+    aderite::scene::TransformProvider grandChild;
+    aderite::scene::TransformProvider other;
+    child.setParent(&root);
+    grandChild.setParent(&child);
+
+    root.updateWorldMatrix();
+    child.updateWorldMatrix();
+    grandChild.updateWorldMatrix();
+    other.updateWorldMatrix();
+    EXPECT_FALSE(grandChild.isDirty());
+    EXPECT_FALSE(other.isDirty());
+
+    root.setPosition(glm::vec3(0.0f, 5.0f, 0.0f));
+    EXPECT_TRUE(root.isDirty());
+    EXPECT_TRUE(child.isDirty());
+    EXPECT_TRUE(grandChild.isDirty());
+    EXPECT_FALSE(other.isDirty());
+
+    EXPECT_FLOAT_EQ(grandChild.getWorldMatrix()[3][1], 5.0f);
+    EXPECT_FALSE(grandChild.isDirty());
+    EXPECT_FALSE(child.isDirty());
+}
+
+/**
+ * @brief Verifies that destroying a parent orphans its children
+ */
+TEST_F(SceneTest, TransformProvider_orphan) {
+    aderite::scene::TransformProvider child;
+    {
+        aderite::scene::TransformProvider parent;
+        parent.setPosition(glm::vec3(10.0f, 0.0f, 0.0f));
+        child.setParent(&parent);
+        EXPECT_FLOAT_EQ(child.getWorldMatrix()[3][0], 10.0f);
+    }
+
+    EXPECT_EQ(child.getParent(), nullptr);
+    EXPECT_FLOAT_EQ(child.getWorldMatrix()[3][0], 0.0f);
+}
+
+/**
+ * @brief Verifies component storage membership, hole reuse and pointer stability
+ */
+TEST_F(SceneTest, ComponentStorage_sparseSet) {
+    aderite::scene::ComponentStorage<aderite::scene::TransformProvider> storage;
+
+    std::vector<aderite::scene::TransformProvider*> components;
+    for (aderite::scene::Entity entity = 0; entity < 1000; entity++) {
+        components.push_back(storage.emplace(entity));
+    }
+
+    EXPECT_EQ(storage.size(), 1000);
+    EXPECT_EQ(storage.get(500), components[500]);
+    EXPECT_EQ(storage.get(1000), nullptr);
+
+    // Removing doesn't move other components
+    storage.remove(10);
+    EXPECT_FALSE(storage.has(10));
+    EXPECT_EQ(storage.get(999), components[999]);
+
+    // Holes are reused
+    EXPECT_EQ(storage.emplace(2000), components[10]);
+    EXPECT_EQ(storage.size(), 1000);
+
+    size_t visited = 0;
+    storage.each([&visited](aderite::scene::Entity entity, aderite::scene::TransformProvider& transform) {
+        visited++;
+    });
+    EXPECT_EQ(visited, 1000);
+}
+
+/**
+ * @brief Verifies that game objects of a scene share the scene component registry
+ */
+TEST_F(SceneTest, Scene_componentRegistry) {
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+
+    aderite::scene::GameObject* first = scene->createGameObject();
+    aderite::scene::GameObject* second = scene->createGameObject();
+    first->addRenderable();
+    second->addTransform();
+
+    EXPECT_NE(first->getEntity(), second->getEntity());
+    EXPECT_EQ(scene->getComponents().getTransforms().size(), 2);
+    EXPECT_EQ(scene->getComponents().getRenderables().size(), 1);
+
+    scene->destroyGameObject(first);
+    EXPECT_EQ(scene->getComponents().getTransforms().size(), 1);
+    EXPECT_EQ(scene->getComponents().getRenderables().size(), 0);
+    EXPECT_EQ(scene->getComponents().getEntityCount(), 1);
+
+    delete scene;
+}
+
+/**
+ * @brief Measures scene update with 1k, 10k and 100k game objects that have a transform and a renderable
+ */
+TEST_F(SceneTest, Scene_updateBenchmark) {
+    for (size_t count : {1000, 10000, 100000}) {
+        aderite::scene::Scene* scene = new aderite::scene::Scene();
+        for (size_t i = 0; i < count; i++) {
+            // Skip the name uniqueness check of createGameObject
+            aderite::scene::GameObject* go = new aderite::scene::GameObject(scene, "Object " + std::to_string(i));
+            go->addRenderable();
+            scene->m_gameObjects.emplace_back(go);
+        }
+
+        const size_t frames = 10;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < frames; i++) {
+            scene->update(0.016f);
+        }
+        const double updateMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LOG_INFO("[Test] Scene update with {0} objects: {1} ms per frame", count, updateMs / frames);
+        EXPECT_EQ(scene->getComponents().getRenderables().size(), count);
+        delete scene;
+    }
+}
+
+/**
+ * @brief Measures world matrix updates for 1k, 10k and 100k transforms in chains of 4 where only the roots move
+ */
+TEST_F(SceneTest, TransformProvider_worldMatrixBenchmark) {
+    for (size_t count : {1000, 10000, 100000}) {
+        aderite::scene::ComponentStorage<aderite::scene::TransformProvider> storage;
+        std::vector<aderite::scene::TransformProvider*> roots;
+        for (size_t i = 0; i < count; i++) {
+            aderite::scene::TransformProvider* transform = storage.emplace(static_cast<aderite::scene::Entity>(i));
+            transform->setPosition(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+            if (i % 4 == 0) {
+                roots.push_back(transform);
+            } else {
+                transform->setParent(storage.get(static_cast<aderite::scene::Entity>(i - 1)));
+            }
+        }
+
+        const size_t frames = 10;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < frames; i++) {
+            // A quarter of the roots move every frame
+            for (size_t j = i % 4; j < roots.size(); j += 4) {
+                roots[j]->setRotation(glm::quat(glm::vec3(0.0f, 0.01f * i, 0.0f)));
+            }
+
+            storage.each([](aderite::scene::Entity entity, aderite::scene::TransformProvider& transform) {
+                transform.updateWorldMatrix();
+            });
+        }
+        const double updateMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LOG_INFO("[Test] World matrix update with {0} transforms: {1} ms per frame", count, updateMs / frames);
+    }
+}
+
+/**
+ * @brief Verifies that physics catches up with several fixed steps per update and that the steps are clamped
+ */
+TEST_F(SceneTest, PhysicsController_substeps) {
+    using aderite::physics::PhysicsController;
+
+    PhysicsController* physics = aderite::Engine::getPhysicsController();
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    aderite::Engine::getSceneManager()->setActive(scene);
+    physics->m_accumulator = 0.0f;
+
+    // The last step keeps running until fetched, the remainder is the interpolation factor
+    physics->update(PhysicsController::c_FixedUpdateWindow * 2.5f);
+    EXPECT_EQ(physics->getTimings().Steps, 2);
+    EXPECT_TRUE(scene->isSimulating());
+    EXPECT_NEAR(physics->getInterpolation(), 0.5f, 0.001f);
+
+    physics->fetchResults();
+    EXPECT_FALSE(scene->isSimulating());
+
+    // A long frame only runs up to the clamp
+    physics->update(1.0f);
+    EXPECT_EQ(physics->getTimings().Steps, PhysicsController::c_MaxSubsteps);
+    physics->fetchResults();
+
+    // Synchronous steps are done before update returns
+    physics->setAsync(false);
+    physics->update(PhysicsController::c_FixedUpdateWindow);
+    EXPECT_FALSE(scene->isSimulating());
+    physics->setAsync(true);
+}
+
+/**
+ * @brief Measures frames with 1k falling boxes where the physics step is synchronous and where it overlaps with 2 ms of
+ * other frame work
+ */
+TEST_F(SceneTest, PhysicsController_asyncBenchmark) {
+    using aderite::physics::PhysicsController;
+
+    PhysicsController* physics = aderite::Engine::getPhysicsController();
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    aderite::Engine::getSceneManager()->setActive(scene);
+
+    for (size_t i = 0; i < 1000; i++) {
+        aderite::scene::GameObject* go = new aderite::scene::GameObject(scene, "Box " + std::to_string(i));
+        go->addTransform()->setPosition(glm::vec3(static_cast<float>(i % 10) * 2.0f, 1.0f + static_cast<float>(i / 100) * 2.0f,
+                                                  static_cast<float>((i / 10) % 10) * 2.0f));
+        aderite::physics::PhysXActor* actor = go->addActor();
+        actor->getData().makeDynamic();
+        actor->getData().enableGravity();
+        actor->getData().addGeometry(new aderite::physics::BoxGeometry());
+        scene->m_gameObjects.emplace_back(go);
+    }
+
+    // Actors are created by the first update
+    const aderite::Engine::CurrentState state = aderite::Engine::get()->getState();
+    aderite::Engine::get()->setState(aderite::Engine::CurrentState::FULL);
+    scene->update(PhysicsController::c_FixedUpdateWindow);
+
+    for (bool async : {false, true}) {
+        physics->setAsync(async);
+
+        const size_t frames = 60;
+        double frameMs = 0.0;
+        double waitMs = 0.0;
+        for (size_t i = 0; i < frames; i++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            physics->update(PhysicsController::c_FixedUpdateWindow);
+
+            // Stand in for game logic and rendering preparation
+            while (std::chrono::high_resolution_clock::now() - start < std::chrono::milliseconds(2)) {
+            }
+
+            scene->update(PhysicsController::c_FixedUpdateWindow);
+            frameMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            waitMs += physics->getTimings().WaitMs;
+        }
+
+        LOG_INFO("[Test] Physics with 1000 actors (async {0}): {1} ms per frame, {2} ms waiting for the simulation", async,
+                 frameMs / frames, waitMs / frames);
+    }
+
+    aderite::Engine::get()->setState(state);
+}
+
+/**
+ * @brief Measures actor sync with 10k rigid bodies of which only 1% are awake, sleeping bodies aren't reported as active
+ * and aren't synced
+ */
+TEST_F(SceneTest, PhysXActor_syncBenchmark) {
+    using aderite::physics::PhysicsController;
+
+    PhysicsController* physics = aderite::Engine::getPhysicsController();
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    aderite::Engine::getSceneManager()->setActive(scene);
+
+    const size_t count = 10000;
+    std::vector<aderite::physics::PhysXActor*> actors;
+    for (size_t i = 0; i < count; i++) {
+        aderite::scene::GameObject* go = new aderite::scene::GameObject(scene, "Body " + std::to_string(i));
+        aderite::physics::PhysXActor* actor = go->addActor();
+        actor->getData().makeDynamic();
+        actor->getData().addGeometry(new aderite::physics::BoxGeometry());
+
+        // Awake bodies fall in their own columns away from the sleeping grid
+        if (i % 100 == 0) {
+            actor->getData().enableGravity();
+            go->addTransform()->setPosition(glm::vec3(-10.0f - static_cast<float>(i), 0.0f, 0.0f));
+        } else {
+            go->addTransform()->setPosition(glm::vec3(static_cast<float>(i % 100) * 2.0f, 0.0f, static_cast<float>(i / 100) * 2.0f));
+        }
+
+        actors.push_back(actor);
+        scene->m_gameObjects.emplace_back(go);
+    }
+
+    // Actors are created by the first update
+    const aderite::Engine::CurrentState state = aderite::Engine::get()->getState();
+    aderite::Engine::get()->setState(aderite::Engine::CurrentState::FULL);
+    scene->update(PhysicsController::c_FixedUpdateWindow);
+
+    for (aderite::physics::PhysXActor* actor : actors) {
+        if (!actor->getData().hasGravity()) {
+            static_cast<physx::PxRigidDynamic*>(actor->getActor())->putToSleep();
+        }
+    }
+
+    const size_t frames = 60;
+    double syncMs = 0.0;
+    for (size_t i = 0; i < frames; i++) {
+        physics->update(PhysicsController::c_FixedUpdateWindow);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        scene->update(PhysicsController::c_FixedUpdateWindow);
+        syncMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    physx::PxU32 active = 0;
+    scene->m_scene->getActiveActors(active);
+    EXPECT_EQ(active, count / 100);
+
+    LOG_INFO("[Test] Scene update with {0} rigid bodies, {1} awake: {2} ms per frame", count, active, syncMs / frames);
+    aderite::Engine::get()->setState(state);
+}
+
+/**
+ * @brief Measures simulation of a collapsing pile of 5k boxes with the job dispatcher at 1, 2, 4 and 8 workers
+ */
+TEST_F(SceneTest, JobDispatcher_scalingBenchmark) {
+    physx::PxPhysics* physics = aderite::Engine::getPhysicsController()->getPhysics();
+    physx::PxMaterial* material = aderite::Engine::getPhysicsController()->getDefaultMaterial();
+
+    for (size_t workers : {1, 2, 4, 8}) {
+        aderite::threading::JobSystem jobSystem(workers);
+        aderite::physics::JobDispatcher dispatcher(&jobSystem);
+
+        physx::PxSceneDesc desc(physics->getTolerancesScale());
+        desc.gravity = physx::PxVec3(0.0f, -9.81f, 0.0f);
+        desc.cpuDispatcher = &dispatcher;
+        desc.filterShader = physx::PxDefaultSimulationFilterShader;
+        physx::PxScene* scene = physics->createScene(desc);
+
+        // 100 columns of 50 boxes on a plane
+        std::vector<physx::PxRigidActor*> actors;
+        actors.push_back(physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material));
+        for (size_t i = 0; i < 5000; i++) {
+            const physx::PxVec3 position(static_cast<float>(i % 10) * 1.1f, 0.5f + static_cast<float>(i / 100) * 1.05f,
+                                         static_cast<float>((i / 10) % 10) * 1.1f);
+            actors.push_back(
+                physx::PxCreateDynamic(*physics, physx::PxTransform(position), physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, 1.0f));
+        }
+
+        for (physx::PxRigidActor* actor : actors) {
+            scene->addActor(*actor);
+        }
+
+        const size_t steps = 60;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < steps; i++) {
+            scene->simulate(0.02f);
+            scene->fetchResults(true);
+        }
+        const double stepMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LOG_INFO("[Test] Simulating a pile of 5000 boxes with {0} workers: {1} ms per step", workers, stepMs / steps);
+
+        scene->release();
+        for (physx::PxRigidActor* actor : actors) {
+            actor->release();
+        }
+    }
+}
+
+/**
+ * @brief Verifies batched raycasts, sweeps and overlaps and compares batched raycasts with single raycasts
+ */
+TEST_F(SceneTest, PhysicsScene_queryBatch) {
+    using aderite::physics::PhysicsController;
+
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    aderite::Engine::getSceneManager()->setActive(scene);
+
+    // Two boxes in front of the origin and one to the side, boxes are 2 units wide
+    for (const glm::vec3& position : {glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(10.0f, 0.0f, 5.0f)}) {
+        aderite::scene::GameObject* go = new aderite::scene::GameObject(scene, "Box");
+        go->addTransform()->setPosition(position);
+        go->addActor()->getData().addGeometry(new aderite::physics::BoxGeometry());
+        scene->m_gameObjects.emplace_back(go);
+    }
+
+    const aderite::Engine::CurrentState state = aderite::Engine::get()->getState();
+    aderite::Engine::get()->setState(aderite::Engine::CurrentState::FULL);
+    scene->update(PhysicsController::c_FixedUpdateWindow);
+    aderite::Engine::get()->setState(state);
+
+    aderite::physics::QueryResults results;
+
+    // Every hit along the ray sorted by distance
+    std::vector<aderite::physics::RaycastQuery> rays(3);
+    rays[0].Direction = glm::vec3(0.0f, 0.0f, 1.0f);
+    rays[0].MaxDistance = 100.0f;
+    rays[1].Direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    rays[1].MaxDistance = 100.0f;
+    rays[2].Direction = glm::vec3(0.0f);
+    rays[2].MaxDistance = 100.0f;
+    scene->raycastBatch(rays, results);
+    ASSERT_EQ(results.Ranges.size(), 3);
+    ASSERT_EQ(results.Ranges[0].Count, 2);
+    EXPECT_NEAR(results.Hits[results.Ranges[0].First].Distance, 4.0f, 0.01f);
+    EXPECT_NEAR(results.Hits[results.Ranges[0].First + 1].Distance, 9.0f, 0.01f);
+    EXPECT_EQ(results.Ranges[1].Count, 0);
+
+    // A zero direction can't be normalized and never reaches the scene
+    EXPECT_EQ(results.Ranges[2].Count, 0);
+
+    // First hit of the swept sphere
+    std::vector<aderite::physics::SweepQuery> sweeps(1);
+    sweeps[0].MaxDistance = 100.0f;
+    scene->sweepBatch(sweeps, results);
+    ASSERT_EQ(results.Ranges[0].Count, 1);
+    EXPECT_NEAR(results.Hits[results.Ranges[0].First].Distance, 3.5f, 0.01f);
+
+    // Only the box the sphere is in
+    std::vector<aderite::physics::OverlapQuery> overlaps(1);
+    overlaps[0].Position = glm::vec3(0.0f, 0.0f, 5.0f);
+    scene->overlapBatch(overlaps, results);
+    EXPECT_EQ(results.Ranges[0].Count, 1);
+
+    // Line of sight checks of many agents
+    const size_t count = 10000;
+    rays.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        rays[i].From = glm::vec3(static_cast<float>(i % 100) * 0.2f - 10.0f, 0.0f, 0.0f);
+        rays[i].Direction = glm::vec3(0.0f, 0.0f, 1.0f);
+        rays[i].MaxDistance = 100.0f;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const aderite::physics::RaycastQuery& ray : rays) {
+        aderite::physics::RaycastResult hit;
+        scene->raycastSingle(hit, ray.From, ray.Direction, ray.MaxDistance);
+    }
+    const double singleMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    scene->raycastBatch(rays, results);
+    const double batchMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    LOG_INFO("[Test] {0} raycasts one at a time: {1} ms, batched: {2} ms", count, singleMs, batchMs);
+}
+
+/**
+ * @brief Pairs are culled by the layer matrix and masks, events are only requested for pairs with a listener
+ */
+TEST_F(SceneTest, PhysicsController_filterShader) {
+    using aderite::physics::Geometry;
+    using aderite::physics::PhysicsController;
+
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    aderite::Engine::getSceneManager()->setActive(scene);
+
+    aderite::physics::BoxGeometry* a = new aderite::physics::BoxGeometry();
+    aderite::physics::BoxGeometry* b = new aderite::physics::BoxGeometry();
+    b->setLayer(2);
+    EXPECT_EQ(b->getShape()->getQueryFilterData().word0, 1u << 2);
+
+    auto filter = [&](physx::PxFilterObjectAttributes attributes, physx::PxPairFlags& flags) {
+        return PhysicsController::filterShader(attributes, a->getShape()->getSimulationFilterData(), 0,
+                                               b->getShape()->getSimulationFilterData(), flags, scene->m_collisionMatrix.data(),
+                                               sizeof(scene->m_collisionMatrix));
+    };
+
+    // Contacts without events when nobody listens
+    physx::PxPairFlags flags;
+    EXPECT_EQ(filter(0, flags), physx::PxFilterFlag::eDEFAULT);
+    EXPECT_TRUE(flags & physx::PxPairFlag::eSOLVE_CONTACT);
+    EXPECT_FALSE(flags & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND);
+
+    a->setListeners(Geometry::c_ListenCollisions);
+    EXPECT_EQ(filter(0, flags), physx::PxFilterFlag::eDEFAULT);
+    EXPECT_TRUE(flags & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND);
+
+    // Trigger pairs exist only for trigger listeners
+    EXPECT_EQ(filter(physx::PxFilterObjectFlag::eTRIGGER, flags), physx::PxFilterFlag::eSUPPRESS);
+    b->setListeners(Geometry::c_ListenTriggers);
+    EXPECT_EQ(filter(physx::PxFilterObjectFlag::eTRIGGER, flags), physx::PxFilterFlag::eDEFAULT);
+
+    // Scene matrix
+    scene->setLayersCollide(0, 2, false);
+    EXPECT_FALSE(scene->doLayersCollide(2, 0));
+    EXPECT_TRUE(scene->doLayersCollide(0, 1));
+    EXPECT_EQ(filter(0, flags), physx::PxFilterFlag::eSUPPRESS);
+    scene->setLayersCollide(0, 2, true);
+    EXPECT_EQ(filter(0, flags), physx::PxFilterFlag::eDEFAULT);
+
+    // Either mask
+    b->setCollisionMask(~1u);
+    EXPECT_EQ(filter(0, flags), physx::PxFilterFlag::eSUPPRESS);
+
+    delete a;
+    delete b;
+}
+
+/**
+ * @brief Verifies that filter data changed during a step refilters the actor once the results are fetched
+ */
+TEST_F(SceneTest, PhysicsScene_deferredFiltering) {
+    using aderite::physics::PhysicsController;
+
+    aderite::scene::Scene* scene = new aderite::scene::Scene();
+    aderite::Engine::getSceneManager()->setActive(scene);
+
+    aderite::scene::GameObject* go = new aderite::scene::GameObject(scene, "Box");
+    go->addTransform();
+    aderite::physics::PhysXActor* actor = go->addActor();
+    aderite::physics::BoxGeometry* geometry = new aderite::physics::BoxGeometry();
+    actor->getData().addGeometry(geometry);
+    scene->m_gameObjects.emplace_back(go);
+
+    // Actors are created by the first update
+    const aderite::Engine::CurrentState state = aderite::Engine::get()->getState();
+    aderite::Engine::get()->setState(aderite::Engine::CurrentState::FULL);
+    scene->update(PhysicsController::c_FixedUpdateWindow);
+    aderite::Engine::get()->setState(state);
+    ASSERT_NE(geometry->getShape()->getActor(), nullptr);
+
+    // Queued once while simulating
+    scene->simulate(PhysicsController::c_FixedUpdateWindow);
+    geometry->setLayer(3);
+    geometry->setCollisionMask(~1u);
+    EXPECT_EQ(scene->m_pendingFiltering.size(), 1);
+    EXPECT_EQ(geometry->getShape()->getSimulationFilterData().word3, 3);
+
+    scene->fetchResults();
+    EXPECT_TRUE(scene->m_pendingFiltering.empty());
+
+    // Refiltered immediately otherwise
+    geometry->setLayer(4);
+    EXPECT_TRUE(scene->m_pendingFiltering.empty());
+}
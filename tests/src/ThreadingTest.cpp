@@ -0,0 +1,176 @@
+#include <aderite/Aderite.hpp>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define private public
+#define protected public
+
+#include <aderite/threading/Job.hpp>
+#include <aderite/threading/JobSystem.hpp>
+#include <aderite/threading/WorkStealingQueue.hpp>
+#include <aderite/utility/Log.hpp>
+
+#define private private
+#define protected protected
+
+class ThreadingTest : public ::testing::Test {
+public:
+    static void SetUpTestSuite() {
+        aderite::Engine::get()->init({});
+    }
+
+    static void TearDownTestSuite() {
+        aderite::Engine::get()->shutdown();
+    }
+};
+
+/**
+ * @brief Verify the job system init
+ */
+TEST_F(ThreadingTest, JobSystem_init) {
+    EXPECT_NE(aderite::Engine::getJobSystem(), nullptr);
+    EXPECT_GT(aderite::Engine::getJobSystem()->getWorkerCount(), 0);
+}
+
+/**
+ * @brief Verify the work stealing queue push, pop and steal order
+ */
+TEST_F(ThreadingTest, WorkStealingQueue_order) {
+    aderite::threading::WorkStealingQueue<int> queue(4);
+    int values[5] = {0, 1, 2, 3, 4};
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.push(&values[0]));
+    EXPECT_TRUE(queue.push(&values[1]));
+    EXPECT_TRUE(queue.push(&values[2]));
+    EXPECT_TRUE(queue.push(&values[3]));
+
+    // Full
+    EXPECT_FALSE(queue.push(&values[4]));
+
+    // Owner pops from the bottom, thieves steal from the top
+    EXPECT_EQ(queue.pop(), &values[3]);
+    EXPECT_EQ(queue.steal(), &values[0]);
+    EXPECT_EQ(queue.pop(), &values[2]);
+    EXPECT_EQ(queue.steal(), &values[1]);
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_EQ(queue.steal(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+/**
+ * @brief Verify that all scheduled jobs are executed
+ */
+TEST_F(ThreadingTest, JobSystem_schedule) {
+    aderite::threading::JobSystem* js = aderite::Engine::getJobSystem();
+    std::atomic<size_t> counter {0};
+
+    std::vector<aderite::threading::JobHandle> jobs;
+    for (size_t i = 0; i < 1000; i++) {
+        jobs.push_back(js->schedule([&counter]() {
+            counter++;
+        }));
+    }
+
+    for (auto& job : jobs) {
+        js->wait(job);
+        EXPECT_TRUE(job->isFinished());
+    }
+
+    EXPECT_EQ(counter.load(), 1000);
+}
+
+/**
+ * @brief Verify that a job doesn't start before its dependencies are finished
+ */
+TEST_F(ThreadingTest, JobSystem_dependencies) {
+    aderite::threading::JobSystem* js = aderite::Engine::getJobSystem();
+    std::atomic<size_t> counter {0};
+    size_t seenByDependent = 0;
+
+    aderite::threading::JobHandle dependent = js->create([&]() {
+        seenByDependent = counter.load();
+    });
+
+    std::vector<aderite::threading::JobHandle> dependencies;
+    for (size_t i = 0; i < 16; i++) {
+        aderite::threading::JobHandle dependency = js->create([&counter]() {
+            counter++;
+        });
+        js->addDependency(dependent, dependency);
+        dependencies.push_back(dependency);
+    }
+
+    js->submit(dependent);
+    EXPECT_FALSE(dependent->isFinished());
+
+    for (auto& dependency : dependencies) {
+        js->submit(dependency);
+    }
+
+    js->wait(dependent);
+    EXPECT_EQ(seenByDependent, 16);
+}
+
+/**
+ * @brief Verify that a priority limited wait doesn't pick up lower priority work
+ */
+TEST_F(ThreadingTest, JobSystem_waitPriority) {
+    using aderite::threading::Job;
+    aderite::threading::JobSystem js(1);
+    std::atomic<bool> blocked {false};
+    std::atomic<bool> release {false};
+
+    // Keep the only worker busy so that queued jobs can only run on the waiting thread
+    aderite::threading::JobHandle blocker = js.schedule([&]() {
+        blocked = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!blocked.load()) {
+        std::this_thread::yield();
+    }
+
+    aderite::threading::JobHandle load = js.schedule([]() {}, Job::Priority::HIGH);
+    aderite::threading::JobHandle critical = js.schedule([]() {}, Job::Priority::CRITICAL);
+
+    js.wait(critical, Job::Priority::CRITICAL);
+    EXPECT_TRUE(critical->isFinished());
+    EXPECT_FALSE(load->isFinished());
+
+    release = true;
+    js.wait(load);
+    js.wait(blocker);
+}
+
+/**
+ * @brief Enqueue/dequeue throughput at different worker counts
+ */
+TEST_F(ThreadingTest, JobSystem_throughput) {
+    constexpr size_t jobCount = 100000;
+    for (size_t workers : {1, 2, 8, 32}) {
+        aderite::threading::JobSystem js(workers);
+        std::atomic<size_t> counter {0};
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < jobCount; i++) {
+            js.schedule([&counter]() {
+                counter.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        while (counter.load() != jobCount) {
+            std::this_thread::yield();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        LOG_INFO("[Test] {0} workers: {1} jobs in {2} ms ({3} jobs/s)", workers, jobCount, seconds * 1000.0, jobCount / seconds);
+        EXPECT_EQ(counter.load(), jobCount);
+    }
+}